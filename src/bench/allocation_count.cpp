@@ -0,0 +1,76 @@
+/*!
+    \file allocation_count.cpp
+    \brief file to replace the global operator new so serial_bench can count allocations
+
+    The replacements live alone in this file so the compiler can't inline them
+    into the containers which use them, where it warns about the malloc and
+    free underneath as a mismatched allocation.
+*/
+#include "bench.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<uint64_t> gAllocations(0); //!< the heap allocations made by the process
+std::atomic<uint64_t> gAllocatedBytes(0); //!< the heap bytes allocated by the process
+
+void* countedAllocate(std::size_t size) {
+    gAllocations.fetch_add(1, std::memory_order_relaxed);
+    gAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+}
+}
+
+void* operator new(std::size_t size) {
+    void *p = countedAllocate(size);
+    if(!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return countedAllocate(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t&) noexcept {
+    std::free(p);
+}
+
+/*!
+    \brief Returns the heap allocations the process has made so far
+    \return the count of calls to operator new
+*/
+uint64_t allocationCount() {
+    return gAllocations.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief Returns the heap bytes the process has allocated so far
+    \return the sum of the sizes passed to operator new
+*/
+uint64_t allocatedBytes() {
+    return gAllocatedBytes.load(std::memory_order_relaxed);
+}
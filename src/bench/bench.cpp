@@ -0,0 +1,357 @@
+/*!
+    \file bench.cpp
+    \brief file to implement the microbenchmark harness used by serial_bench
+*/
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <ctime>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "byte_order.hpp"
+
+namespace {
+//! The iterations a benchmark is never calibrated beyond
+const uint64_t MaxIterations = 1000000000ULL;
+
+std::string escapeJson(const std::string &s) {
+    std::string escaped;
+    for(char c : s) {
+        if(c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if(static_cast<unsigned char>(c) < 0x20) {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", c);
+            escaped += code;
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+std::string formatBytesPerSecond(double bytesPerSecond) {
+    if(bytesPerSecond <= 0) {
+        return "-";
+    }
+    const char *units[] = {"B/s", "KB/s", "MB/s", "GB/s", "TB/s"};
+    int unit = 0;
+    while(bytesPerSecond >= 1000 && unit < 4) {
+        bytesPerSecond /= 1000;
+        unit++;
+    }
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << bytesPerSecond << ' ' << units[unit];
+    return out.str();
+}
+
+std::string currentTime() {
+    std::time_t now = std::time(nullptr);
+    char text[32];
+    std::strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+    return text;
+}
+
+BenchResult measure(const Benchmark &benchmark, const BenchOptions &options) {
+    // Grow the iterations until one run takes minTime, then repeat at that count
+    uint64_t iterations = 1;
+    BenchState best(0);
+    for(;;) {
+        BenchState state(iterations);
+        benchmark.body(state);
+        state.pauseTiming();
+        double seconds = state.seconds();
+        if(seconds >= options.minTime || iterations >= MaxIterations) {
+            best = state;
+            break;
+        }
+        double multiplier = seconds > 0 ? options.minTime * 1.4 / seconds : 100;
+        multiplier = std::min(100.0, std::max(2.0, multiplier));
+        iterations = std::min(MaxIterations, static_cast<uint64_t>(iterations * multiplier));
+    }
+
+    for(int i = 1; i < options.repetitions; ++i) {
+        BenchState state(iterations);
+        benchmark.body(state);
+        state.pauseTiming();
+        if(state.seconds() < best.seconds()) {
+            best = state;
+        }
+    }
+
+    BenchResult result;
+    result.name = benchmark.name;
+    result.baseline = benchmark.baseline;
+    result.iterations = iterations;
+    result.nsPerOp = best.seconds() * 1e9 / iterations;
+    result.bytesPerSecond = best.seconds() > 0
+        ? static_cast<double>(best.bytesPerOp()) * iterations / best.seconds() : 0;
+    result.allocationsPerOp = static_cast<double>(best.allocations()) / iterations;
+    result.allocatedBytesPerOp = static_cast<double>(best.allocatedBytes()) / iterations;
+    result.baselineRatio = 0;
+    result.counters = best.counters();
+    return result;
+}
+}
+
+/*!
+    \brief Constructs a state with the timer running
+    \param iterations the number of operations the body does
+*/
+BenchState::BenchState(uint64_t iterations) :
+    mIterations(iterations),
+    mRunning(false),
+    mElapsed(Clock::duration::zero()),
+    mStartAllocations(0),
+    mStartBytes(0),
+    mAllocations(0),
+    mAllocatedBytes(0),
+    mBytesPerOp(0){
+    resumeTiming();
+}
+
+uint64_t BenchState::iterations() const {
+    return mIterations;
+}
+
+/*!
+    \brief Stops the timer and the allocation count, does nothing if stopped
+*/
+void BenchState::pauseTiming() {
+    if(!mRunning) {
+        return;
+    }
+    Clock::time_point end = Clock::now();
+    mElapsed += end - mStart;
+    mAllocations += allocationCount() - mStartAllocations;
+    mAllocatedBytes += ::allocatedBytes() - mStartBytes;
+    mRunning = false;
+}
+
+/*!
+    \brief Restarts the timer and the allocation count, does nothing if running
+*/
+void BenchState::resumeTiming() {
+    if(mRunning) {
+        return;
+    }
+    mRunning = true;
+    mStartAllocations = allocationCount();
+    mStartBytes = ::allocatedBytes();
+    mStart = Clock::now();
+}
+
+/*!
+    \brief Returns the time measured so far, not counting a running timer
+    \return the measured seconds
+*/
+double BenchState::seconds() const {
+    return std::chrono::duration<double>(mElapsed).count();
+}
+
+uint64_t BenchState::allocations() const {
+    return mAllocations;
+}
+
+uint64_t BenchState::allocatedBytes() const {
+    return mAllocatedBytes;
+}
+
+uint64_t BenchState::bytesPerOp() const {
+    return mBytesPerOp;
+}
+
+/*!
+    \brief Sets the bytes each operation processes, used for the throughput
+    \param bytes the bytes per operation
+*/
+void BenchState::setBytesPerOp(uint64_t bytes) {
+    mBytesPerOp = bytes;
+}
+
+const std::vector<std::pair<std::string, double>>& BenchState::counters() const {
+    return mCounters;
+}
+
+/*!
+    \brief Records an extra result, such as a latency percentile
+    \param name the name of the counter, replaced if it was already set
+    \param value the value of the counter
+*/
+void BenchState::setCounter(const std::string &name, double value) {
+    for(auto &counter : mCounters) {
+        if(counter.first == name) {
+            counter.second = value;
+            return;
+        }
+    }
+    mCounters.emplace_back(name, value);
+}
+
+/*!
+    \brief Adds a benchmark
+    \param name the unique name of the benchmark
+    \param body the function doing the operations
+    \param baseline the name of the benchmark to compare against, if any
+*/
+void BenchRegistry::add(const std::string &name, const std::function<void(BenchState&)> &body,
+                        const std::string &baseline) {
+    Benchmark benchmark;
+    benchmark.name = name;
+    benchmark.baseline = baseline;
+    benchmark.body = body;
+    mBenchmarks.push_back(benchmark);
+}
+
+const std::vector<Benchmark>& BenchRegistry::benchmarks() const {
+    return mBenchmarks;
+}
+
+/*!
+    \brief Runs the benchmarks matching the filter
+
+    The baselines of the matching benchmarks run too, so every ratio can be
+    computed.
+
+    \param registry the benchmarks
+    \param options the filter and the time to spend
+    \param progress where the name of each benchmark is written as it starts
+    \return the results in the order the benchmarks were added
+*/
+std::vector<BenchResult> runBenchmarks(const BenchRegistry &registry,
+                                       const BenchOptions &options,
+                                       std::ostream &progress) {
+    std::set<std::string> selected;
+    for(const Benchmark &benchmark : registry.benchmarks()) {
+        if(benchmark.name.find(options.filter) != std::string::npos) {
+            selected.insert(benchmark.name);
+            if(!benchmark.baseline.empty()) {
+                selected.insert(benchmark.baseline);
+            }
+        }
+    }
+
+    std::vector<BenchResult> results;
+    for(const Benchmark &benchmark : registry.benchmarks()) {
+        if(selected.count(benchmark.name) == 0) {
+            continue;
+        }
+        progress << "running " << benchmark.name << std::endl;
+        results.push_back(measure(benchmark, options));
+    }
+
+    for(BenchResult &result : results) {
+        for(const BenchResult &baseline : results) {
+            if(!result.baseline.empty() && baseline.name == result.baseline && baseline.nsPerOp > 0) {
+                result.baselineRatio = result.nsPerOp / baseline.nsPerOp;
+            }
+        }
+    }
+    return results;
+}
+
+/*!
+    \brief Writes the results as an aligned table for reading
+    \param out the stream to write to
+    \param results the results to write
+*/
+void writeTable(std::ostream &out, const std::vector<BenchResult> &results) {
+    std::size_t width = 9;
+    for(const BenchResult &result : results) {
+        width = std::max(width, result.name.size());
+    }
+
+    out << std::left << std::setw(width) << "benchmark" << std::right
+        << std::setw(12) << "ns/op" << std::setw(14) << "bytes/s"
+        << std::setw(11) << "allocs/op" << std::setw(12) << "vs baseline" << "  counters\n";
+    out << std::string(width + 49, '-') << "\n";
+    for(const BenchResult &result : results) {
+        std::ostringstream ratio;
+        if(result.baselineRatio > 0) {
+            ratio << std::fixed << std::setprecision(2) << result.baselineRatio << "x";
+        } else {
+            ratio << "-";
+        }
+        out << std::left << std::setw(width) << result.name << std::right << std::fixed
+            << std::setw(12) << std::setprecision(2) << result.nsPerOp
+            << std::setw(14) << formatBytesPerSecond(result.bytesPerSecond)
+            << std::setw(11) << std::setprecision(3) << result.allocationsPerOp
+            << std::setw(12) << ratio.str() << " ";
+        for(const auto &counter : result.counters) {
+            out << " " << counter.first << "=" << std::setprecision(1) << counter.second;
+        }
+        out << "\n";
+    }
+}
+
+/*!
+    \brief Writes the results and the environment they were measured in as JSON
+    \param out the stream to write to
+    \param results the results to write
+*/
+void writeJson(std::ostream &out, const std::vector<BenchResult> &results) {
+    out << std::setprecision(6);
+    out << "{\n  \"context\": {\n";
+    out << "    \"date\": \"" << currentTime() << "\",\n";
+#if defined(__VERSION__)
+    out << "    \"compiler\": \"" << escapeJson(__VERSION__) << "\",\n";
+#endif
+#ifdef NDEBUG
+    out << "    \"assertions\": false,\n";
+#else
+    out << "    \"assertions\": true,\n";
+#endif
+    out << "    \"byte_order\": \"" << (SERIAL_HOST_BIG_ENDIAN ? "big" : "little") << "\",\n";
+    out << "    \"hardware_threads\": " << std::thread::hardware_concurrency() << "\n";
+    out << "  },\n  \"benchmarks\": [";
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &result = results[i];
+        out << (i ? ",\n" : "\n") << "    {\n";
+        out << "      \"name\": \"" << escapeJson(result.name) << "\",\n";
+        out << "      \"iterations\": " << result.iterations << ",\n";
+        out << "      \"ns_per_op\": " << result.nsPerOp << ",\n";
+        out << "      \"bytes_per_second\": " << result.bytesPerSecond << ",\n";
+        out << "      \"allocations_per_op\": " << result.allocationsPerOp << ",\n";
+        out << "      \"allocated_bytes_per_op\": " << result.allocatedBytesPerOp << ",\n";
+        if(!result.baseline.empty()) {
+            out << "      \"baseline\": \"" << escapeJson(result.baseline) << "\",\n";
+            out << "      \"baseline_ratio\": " << result.baselineRatio << ",\n";
+        }
+        out << "      \"counters\": {";
+        for(std::size_t j = 0; j < result.counters.size(); ++j) {
+            out << (j ? ", " : "") << "\"" << escapeJson(result.counters[j].first) << "\": "
+                << result.counters[j].second;
+        }
+        out << "}\n    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+/*!
+    \brief Writes the results as CSV with a header row
+
+    The counters go in the last column as name=value pairs separated by ';'.
+
+    \param out the stream to write to
+    \param results the results to write
+*/
+void writeCsv(std::ostream &out, const std::vector<BenchResult> &results) {
+    out << std::setprecision(6);
+    out << "name,iterations,ns_per_op,bytes_per_second,allocations_per_op,"
+           "allocated_bytes_per_op,baseline,baseline_ratio,counters\n";
+    for(const BenchResult &result : results) {
+        out << result.name << ',' << result.iterations << ',' << result.nsPerOp << ','
+            << result.bytesPerSecond << ',' << result.allocationsPerOp << ','
+            << result.allocatedBytesPerOp << ',' << result.baseline << ','
+            << result.baselineRatio << ',';
+        for(std::size_t j = 0; j < result.counters.size(); ++j) {
+            out << (j ? ";" : "") << result.counters[j].first << '=' << result.counters[j].second;
+        }
+        out << '\n';
+    }
+}
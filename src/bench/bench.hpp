@@ -0,0 +1,135 @@
+/*!
+    \file bench.hpp
+    \brief File to define the microbenchmark harness used by serial_bench
+*/
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+uint64_t allocationCount();
+uint64_t allocatedBytes();
+
+/*!
+    \brief Keeps the compiler from optimizing away the computation of value
+    \param value the result to keep
+*/
+template<typename T>
+inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    const volatile char *escape = reinterpret_cast<const volatile char*>(&value);
+    (void)*escape;
+#endif
+}
+
+/*!
+    \brief The state a benchmark body runs with
+
+    The body does iterations() operations. The harness starts the timer
+    before calling it and stops it after. Setup and teardown the body doesn't
+    want measured go between pauseTiming() and resumeTiming(), which also
+    leaves their allocations out of the count.
+*/
+class BenchState {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit BenchState(uint64_t iterations);
+
+    uint64_t iterations() const;
+
+    void pauseTiming();
+    void resumeTiming();
+
+    double seconds() const;
+    uint64_t allocations() const;
+    uint64_t allocatedBytes() const;
+
+    uint64_t bytesPerOp() const;
+    void setBytesPerOp(uint64_t bytes);
+
+    const std::vector<std::pair<std::string, double>>& counters() const;
+    void setCounter(const std::string &name, double value);
+
+private:
+    uint64_t mIterations; //!< the number of operations to do
+    bool mRunning; //!< true while the timer runs
+    Clock::time_point mStart; //!< when the timer last started
+    Clock::duration mElapsed; //!< the time measured in earlier runs of the timer
+    uint64_t mStartAllocations; //!< the allocation count when the timer last started
+    uint64_t mStartBytes; //!< the allocated bytes when the timer last started
+    uint64_t mAllocations; //!< the allocations made while timing
+    uint64_t mAllocatedBytes; //!< the bytes allocated while timing
+    uint64_t mBytesPerOp; //!< the bytes each operation processes, 0 if it isn't about bytes
+    std::vector<std::pair<std::string, double>> mCounters; //!< extra named results
+};
+
+/*!
+    \brief A benchmark and the baseline it is compared against
+*/
+struct Benchmark {
+    std::string name; //!< the unique name, groups are separated by '/'
+    std::string baseline; //!< the benchmark compared against, empty for none
+    std::function<void(BenchState&)> body; //!< does the operations
+};
+
+/*!
+    \brief The measurements of one benchmark
+*/
+struct BenchResult {
+    std::string name; //!< the name of the benchmark
+    std::string baseline; //!< the benchmark compared against, empty for none
+    uint64_t iterations; //!< the operations done in the fastest repetition
+    double nsPerOp; //!< nanoseconds per operation in the fastest repetition
+    double bytesPerSecond; //!< throughput, 0 if the benchmark isn't about bytes
+    double allocationsPerOp; //!< heap allocations per operation
+    double allocatedBytesPerOp; //!< heap bytes allocated per operation
+    double baselineRatio; //!< nsPerOp over the baseline's, 0 without a baseline
+    std::vector<std::pair<std::string, double>> counters; //!< extra named results
+};
+
+/*!
+    \brief Controls which benchmarks run and for how long
+*/
+struct BenchOptions {
+    std::string filter; //!< only benchmarks whose names contain this run
+    double minTime = 0.1; //!< the seconds each repetition runs for at least
+    int repetitions = 3; //!< the runs of each benchmark, the fastest is kept
+};
+
+/*!
+    \brief The set of benchmarks serial_bench knows about
+*/
+class BenchRegistry {
+public:
+    void add(const std::string &name, const std::function<void(BenchState&)> &body,
+             const std::string &baseline = std::string());
+
+    const std::vector<Benchmark>& benchmarks() const;
+
+private:
+    std::vector<Benchmark> mBenchmarks; //!< the benchmarks in the order they were added
+};
+
+std::vector<BenchResult> runBenchmarks(const BenchRegistry &registry,
+                                       const BenchOptions &options,
+                                       std::ostream &progress);
+
+void writeTable(std::ostream &out, const std::vector<BenchResult> &results);
+void writeJson(std::ostream &out, const std::vector<BenchResult> &results);
+void writeCsv(std::ostream &out, const std::vector<BenchResult> &results);
+
+void registerByteArrayBenchmarks(BenchRegistry &registry);
+void registerByteStreamBenchmarks(BenchRegistry &registry);
+void registerQueueBenchmarks(BenchRegistry &registry);
+
+#endif // BENCH_HPP
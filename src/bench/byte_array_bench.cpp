@@ -0,0 +1,216 @@
+/*!
+    \file byte_array_bench.cpp
+    \brief file to implement the memcpy baselines and the ByteArray benchmarks
+*/
+#include "bench.hpp"
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "byte_array.hpp"
+
+namespace {
+//! The bytes written before the destination of a benchmark starts over
+const std::size_t PassSize = 64 * 1024;
+
+std::string sizeName(const char *prefix, int size) {
+    return std::string(prefix) + "/" + std::to_string(size);
+}
+
+/*!
+    \brief Copies Size bytes to consecutive places in a buffer, which is what
+    the ByteStream write benchmarks do at best
+
+    The size is a constant, so small copies compile to plain moves like the
+    stream's own fixed width writes.
+*/
+template<int Size>
+void benchMemcpy(BenchState &state) {
+    state.pauseTiming();
+    std::vector<char> source(Size, 'x');
+    std::vector<char> destination(PassSize > Size ? PassSize : Size);
+    state.resumeTiming();
+
+    std::size_t offset = 0;
+    for(uint64_t i = 0; i < state.iterations(); ++i) {
+        if(offset + Size > destination.size()) {
+            offset = 0;
+        }
+        std::memcpy(destination.data() + offset, source.data(), Size);
+        offset += Size;
+        doNotOptimize(destination[0]);
+    }
+    state.setBytesPerOp(Size);
+}
+
+void registerMemcpy(BenchRegistry &registry) {
+    registry.add("memcpy/1", benchMemcpy<1>);
+    registry.add("memcpy/2", benchMemcpy<2>);
+    registry.add("memcpy/4", benchMemcpy<4>);
+    registry.add("memcpy/8", benchMemcpy<8>);
+    registry.add("memcpy/16", benchMemcpy<16>);
+    registry.add("memcpy/64", benchMemcpy<64>);
+    registry.add("memcpy/256", benchMemcpy<256>);
+    registry.add("memcpy/4096", benchMemcpy<4096>);
+    registry.add("memcpy/65536", benchMemcpy<65536>);
+}
+
+/*!
+    \brief Appends size bytes at a time with append, clearing the array when
+    it reaches PassSize so its capacity is reused
+*/
+template<typename Append>
+void benchAppend(BenchState &state, int size, Append append) {
+    state.pauseTiming();
+    ByteArray array;
+    array.reserve(static_cast<int>(PassSize) + size);
+    state.resumeTiming();
+
+    for(uint64_t i = 0; i < state.iterations(); ++i) {
+        if(array.size() + size > static_cast<int>(PassSize)) {
+            array.clear();
+        }
+        append(array);
+        doNotOptimize(array);
+    }
+    state.setBytesPerOp(size);
+}
+
+void registerAppend(BenchRegistry &registry) {
+    static const std::vector<char> source(64 * 1024, 'x');
+    static const std::string text(16, 'x');
+    static const ByteArray array16(source.data(), 16);
+    static const ByteArray array4096(source.data(), 4096);
+
+    for(int size : {16, 64, 256, 4096}) {
+        registry.add(sizeName("append/data", size), [size](BenchState &state) {
+            benchAppend(state, size, [size](ByteArray &array) {
+                array.append(source.data(), size);
+            });
+        }, sizeName("memcpy", size));
+    }
+
+    registry.add("append/cstring/16", [](BenchState &state) {
+        benchAppend(state, 16, [](ByteArray &array) {
+            array.append(text.c_str());
+        });
+    }, "memcpy/16");
+
+    registry.add("append/ByteArray/16", [](BenchState &state) {
+        benchAppend(state, 16, [](ByteArray &array) {
+            array.append(array16);
+        });
+    }, "memcpy/16");
+
+    registry.add("append/ByteArray/4096", [](BenchState &state) {
+        benchAppend(state, 4096, [](ByteArray &array) {
+            array.append(array4096);
+        });
+    }, "memcpy/4096");
+
+    for(int size : {16, 4096}) {
+        registry.add(sizeName("append/fill", size), [size](BenchState &state) {
+            benchAppend(state, size, [size](ByteArray &array) {
+                array.append(size, 'x');
+            });
+        });
+    }
+
+    // Starts from an empty array every PassSize bytes, so the growth is measured
+    registry.add("append/grow/16", [](BenchState &state) {
+        const int appendsPerPass = static_cast<int>(PassSize / 16);
+        uint64_t remaining = state.iterations();
+        while(remaining > 0) {
+            ByteArray array;
+            for(int i = 0; i < appendsPerPass && remaining > 0; ++i, --remaining) {
+                array.append(source.data(), 16);
+            }
+            doNotOptimize(array);
+        }
+        state.setBytesPerOp(16);
+    }, "memcpy/16");
+}
+
+void registerConstruction(BenchRegistry &registry) {
+    static const std::vector<char> source(64 * 1024, 'x');
+
+    registry.add("construct/default", [](BenchState &state) {
+        for(uint64_t i = 0; i < state.iterations(); ++i) {
+            ByteArray array;
+            doNotOptimize(array);
+        }
+    });
+
+    for(int size : {16, 256, 4096}) {
+        registry.add(sizeName("construct/data", size), [size](BenchState &state) {
+            for(uint64_t i = 0; i < state.iterations(); ++i) {
+                ByteArray array(source.data(), size);
+                doNotOptimize(array);
+            }
+            state.setBytesPerOp(size);
+        }, sizeName("memcpy", size));
+    }
+
+    registry.add("construct/fill/256", [](BenchState &state) {
+        for(uint64_t i = 0; i < state.iterations(); ++i) {
+            ByteArray array(256, 'x');
+            doNotOptimize(array);
+        }
+        state.setBytesPerOp(256);
+    });
+
+    for(int size : {16, 4096}) {
+        registry.add(sizeName("construct/copy", size), [size](BenchState &state) {
+            state.pauseTiming();
+            ByteArray original(source.data(), size);
+            state.resumeTiming();
+            for(uint64_t i = 0; i < state.iterations(); ++i) {
+                ByteArray copy(original);
+                doNotOptimize(copy);
+            }
+            state.setBytesPerOp(size);
+        }, sizeName("memcpy", size));
+    }
+
+    // Each operation moves the array out and back again
+    registry.add("construct/move/4096", [](BenchState &state) {
+        state.pauseTiming();
+        ByteArray array(source.data(), 4096);
+        state.resumeTiming();
+        for(uint64_t i = 0; i < state.iterations(); ++i) {
+            ByteArray moved(std::move(array));
+            doNotOptimize(moved);
+            array = std::move(moved);
+        }
+    });
+
+    registry.add("construct/vector/4096", [](BenchState &state) {
+        for(uint64_t i = 0; i < state.iterations(); ++i) {
+            ByteArray array(std::vector<char>(source.begin(), source.begin() + 4096));
+            doNotOptimize(array);
+        }
+        state.setBytesPerOp(4096);
+    });
+
+    registry.add("construct/unique_ptr/4096", [](BenchState &state) {
+        for(uint64_t i = 0; i < state.iterations(); ++i) {
+            std::unique_ptr<char[]> data(new char[4096]);
+            std::memcpy(data.get(), source.data(), 4096);
+            ByteArray array(std::move(data), 4096);
+            doNotOptimize(array);
+        }
+        state.setBytesPerOp(4096);
+    });
+}
+}
+
+/*!
+    \brief Adds the memcpy baselines and the ByteArray append and construction benchmarks
+    \param registry the registry to add to
+*/
+void registerByteArrayBenchmarks(BenchRegistry &registry) {
+    registerMemcpy(registry);
+    registerAppend(registry);
+    registerConstruction(registry);
+}
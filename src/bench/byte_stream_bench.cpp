@@ -0,0 +1,242 @@
+/*!
+    \file byte_stream_bench.cpp
+    \brief file to implement the ByteStream operator and raw data benchmarks
+*/
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "byte_array.hpp"
+#include "byte_stream.hpp"
+#include "byte_view.hpp"
+#include "io_device.hpp"
+
+namespace {
+//! The operations done before the stream starts over at the front of its array
+const int ValuesPerPass = 1024;
+
+//! The most bytes a pass of the raw data benchmarks writes
+const int PassSize = 64 * 1024;
+
+/*!
+    \brief The stream settings a benchmark runs with
+*/
+struct StreamConfig {
+    ByteStream::ByteOrder order; //!< the byte order of the stream
+    ByteStream::IntegerEncoding encoding; //!< how integers are encoded
+};
+
+const StreamConfig HostOrder = {ByteStream::hostByteOrder(), ByteStream::IntegerEncoding::Fixed};
+const StreamConfig SwappedOrder = {
+    ByteStream::hostByteOrder() == ByteStream::ByteOrder::BigEndian
+        ? ByteStream::ByteOrder::LittleEndian : ByteStream::ByteOrder::BigEndian,
+    ByteStream::IntegerEncoding::Fixed};
+const StreamConfig VarintEncoding = {ByteStream::hostByteOrder(), ByteStream::IntegerEncoding::Varint};
+
+void configure(ByteStream &stream, const StreamConfig &config) {
+    stream.setByteOrder(config.order);
+    stream.setIntegerEncoding(config.encoding);
+}
+
+template<typename T>
+void discard(T &value) {
+    doNotOptimize(value);
+}
+
+//! Strings read as const char* are allocated by the stream and owned by the caller
+void discard(const char *&value) {
+    doNotOptimize(value);
+    delete[] value;
+}
+
+/*!
+    \brief Does state.iterations() writes to a stream on a ByteArray, starting
+    over at the front of the array every perPass writes so its capacity is reused
+*/
+template<typename Write>
+void benchWrite(BenchState &state, const StreamConfig &config, int perPass, Write write) {
+    state.pauseTiming();
+    ByteArray array;
+    ByteStream stream(&array, ByteStream::OpenMode::Append);
+    configure(stream, config);
+    for(int i = 0; i < perPass; ++i) {
+        write(stream);
+    }
+    state.resumeTiming();
+
+    uint64_t bytes = 0;
+    uint64_t remaining = state.iterations();
+    while(remaining > 0) {
+        array.clear();
+        stream.setDevice(&array, ByteStream::OpenMode::Append);
+        const uint64_t count = std::min<uint64_t>(remaining, perPass);
+        for(uint64_t i = 0; i < count; ++i) {
+            write(stream);
+        }
+        doNotOptimize(array);
+        bytes += array.size();
+        remaining -= count;
+    }
+    state.setBytesPerOp(bytes / state.iterations());
+}
+
+/*!
+    \brief Does state.iterations() reads from a stream on a view of perPass
+    values written with write, starting over at the front of the view as needed
+*/
+template<typename Write, typename Read>
+void benchRead(BenchState &state, const StreamConfig &config, int perPass, Write write, Read read) {
+    state.pauseTiming();
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    configure(writer, config);
+    for(int i = 0; i < perPass; ++i) {
+        write(writer);
+    }
+    const ByteView view(array.constData(), array.size());
+    ByteStream stream(view);
+    configure(stream, config);
+    state.resumeTiming();
+
+    uint64_t remaining = state.iterations();
+    while(remaining > 0) {
+        stream.setDevice(view);
+        const uint64_t count = std::min<uint64_t>(remaining, perPass);
+        for(uint64_t i = 0; i < count; ++i) {
+            read(stream);
+        }
+        remaining -= count;
+    }
+    state.setBytesPerOp(view.size() / perPass);
+}
+
+/*!
+    \brief Adds write/name and read/name benchmarks using operator<< and operator>>
+*/
+template<typename T>
+void addOperator(BenchRegistry &registry, const std::string &name, T value,
+                 const StreamConfig &config, const std::string &baseline) {
+    auto write = [value](ByteStream &stream) {
+        T copy = value;
+        doNotOptimize(copy);
+        stream << copy;
+    };
+    auto read = [](ByteStream &stream) {
+        T result = T();
+        stream >> result;
+        discard(result);
+    };
+
+    registry.add("write/" + name, [config, write](BenchState &state) {
+        benchWrite(state, config, ValuesPerPass, write);
+    }, baseline);
+    registry.add("read/" + name, [config, write, read](BenchState &state) {
+        benchRead(state, config, ValuesPerPass, write, read);
+    }, baseline);
+}
+
+void registerOperators(BenchRegistry &registry) {
+    addOperator<uint8_t>(registry, "uint8", 0xa5, HostOrder, "memcpy/1");
+    addOperator<uint16_t>(registry, "uint16", 0xa5a5, HostOrder, "memcpy/2");
+    addOperator<uint32_t>(registry, "uint32", 0xa5a5a5a5, HostOrder, "memcpy/4");
+    addOperator<uint64_t>(registry, "uint64", 0xa5a5a5a5a5a5a5a5ULL, HostOrder, "memcpy/8");
+    addOperator<int8_t>(registry, "int8", -91, HostOrder, "memcpy/1");
+    addOperator<int16_t>(registry, "int16", -23131, HostOrder, "memcpy/2");
+    addOperator<int32_t>(registry, "int32", -1515870811, HostOrder, "memcpy/4");
+    addOperator<int64_t>(registry, "int64", -6510615555426900571LL, HostOrder, "memcpy/8");
+    addOperator<bool>(registry, "bool", true, HostOrder, "memcpy/1");
+    addOperator<float>(registry, "float", 3.14159f, HostOrder, "memcpy/4");
+    addOperator<double>(registry, "double", 2.718281828459045, HostOrder, "memcpy/8");
+
+    addOperator<uint16_t>(registry, "uint16/swapped", 0xa5a5, SwappedOrder, "memcpy/2");
+    addOperator<uint32_t>(registry, "uint32/swapped", 0xa5a5a5a5, SwappedOrder, "memcpy/4");
+    addOperator<uint64_t>(registry, "uint64/swapped", 0xa5a5a5a5a5a5a5a5ULL, SwappedOrder, "memcpy/8");
+    addOperator<double>(registry, "double/swapped", 2.718281828459045, SwappedOrder, "memcpy/8");
+
+    // Small values like lengths and ids are what varints are for
+    addOperator<uint32_t>(registry, "uint32/varint", 300, VarintEncoding, "memcpy/4");
+    addOperator<uint64_t>(registry, "uint64/varint", 300, VarintEncoding, "memcpy/8");
+    addOperator<int64_t>(registry, "int64/varint", -300, VarintEncoding, "memcpy/8");
+    addOperator<uint64_t>(registry, "uint64/varint_max", std::numeric_limits<uint64_t>::max(),
+                          VarintEncoding, "memcpy/8");
+
+    static const std::string text16(16, 'x');
+    static const std::string text256(256, 'x');
+    static const char literal16[] = "0123456789abcdef";
+
+    addOperator<std::string>(registry, "string/16", text16, HostOrder, "memcpy/16");
+    addOperator<std::string>(registry, "string/256", text256, HostOrder, "memcpy/256");
+    addOperator<const char*>(registry, "const_char*/16", text16.c_str(), HostOrder, "memcpy/16");
+    addOperator<ByteView>(registry, "ByteView/16", ByteView(text16.data(), 16), HostOrder,
+                          "memcpy/16");
+    addOperator<ByteView>(registry, "ByteView/256", ByteView(text256.data(), 256), HostOrder,
+                          "memcpy/256");
+
+    registry.add("write/char_array/16", [](BenchState &state) {
+        benchWrite(state, HostOrder, ValuesPerPass, [](ByteStream &stream) {
+            stream << literal16;
+        });
+    }, "memcpy/16");
+}
+
+void registerRawData(BenchRegistry &registry) {
+    static const std::vector<char> source(PassSize, 'x');
+
+    for(int size : {16, 256, 4096, 65536}) {
+        const std::string suffix = "/" + std::to_string(size);
+        const int perPass = std::max(1, PassSize / size);
+        auto write = [size](ByteStream &stream) {
+            stream.writeRawData(source.data(), size);
+        };
+
+        registry.add("writeRawData" + suffix, [perPass, write](BenchState &state) {
+            benchWrite(state, HostOrder, perPass, write);
+        }, "memcpy" + suffix);
+
+        registry.add("readRawData" + suffix, [size, perPass, write](BenchState &state) {
+            state.pauseTiming();
+            std::vector<char> destination(size);
+            state.resumeTiming();
+            benchRead(state, HostOrder, perPass, write, [size, &destination](ByteStream &stream) {
+                stream.readRawData(destination.data(), size);
+                doNotOptimize(destination[0]);
+            });
+        }, "memcpy" + suffix);
+    }
+}
+
+/*!
+    \brief Writes through the stream's buffer to a NullDevice, so the cost of
+    the device mode shows against the ByteArray mode
+*/
+void registerDevice(BenchRegistry &registry) {
+    registry.add("write/uint64/null_device", [](BenchState &state) {
+        state.pauseTiming();
+        NullDevice device;
+        ByteStream stream(&device, ByteStream::OpenMode::WriteOnly);
+        state.resumeTiming();
+        const uint64_t value = 0xa5a5a5a5a5a5a5a5ULL;
+        for(uint64_t i = 0; i < state.iterations(); ++i) {
+            uint64_t copy = value;
+            doNotOptimize(copy);
+            stream << copy;
+        }
+        stream.flush();
+        state.setBytesPerOp(sizeof(value));
+    }, "memcpy/8");
+}
+}
+
+/*!
+    \brief Adds the benchmarks of every ByteStream operator and of the raw data functions
+    \param registry the registry to add to
+*/
+void registerByteStreamBenchmarks(BenchRegistry &registry) {
+    registerOperators(registry);
+    registerRawData(registry);
+    registerDevice(registry);
+}
@@ -0,0 +1,105 @@
+/*!
+    \file main.cpp
+    \brief File to implement the main function of serial_bench
+*/
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+void printUsage(const char *program) {
+    std::cout << "usage: " << program << " [options]\n"
+              << "  --filter=TEXT      only run benchmarks whose names contain TEXT\n"
+              << "  --format=FORMAT    table, json or csv, table by default\n"
+              << "  --out=FILE         write the results to FILE rather than stdout\n"
+              << "  --min-time=SECONDS the time each repetition runs for at least, 0.1 by default\n"
+              << "  --repetitions=N    the runs of each benchmark, the fastest is kept, 3 by default\n"
+              << "  --list             list the benchmarks and exit\n"
+              << "Build with -DCMAKE_BUILD_TYPE=Release for meaningful numbers.\n";
+}
+
+bool readOption(const char *arg, const char *name, std::string &value) {
+    const std::size_t length = std::strlen(name);
+    if(std::strncmp(arg, name, length) != 0 || arg[length] != '=') {
+        return false;
+    }
+    value = arg + length + 1;
+    return true;
+}
+}
+
+/*!
+    \brief Runs the benchmarks and writes their results
+    \param argc the count of arguments, the size of argv
+    \param argv the command line options, see printUsage()
+    \return 0 on success, 1 for bad options or an unwritable output file
+ */
+int main(int argc, const char* argv[]) {
+    BenchOptions options;
+    std::string format = "table";
+    std::string outPath;
+    bool list = false;
+
+    for(int i = 1; i < argc; ++i) {
+        std::string value;
+        if(readOption(argv[i], "--filter", value)) {
+            options.filter = value;
+        } else if(readOption(argv[i], "--format", value)) {
+            format = value;
+        } else if(readOption(argv[i], "--out", value)) {
+            outPath = value;
+        } else if(readOption(argv[i], "--min-time", value)) {
+            options.minTime = std::atof(value.c_str());
+        } else if(readOption(argv[i], "--repetitions", value)) {
+            options.repetitions = std::max(1, std::atoi(value.c_str()));
+        } else if(std::strcmp(argv[i], "--list") == 0) {
+            list = true;
+        } else {
+            printUsage(argv[0]);
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+
+    if(format != "table" && format != "json" && format != "csv") {
+        std::cerr << "unknown format " << format << "\n";
+        return 1;
+    }
+
+    BenchRegistry registry;
+    registerByteArrayBenchmarks(registry);
+    registerByteStreamBenchmarks(registry);
+    registerQueueBenchmarks(registry);
+
+    if(list) {
+        for(const Benchmark &benchmark : registry.benchmarks()) {
+            std::cout << benchmark.name << "\n";
+        }
+        return 0;
+    }
+
+    std::ofstream file;
+    if(!outPath.empty()) {
+        file.open(outPath);
+        if(!file) {
+            std::cerr << "can't open " << outPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = outPath.empty() ? std::cout : file;
+
+    std::vector<BenchResult> results = runBenchmarks(registry, options, std::cerr);
+    if(format == "json") {
+        writeJson(out, results);
+    } else if(format == "csv") {
+        writeCsv(out, results);
+    } else {
+        writeTable(out, results);
+    }
+    return 0;
+}
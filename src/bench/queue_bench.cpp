@@ -0,0 +1,188 @@
+/*!
+    \file queue_bench.cpp
+    \brief file to implement the benchmarks of the lock free ByteArray queues
+    against a mutex guarded std::queue
+*/
+#include "bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include "byte_array.hpp"
+#include "byte_array_queue.hpp"
+
+namespace {
+//! The capacity of every queue, so they all apply the same back pressure
+const std::size_t QueueCapacity = 1024;
+
+//! The most latencies recorded in a run, the others are skipped evenly
+const uint64_t MaxLatencySamples = 1 << 20;
+
+//! The arrays the batch consumer pops at once
+const std::size_t BatchSize = 64;
+
+/*!
+    \brief Bounded queue guarded by a mutex, the baseline the lock free queues
+    are compared against
+*/
+class MutexByteArrayQueue {
+public:
+    explicit MutexByteArrayQueue(std::size_t capacity) :
+        mCapacity(capacity){
+    }
+
+    bool tryPush(ByteArray &&array) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(mQueue.size() >= mCapacity) {
+            return false;
+        }
+        mQueue.push(std::move(array));
+        return true;
+    }
+
+    bool tryPop(ByteArray &array) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if(mQueue.empty()) {
+            return false;
+        }
+        array = std::move(mQueue.front());
+        mQueue.pop();
+        return true;
+    }
+
+    std::size_t popBatch(ByteArray *arrays, std::size_t maxCount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::size_t count = 0;
+        while(count < maxCount && !mQueue.empty()) {
+            arrays[count++] = std::move(mQueue.front());
+            mQueue.pop();
+        }
+        return count;
+    }
+
+private:
+    std::size_t mCapacity; //!< the most arrays the queue holds
+    std::mutex mMutex; //!< guards mQueue
+    std::queue<ByteArray> mQueue; //!< the arrays in the order they were pushed
+};
+
+int64_t now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        BenchState::Clock::now().time_since_epoch()).count();
+}
+
+/*!
+    \brief Records the latency of an array stamped by a producer
+*/
+void recordLatency(const ByteArray &array, std::vector<int64_t> &latencies) {
+    int64_t sent;
+    std::memcpy(&sent, array.begin(), sizeof(sent));
+    latencies.push_back(now() - sent);
+}
+
+/*!
+    \brief Moves state.iterations() arrays from the producers to this thread
+
+    Each array holds the time it was pushed, so the consumer measures how long
+    it waited in the queue. A full or empty queue is retried after yielding,
+    which keeps the benchmark fair on machines with fewer cores than threads.
+*/
+template<typename Queue>
+void benchQueue(BenchState &state, int producers, bool batch) {
+    state.pauseTiming();
+    Queue queue(QueueCapacity);
+    const uint64_t total = state.iterations();
+    const uint64_t stride = std::max<uint64_t>(1, total / MaxLatencySamples);
+    std::vector<int64_t> latencies;
+    latencies.reserve(total / stride + BatchSize);
+    std::vector<ByteArray> arrays(BatchSize);
+
+    std::atomic<bool> start(false);
+    std::vector<std::thread> threads;
+    for(int p = 0; p < producers; ++p) {
+        const uint64_t count = total / producers + (static_cast<uint64_t>(p) < total % producers);
+        threads.emplace_back([&queue, &start, count]() {
+            while(!start.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            for(uint64_t i = 0; i < count; ++i) {
+                const int64_t sent = now();
+                ByteArray array(reinterpret_cast<const char*>(&sent), sizeof(sent));
+                while(!queue.tryPush(std::move(array))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    state.resumeTiming();
+
+    start.store(true, std::memory_order_release);
+    uint64_t received = 0;
+    while(received < total) {
+        std::size_t count = batch ? queue.popBatch(arrays.data(), BatchSize)
+                                  : queue.tryPop(arrays[0]);
+        if(count == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        for(std::size_t i = 0; i < count; ++i, ++received) {
+            if(received % stride == 0) {
+                recordLatency(arrays[i], latencies);
+            }
+        }
+    }
+
+    state.pauseTiming();
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        return static_cast<double>(latencies[static_cast<std::size_t>(p * (latencies.size() - 1))]);
+    };
+    state.setCounter("p50_ns", percentile(0.5));
+    state.setCounter("p99_ns", percentile(0.99));
+    state.setCounter("p999_ns", percentile(0.999));
+    state.setCounter("max_ns", static_cast<double>(latencies.back()));
+}
+}
+
+/*!
+    \brief Adds the throughput and latency benchmarks of SpscByteArrayQueue and
+    MpscByteArrayQueue, each compared to a mutex guarded std::queue
+    \param registry the registry to add to
+*/
+void registerQueueBenchmarks(BenchRegistry &registry) {
+    registry.add("queue/mutex/1p1c", [](BenchState &state) {
+        benchQueue<MutexByteArrayQueue>(state, 1, false);
+    });
+    registry.add("queue/mutex/4p1c", [](BenchState &state) {
+        benchQueue<MutexByteArrayQueue>(state, 4, false);
+    });
+    registry.add("queue/mutex_batch/1p1c", [](BenchState &state) {
+        benchQueue<MutexByteArrayQueue>(state, 1, true);
+    });
+
+    registry.add("queue/spsc/1p1c", [](BenchState &state) {
+        benchQueue<SpscByteArrayQueue>(state, 1, false);
+    }, "queue/mutex/1p1c");
+    registry.add("queue/spsc_batch/1p1c", [](BenchState &state) {
+        benchQueue<SpscByteArrayQueue>(state, 1, true);
+    }, "queue/mutex_batch/1p1c");
+
+    registry.add("queue/mpsc/1p1c", [](BenchState &state) {
+        benchQueue<MpscByteArrayQueue>(state, 1, false);
+    }, "queue/mutex/1p1c");
+    registry.add("queue/mpsc/4p1c", [](BenchState &state) {
+        benchQueue<MpscByteArrayQueue>(state, 4, false);
+    }, "queue/mutex/4p1c");
+    registry.add("queue/mpsc_batch/4p1c", [](BenchState &state) {
+        benchQueue<MpscByteArrayQueue>(state, 4, true);
+    }, "queue/mutex/4p1c");
+}
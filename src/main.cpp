@@ -26,15 +26,15 @@ std::string getUserInput() {
     \return an exit code for the application
  */
 int main(int argc, const char* argv[]) {
-    ByteArray ba(60, 0);
-    std::cout << "Size: " << ba.size() << std::endl;
-    ByteStream s(&ba, ByteStream::OpenMode::ReadWrite);
+    ByteArray ba;
+    ByteStream writeStream(&ba, ByteStream::OpenMode::Append);
     uint8_t value(16);
     std::cout << "Value: " << static_cast<short>(value) << std::endl;
-    ByteStream readStream(&ba, ByteStream::OpenMode::ReadWrite);
-    readStream << value;
+    writeStream << value;
+    std::cout << "Size: " << ba.size() << std::endl;
+    ByteStream readStream(&ba, ByteStream::OpenMode::ReadOnly);
     uint8_t second = 0;
-    s >> second;
+    readStream >> second;
     std::cout << static_cast<short>(second) << std::endl;
 
     return 0;
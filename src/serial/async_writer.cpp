@@ -0,0 +1,265 @@
+/*!
+    \file async_writer.cpp
+    \brief file to implement the AsyncWriteDevice class
+*/
+#include "async_writer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/*!
+    \brief Constructs the device and starts its writer thread
+    \param device the device to write to, which must outlive this one
+    \param bufferCount the number of buffers, at least 2
+    \param bufferSize the size of each buffer, at most INT_MAX, the most a
+    ByteArray holds
+*/
+AsyncWriteDevice::AsyncWriteDevice(IODevice *device, std::size_t bufferCount, std::size_t bufferSize) :
+mDevice(device),
+mBufferSize(std::min<std::size_t>(std::max<std::size_t>(bufferSize, 1),
+                                  static_cast<std::size_t>(std::numeric_limits<int>::max()))),
+mHaveCurrent(true),
+mClosed(false),
+mStopping(false),
+mFailed(false),
+mStalls(0){
+    mCurrent.reserve(static_cast<int>(mBufferSize));
+    for(std::size_t i = 1; i < std::max<std::size_t>(bufferCount, 2); i++) {
+        mFree.push_back(ByteArray());
+        mFree.back().reserve(static_cast<int>(mBufferSize));
+    }
+    mThread = std::thread(&AsyncWriteDevice::work, this);
+}
+
+/*!
+    \brief Closes the device if it isn't closed, waiting for the data to be
+    written, and stops the writer thread
+*/
+AsyncWriteDevice::~AsyncWriteDevice() {
+    if(!mClosed) {
+        close().wait();
+    }
+    mThread.join();
+}
+
+/*!
+    \brief Always fails, the device is write only
+    \return -1
+*/
+int64_t AsyncWriteDevice::read(char*, uint64_t) {
+    return -1;
+}
+
+/*!
+    \brief Copies data into the buffers, handing each one off as it fills
+
+    Only waits if every buffer is waiting to be written.
+
+    \param data the bytes to write
+    \param size the number of bytes
+    \return size, or -1 if the device is closed or a write has failed
+*/
+int64_t AsyncWriteDevice::write(const char *data, uint64_t size) {
+    if(mClosed || mFailed.load(std::memory_order_relaxed)) {
+        return -1;
+    }
+
+    uint64_t written = 0;
+    while(written < size) {
+        if(!mHaveCurrent && !takeFreeBuffer()) {
+            return -1;
+        }
+
+        const std::size_t space = mBufferSize - static_cast<std::size_t>(mCurrent.size());
+        const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(space, size - written));
+        std::memcpy(mCurrent.extend(static_cast<int>(count)), data + written, count);
+        written += count;
+
+        if(static_cast<std::size_t>(mCurrent.size()) == mBufferSize) {
+            Job job;
+            job.buffer = std::move(mCurrent);
+            submit(std::move(job));
+            mHaveCurrent = false;
+        }
+    }
+    return static_cast<int64_t>(written);
+}
+
+/*!
+    \brief Writes everything written so far to the device, flushes it, and
+    waits for that to finish
+    \return true if the data was written, otherwise false
+*/
+bool AsyncWriteDevice::flush() {
+    return flushAsync().get();
+}
+
+/*!
+    \brief Hands the partly filled buffer to the writer thread, and asks it to
+    flush the device once everything before is written
+
+    The producer can carry on writing at once.
+
+    \return a future which is true once the data is written and flushed, false
+    if a write failed or the device is closed
+*/
+std::future<bool> AsyncWriteDevice::flushAsync() {
+    std::shared_ptr<std::promise<bool>> done = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = done->get_future();
+    if(mClosed) {
+        done->set_value(false);
+        return future;
+    }
+
+    Job job;
+    if(mHaveCurrent && !mCurrent.empty()) {
+        job.buffer = std::move(mCurrent);
+        mHaveCurrent = false;
+    }
+    job.done = done;
+    submit(std::move(job));
+    return future;
+}
+
+/*!
+    \brief Flushes the device like flushAsync(), after which writes fail and
+    the writer thread exits
+    \return a future which is true once everything written is on the device
+*/
+std::future<bool> AsyncWriteDevice::close() {
+    if(mClosed) {
+        std::promise<bool> closed;
+        closed.set_value(!mFailed.load());
+        return closed.get_future();
+    }
+
+    std::future<bool> future = flushAsync();
+    mClosed = true;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWorkReady.notify_one();
+    return future;
+}
+
+/*!
+    \brief Returns true once close() has been called
+*/
+bool AsyncWriteDevice::isClosed() const {
+    return mClosed;
+}
+
+/*!
+    \brief Returns true once a write to the device has failed
+*/
+bool AsyncWriteDevice::hasFailed() const {
+    return mFailed.load();
+}
+
+/*!
+    \brief Returns the number of times a write waited because every buffer
+    was in flight, a sign the device can't keep up or buffers are too few
+*/
+uint64_t AsyncWriteDevice::stallCount() const {
+    return mStalls.load(std::memory_order_relaxed);
+}
+
+/*!
+    \brief Queues job for the writer thread
+    \param job the buffer or flush request
+*/
+void AsyncWriteDevice::submit(AsyncWriteDevice::Job &&job) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mJobs.push_back(std::move(job));
+    }
+    mWorkReady.notify_one();
+}
+
+/*!
+    \brief Makes a free buffer current, waiting for one if necessary
+    \return false if the writer failed while waiting
+*/
+bool AsyncWriteDevice::takeFreeBuffer() {
+    std::unique_lock<std::mutex> lock(mMutex);
+    if(mFree.empty()) {
+        mStalls.fetch_add(1, std::memory_order_relaxed);
+        mBufferFreed.wait(lock, [this]() {
+            return !mFree.empty() || mFailed.load(std::memory_order_relaxed);
+        });
+        if(mFree.empty()) {
+            return false;
+        }
+    }
+    mCurrent = std::move(mFree.back());
+    mFree.pop_back();
+    mHaveCurrent = true;
+    return true;
+}
+
+/*!
+    \brief The loop of the writer thread
+
+    Takes every job queued at once, writes their buffers in one call, flushes
+    the device if any job asked to, then recycles the buffers and completes the
+    futures.
+*/
+void AsyncWriteDevice::work() {
+    std::vector<Job> jobs;
+    std::vector<ByteView> parts;
+    while(true) {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkReady.wait(lock, [this]() { return mStopping || !mJobs.empty(); });
+            if(mJobs.empty()) {
+                return;
+            }
+            while(!mJobs.empty()) {
+                jobs.push_back(std::move(mJobs.front()));
+                mJobs.pop_front();
+            }
+        }
+
+        parts.clear();
+        bool flushRequested = false;
+        uint64_t size = 0;
+        for(Job& job : jobs) {
+            if(!job.buffer.empty()) {
+                parts.push_back(ByteView(job.buffer));
+                size += static_cast<uint64_t>(job.buffer.size());
+            }
+            flushRequested = flushRequested || job.done;
+        }
+
+        bool ok = !mFailed.load();
+        if(ok && !parts.empty()) {
+            ok = mDevice->writeVectored(parts.data(), parts.size()) == static_cast<int64_t>(size);
+        }
+        if(ok && flushRequested) {
+            ok = mDevice->flush();
+        }
+        if(!ok) {
+            mFailed.store(true);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for(Job& job : jobs) {
+                // Only the producer's buffers hold data, a bare flush has none
+                if(!job.buffer.empty()) {
+                    job.buffer.clear();
+                    mFree.push_back(std::move(job.buffer));
+                }
+            }
+        }
+        mBufferFreed.notify_one();
+        for(Job& job : jobs) {
+            if(job.done) {
+                job.done->set_value(ok);
+            }
+        }
+        jobs.clear();
+    }
+}
@@ -0,0 +1,97 @@
+/*!
+    \file async_writer.hpp
+    \brief File to define the AsyncWriteDevice class
+*/
+
+#ifndef ASYNC_WRITER_HPP
+#define ASYNC_WRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "byte_array.hpp"
+#include "io_device.hpp"
+
+/*!
+    \brief Device which writes to another device on a background thread
+
+    Writes are copied into one of bufferCount buffers. When a buffer fills it
+    is handed to a writer thread and the producer carries on in the next free
+    buffer, so the producer only waits on the device when every buffer is in
+    flight. The writer thread gives the device every buffer waiting for it in
+    a single writeVectored() call.
+
+    \code
+    FileDevice file("events.log", FileDevice::Mode::Append);
+    AsyncWriteDevice writer(&file);
+    ByteStream stream(&writer, ByteStream::OpenMode::WriteOnly);
+    ...
+    std::future<bool> written = writer.flushAsync();
+    \endcode
+
+    Only one thread may write, flush or close at a time. After a write to the
+    device fails every later write fails, and every pending future is false.
+*/
+class AsyncWriteDevice : public IODevice {
+public:
+    //! The size of each buffer if none is given
+    static const std::size_t DefaultBufferSize = 1024 * 1024;
+
+    explicit AsyncWriteDevice(IODevice *device, std::size_t bufferCount = 2,
+                              std::size_t bufferSize = DefaultBufferSize);
+    ~AsyncWriteDevice() override;
+
+    AsyncWriteDevice(const AsyncWriteDevice &other) = delete;
+    AsyncWriteDevice& operator=(const AsyncWriteDevice &other) = delete;
+
+    int64_t read(char *data, uint64_t maxSize) override;
+    int64_t write(const char *data, uint64_t size) override;
+    bool flush() override;
+
+    std::future<bool> flushAsync();
+    std::future<bool> close();
+
+    bool isClosed() const;
+    bool hasFailed() const;
+    uint64_t stallCount() const;
+
+private:
+    /*!
+        \brief A full buffer to write, or a request to flush the device once
+        everything before it is written
+    */
+    struct Job {
+        ByteArray buffer;
+        std::shared_ptr<std::promise<bool>> done;
+    };
+
+    void submit(Job &&job);
+    bool takeFreeBuffer();
+    void work();
+
+    IODevice *mDevice; //!< the device written to by the writer thread
+    std::size_t mBufferSize; //!< the size buffers are handed off at
+    ByteArray mCurrent; //!< the buffer the producer is filling
+    bool mHaveCurrent; //!< false while every buffer is in flight
+    bool mClosed; //!< true once close() has been called
+
+    std::mutex mMutex; //!< guards mJobs, mFree and mStopping
+    std::condition_variable mWorkReady; //!< wakes the writer thread
+    std::condition_variable mBufferFreed; //!< wakes a producer out of buffers
+    std::deque<Job> mJobs; //!< the work handed to the writer thread
+    std::vector<ByteArray> mFree; //!< the buffers written and ready for reuse
+    bool mStopping; //!< true once the writer thread should exit
+    std::atomic<bool> mFailed; //!< true once a write to mDevice failed
+    std::atomic<uint64_t> mStalls; //!< the times the producer waited for a buffer
+    std::thread mThread; //!< the writer thread
+};
+
+#endif // ASYNC_WRITER_HPP
@@ -0,0 +1,10 @@
+/*!
+    \file byte_allocator.cpp
+    \brief file to implement the ByteAllocator interface
+*/
+#include "byte_allocator.hpp"
+
+/*!
+    \brief Default destructor for the ByteAllocator interface
+*/
+ByteAllocator::~ByteAllocator() = default;
@@ -0,0 +1,37 @@
+/*!
+    \file byte_allocator.hpp
+    \brief File to define the ByteAllocator interface
+*/
+
+#ifndef BYTE_ALLOCATOR_HPP
+#define BYTE_ALLOCATOR_HPP
+
+#include <cstddef>
+
+/*!
+    \brief Interface for the memory a ByteArray stores its data in
+
+    A ByteArray given an allocator gets all of the storage it allocates
+    itself from it, instead of from new[]. Buffers adopted by the array are
+    still freed the way they were allocated.
+*/
+class ByteAllocator {
+public:
+    virtual ~ByteAllocator();
+
+    /*!
+        \brief Allocates a buffer of at least size bytes
+        \param size the number of bytes wanted, set to the number usable
+        \return the buffer, which must be given back to deallocate()
+    */
+    virtual char* allocate(std::size_t &size) = 0;
+
+    /*!
+        \brief Frees a buffer returned by allocate()
+        \param data the buffer to free
+        \param size the usable size allocate() returned for it
+    */
+    virtual void deallocate(char *data, std::size_t size) = 0;
+};
+
+#endif // BYTE_ALLOCATOR_HPP
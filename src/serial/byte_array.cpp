@@ -2,31 +2,53 @@
     \brief file to implement the ByteArray class
 */
 #include "byte_array.hpp"
+#include "byte_allocator.hpp"
+#include "instrumentation.hpp"
+#include <algorithm>
 #include <cstring>
+#include <functional>
+#include <limits>
 
 
 /*!
     \brief Default constructor for the ByteArray
 
-    Generates an empty ByteArray
+    Generates an empty ByteArray, which uses its inline storage
 */
 ByteArray::ByteArray()
-: mData(std::vector<char>()){
+: mData(mInline),
+  mSize(0),
+  mCapacity(InlineCapacity),
+  mAllocator(nullptr),
+  mAllocation(nullptr){
     setExtents();
 }
 
+/*!
+    \brief Creates an empty ByteArray which allocates its storage from allocator
+
+    The allocator must outlive the array.
+
+    \param allocator the allocator to use, nullptr to use new[]
+*/
+ByteArray::ByteArray(ByteAllocator* allocator)
+: ByteArray(){
+    mAllocator = allocator;
+}
+
 /*!
     \brief Creates a ByteArray from the data at *data, and reads in size bytes
 
     The ByteArray will not take ownership of the data at *data, it will make
-    a copy of that data.
+    a copy of that data. If size is negative, data is treated as a null
+    terminated string.
 
     \param data the pointer to the data
     \param size the amount of data to copy
 */
 ByteArray::ByteArray(const char* data, int size)
-: mData(std::vector<char>(data, data+size)){
-    setExtents();
+: ByteArray(){
+    append(data, size < 0 ? static_cast<int>(strlen(data)) : size);
 }
 
 /*!
@@ -35,25 +57,177 @@ ByteArray::ByteArray(const char* data, int size)
     \param ch the default value to set
 */
 ByteArray::ByteArray(int size, char ch)
-: mData(std::vector<char>(static_cast<unsigned long>(size), ch)){
-    setExtents();
+: ByteArray(){
+    append(size, ch);
+}
+
+/*!
+    \brief Creates a ByteArray which takes ownership of data without copying it
+    \param data the buffer to adopt, allocated with new[]
+    \param size the number of bytes in the buffer
+*/
+ByteArray::ByteArray(std::unique_ptr<char[]> data, int size)
+: ByteArray(){
+    adopt(std::move(data), size);
+}
+
+/*!
+    \brief Creates a ByteArray which takes ownership of the storage of data
+    \param data the vector to adopt
+*/
+ByteArray::ByteArray(std::vector<char>&& data)
+: ByteArray(){
+    adopt(std::move(data));
 }
 
 /*!
     \brief Copy constructor for the ByteArray
+
+    The copy allocates with new[], whichever allocator other uses.
+
     \param other the ByteArray to copy
 */
 ByteArray::ByteArray(const ByteArray& other)
-: mData(other.mData){
+: ByteArray(){
+    append(other);
+}
+
+/*!
+    \brief Move constructor for the ByteArray
+
+    Takes the storage of other without copying it, and leaves other empty.
+
+    \param other the ByteArray to move from
+*/
+ByteArray::ByteArray(ByteArray&& other) noexcept
+: ByteArray(){
+    *this = std::move(other);
+}
+
+/*!
+    \brief Copy assignment operator for the ByteArray
+    \param other the ByteArray to copy
+    \return a reference to this array
+*/
+ByteArray& ByteArray::operator=(const ByteArray& other) {
+    if(this != &other) {
+        clear();
+        append(other);
+    }
+    return *this;
+}
+
+/*!
+    \brief Move assignment operator for the ByteArray
+
+    Takes the storage and allocator of other without copying the data, and
+    leaves other empty. Data held inline is copied, as it lives in other.
+
+    \param other the ByteArray to move from
+    \return a reference to this array
+*/
+ByteArray& ByteArray::operator=(ByteArray&& other) noexcept {
+    if(this != &other) {
+        reset();
+        mSize = other.mSize;
+        mAllocator = other.mAllocator;
+        if(other.mData == other.mInline) {
+            std::copy(other.mInline, other.mInline + other.mSize, mInline);
+        } else {
+            mData = other.mData;
+            mCapacity = other.mCapacity;
+            mBuffer = std::move(other.mBuffer);
+            // Moving a vector keeps its storage, so mData stays valid
+            mVector = std::move(other.mVector);
+            mAllocation = other.mAllocation;
+            other.mAllocation = nullptr;
+        }
+        setExtents();
+
+        other.reset();
+    }
+    return *this;
+}
+
+/*!
+    \brief Replaces the contents of the array with data without copying it
+    \param data the buffer to adopt, allocated with new[]
+    \param size the number of bytes in the buffer
+*/
+void ByteArray::adopt(std::unique_ptr<char[]> data, int size) {
+    reset();
+    if(data) {
+        mBuffer = std::move(data);
+        mData = mBuffer.get();
+        mSize = size;
+        mCapacity = size;
+    }
     setExtents();
 }
 
+/*!
+    \brief Replaces the contents of the array with the storage of data
+    \param data the vector to adopt
+*/
+void ByteArray::adopt(std::vector<char>&& data) {
+    reset();
+    if(data.capacity() == 0) {
+        return;
+    }
+
+    mVector = std::move(data);
+    mSize = static_cast<int>(mVector.size());
+    // Make the spare capacity part of the vector, so appends may use it
+    mVector.resize(mVector.capacity());
+    mData = mVector.data();
+    mCapacity = static_cast<int>(mVector.size());
+    setExtents();
+}
+
+/*!
+    \brief Hands the storage of the array to the caller and leaves it empty
+
+    The buffer is handed out without copying, unless the data is inline, was
+    adopted from a std::vector or came from a ByteAllocator, in which case the
+    data is copied into a new buffer. Call size() first, the returned buffer
+    holds that many bytes.
+
+    \return the storage of the array, nullptr if the array is empty
+*/
+std::unique_ptr<char[]> ByteArray::release() {
+    if(mData && mData != mBuffer.get()) {
+        std::unique_ptr<char[]> buffer(mSize > 0 ? new char[mSize] : nullptr);
+        std::copy(mData, mData + mSize, buffer.get());
+        reset();
+        return buffer;
+    }
+
+    std::unique_ptr<char[]> buffer = std::move(mBuffer);
+    reset();
+    return buffer;
+}
+
+/*!
+    \brief Returns the allocator of the array
+    \return the allocator, nullptr if the array allocates with new[]
+*/
+ByteAllocator* ByteArray::allocator() const {
+    return mAllocator;
+}
+
 /*!
     \brief Appends a ByteArray to this byte array
     \param array the array to append to this one
 */
 void ByteArray::append(const ByteArray& array) {
-    mData.insert(mData.end(), array.mData.begin(), array.mData.end());
+    const int count = array.mSize;
+    if(!reserveForAppend(count)) {
+        return;
+    }
+    detail::addCounter(detail::ArrayBytesCopiedCounter, static_cast<uint64_t>(count));
+    // Read array.mData after reserving, in case it is this array
+    std::copy(array.mData, array.mData + count, mData + mSize);
+    mSize += count;
     setExtents();
 }
 
@@ -63,9 +237,11 @@ void ByteArray::append(const ByteArray& array) {
     \param ch the value to append
 */
 void ByteArray::append(int count, char ch) {
-    for(int i = 0; i < count; i++) {
-        mData.push_back(ch);
+    if(!reserveForAppend(count)) {
+        return;
     }
+    std::fill(mData + mSize, mData + mSize + count, ch);
+    mSize += count;
     setExtents();
 }
 
@@ -74,27 +250,65 @@ void ByteArray::append(int count, char ch) {
     \param data
 */
 void ByteArray::append(const char* data) {
-    mData.insert(mData.end(), data, data + strlen(data));
-    setExtents();
+    append(data, static_cast<int>(strlen(data)));
 }
 
 /*!
     \brief Appends the size data at char to the ByteArray
+
+    data may point into this array.
+
     \param data the data to be appended
     \param size the size of the data to append
 */
 void ByteArray::append(const char* data, int size) {
-    mData.insert(mData.end(), data, data + size);
+    if(size <= 0) {
+        return;
+    }
+
+    // Data from this array moves if reserving reallocates, so find it again
+    const std::less<const char*> before;
+    const bool inArray = !before(data, mData) && before(data, mData + mSize);
+    const std::ptrdiff_t offset = data - mData;
+    if(!reserveForAppend(size)) {
+        return;
+    }
+    if(inArray) {
+        data = mData + offset;
+    }
+    detail::addCounter(detail::ArrayBytesCopiedCounter, static_cast<uint64_t>(size));
+    std::copy(data, data + size, mData + mSize);
+    mSize += size;
     setExtents();
 }
 
+/*!
+    \brief Grows the array by count bytes which are left uninitialized
+
+    Meant for callers which fill the new bytes straight away, so they are not
+    copied or zero filled first.
+
+    \param count the number of bytes to add
+    \return a pointer to the first new byte, nullptr if the array can't grow
+    by count bytes
+*/
+char* ByteArray::extend(int count) {
+    if(!reserveForAppend(count)) {
+        return nullptr;
+    }
+    char* first = mData + mSize;
+    mSize += count;
+    setExtents();
+    return first;
+}
+
 /*!
     \brief Gets the data at index
     \param i the index of the data to retrieve
     \return a copy of the char at the index
 */
 char ByteArray::at(int i) const {
-    return mData[static_cast<std::vector<char>::size_type>(i)];
+    return mData[i];
 }
 
 /*!
@@ -102,7 +316,7 @@ char ByteArray::at(int i) const {
     \return the last element in the array
 */
 char ByteArray::back() const {
-    return mData.back();
+    return mData[mSize - 1];
 }
 
 /*!
@@ -110,39 +324,7 @@ char ByteArray::back() const {
     \return returns a copy of the first element in the array
 */
 char ByteArray::front() const {
-    return mData.front();
-}
-
-/*!
-    \brief Returns an iterator at the front of the array
-    \return an iterator at the front
-*/
-ByteArray::iterator ByteArray::begin() {
-    return mData.begin();
-}
-
-/*!
-    \brief Returns an iterator at the end of the array
-    \return Returns an iterator a the end of the array
-*/
-ByteArray::iterator ByteArray::end() {
-    return mData.end();
-}
-
-/*!
-  \brief returns an iterator to the begining of the function that is const
-  \return a const iterator at the begining
-*/
-ByteArray::const_iterator ByteArray::begin() const {
-    return mData.cbegin();
-}
-
-/*!
-    \brief Returns a iterator to the end of the array which is const
-    \return returns a const iterator at the end
-*/
-ByteArray::const_iterator ByteArray::end() const {
-    return mData.cend();
+    return mData[0];
 }
 
 /*!
@@ -150,7 +332,7 @@ ByteArray::const_iterator ByteArray::end() const {
     \return returns a const iterator to the begining of the array
 */
 ByteArray::const_iterator ByteArray::cbegin() {
-    return mData.cbegin();
+    return mData;
 }
 
 /*!
@@ -158,7 +340,7 @@ ByteArray::const_iterator ByteArray::cbegin() {
  * \return returns a const iterator at the end of the array
  */
 ByteArray::const_iterator ByteArray::cend() {
-    return mData.cend();
+    return mData + mSize;
 }
 
 /*!
@@ -169,8 +351,8 @@ ByteArray::const_iterator ByteArray::cend() {
     \return a pointer to the first element if full
 */
 const char*ByteArray::constData() {
-    if(!mData.empty()) {
-        return mData.data();
+    if(mSize > 0) {
+        return mData;
     }
     return nullptr;
 }
@@ -180,8 +362,8 @@ const char*ByteArray::constData() {
   \return returns a pointer to the first element if full
 */
 char*ByteArray::data() {
-    if(!mData.empty()) {
-        return mData.data();
+    if(mSize > 0) {
+        return mData;
     }
 
     return nullptr;
@@ -192,11 +374,70 @@ char*ByteArray::data() {
     \return Returns the size of the array
 */
 int ByteArray::size() const {
-    return static_cast<int>(mData.size());
+    return mSize;
+}
+
+/*!
+    \brief Returns the number of bytes the array can hold without reallocating
+    \return the capacity of the array
+*/
+int ByteArray::capacity() const {
+    return mCapacity;
+}
+
+/*!
+    \brief Makes sure the array can hold at least size bytes without reallocating
+
+    Does nothing if the capacity is already large enough. The size of the array
+    is not changed.
+
+    \param size the number of bytes to reserve
+*/
+void ByteArray::reserve(int size) {
+    if(size > mCapacity) {
+        reallocate(size);
+    }
 }
 
+/*!
+    \brief Releases any capacity that is not being used by the data
+*/
+void ByteArray::shrink_to_fit() {
+    if(mCapacity > mSize) {
+        reallocate(mSize);
+    }
+}
+
+/*!
+    \brief Shortens the array to size bytes, keeping the capacity
+
+    Does nothing if the array is already no longer than size.
+
+    \param size the size to shorten to
+*/
+void ByteArray::truncate(int size) {
+    if(size < mSize) {
+        mSize = size < 0 ? 0 : size;
+        setExtents();
+    }
+}
+
+/*!
+    \brief Removes all of the data from the array
+
+    The capacity is kept, so the array can be refilled without reallocating.
+*/
+void ByteArray::clear() {
+    mSize = 0;
+    setExtents();
+}
+
+/*!
+    \brief Returns true if the array holds no data
+    \return true if empty, otherwise false
+*/
 bool ByteArray::empty() const {
-    return mData.empty();
+    return mSize == 0;
 }
 
 /*!
@@ -205,7 +446,7 @@ bool ByteArray::empty() const {
  * \return
  */
 char& ByteArray::operator[](int idx) {
-    return mData[static_cast<std::vector<char>::size_type>(idx)];
+    return mData[idx];
 }
 
 /*!
@@ -214,16 +455,108 @@ char& ByteArray::operator[](int idx) {
  * \return
  */
 char ByteArray::operator[](int idx) const {
-    return mData[static_cast<std::vector<char>::size_type>(idx)];
+    return mData[idx];
 }
 
 void ByteArray::setExtents() {
-    setg(mData.data(), mData.data(), mData.data() + mData.size());
+    setg(mData, mData, mData + mSize);
 }
 
 /*!
-    \brief Default destructor for the ByteArray class
+    \brief Grows the capacity geometrically so count more bytes can be appended
+
+    Doubling the capacity keeps a sequence of appends amortized constant time.
+    The capacity stops doubling at INT_MAX, the most an array can hold.
+
+    \param count the number of bytes about to be appended
+    \return false if count is negative or the array can't hold count more
+    bytes, the array is unchanged then
 */
-ByteArray::~ByteArray() = default;
+bool ByteArray::reserveForAppend(int count) {
+    const int64_t required = static_cast<int64_t>(mSize) + count;
+    if(count < 0 || required > std::numeric_limits<int>::max()) {
+        return false;
+    }
 
+    if(required > mCapacity) {
+        const int64_t doubled = std::min<int64_t>(static_cast<int64_t>(mCapacity) * 2,
+                                                  std::numeric_limits<int>::max());
+        reallocate(static_cast<int>(std::max(required, doubled)));
+    }
+    return true;
+}
 
+/*!
+    \brief Moves the data into a new buffer which holds capacity bytes
+
+    The new bytes past the data are left uninitialized. A ByteAllocator may
+    round the capacity up. A capacity that fits inline moves the data back
+    into the array.
+
+    \param capacity the capacity of the new buffer
+*/
+void ByteArray::reallocate(int capacity) {
+    if(capacity <= InlineCapacity) {
+        if(mData != mInline) {
+            detail::addCounter(detail::ArrayReallocationsCounter, 1);
+            std::copy(mData, mData + mSize, mInline);
+            const int size = mSize;
+            reset();
+            mSize = size;
+            setExtents();
+        }
+        return;
+    }
+
+    detail::addCounter(detail::ArrayReallocationsCounter, 1);
+    if(mAllocator) {
+        std::size_t allocated = static_cast<std::size_t>(capacity);
+        char* allocation = mAllocator->allocate(allocated);
+        std::copy(mData, mData + mSize, allocation);
+
+        const int size = mSize;
+        reset();
+        mAllocation = allocation;
+        mData = mAllocation;
+        mSize = size;
+        mCapacity = static_cast<int>(allocated);
+        setExtents();
+        return;
+    }
+
+    std::unique_ptr<char[]> buffer(new char[capacity]);
+    std::copy(mData, mData + mSize, buffer.get());
+
+    const int size = mSize;
+    reset();
+    mBuffer = std::move(buffer);
+    mData = mBuffer.get();
+    mSize = size;
+    mCapacity = capacity;
+    setExtents();
+}
+
+/*!
+    \brief Frees the storage and leaves the array empty, using its inline storage
+
+    The allocator is kept.
+*/
+void ByteArray::reset() {
+    if(mAllocation) {
+        mAllocator->deallocate(mAllocation, static_cast<std::size_t>(mCapacity));
+        mAllocation = nullptr;
+    }
+    mBuffer.reset();
+    std::vector<char>().swap(mVector);
+    mData = mInline;
+    mSize = 0;
+    mCapacity = InlineCapacity;
+    setExtents();
+}
+
+/*!
+    \brief Destructor for the ByteArray class, which frees its storage
+*/
+ByteArray::~ByteArray() {
+    reset();
+}
@@ -7,30 +7,61 @@
 #define BYTE_ARRAY_HPP
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <iostream>
 #include <streambuf>
 
+class ByteAllocator;
+
+#ifndef SERIAL_BYTE_ARRAY_INLINE_CAPACITY
+    #define SERIAL_BYTE_ARRAY_INLINE_CAPACITY 64
+#endif
 
 /*!
-    \brief Class which wraps a std::vector for serialization containers
+    \brief Class which manages a contiguous buffer for serialization containers
+
+    The buffer is either allocated by the array, or adopted from a
+    std::unique_ptr or a std::vector without copying. The array allocates
+    with new[] unless it is given a ByteAllocator, such as a ByteArrayPool.
+
+    Data of up to InlineCapacity bytes is kept inside the array itself, so
+    small arrays never allocate. The data moves to the heap once it outgrows
+    that. Define SERIAL_BYTE_ARRAY_INLINE_CAPACITY to change the threshold.
 */
 class ByteArray : public std::streambuf {
 public:
-    using iterator = std::vector<char>::iterator;
-    using const_iterator = std::vector<char>::const_iterator;
+    using iterator = char*;
+    using const_iterator = const char*;
+
+    //! The number of bytes the array holds without allocating
+    static const int InlineCapacity = SERIAL_BYTE_ARRAY_INLINE_CAPACITY;
 
     ByteArray();
+    explicit ByteArray(ByteAllocator *allocator);
     ByteArray(const char* data, int size = -1);
     ByteArray(int size, char ch);
+    ByteArray(std::unique_ptr<char[]> data, int size);
+    explicit ByteArray(std::vector<char> &&data);
     ByteArray(const ByteArray &other);
+    ByteArray(ByteArray &&other) noexcept;
 
     ~ByteArray();
 
+    ByteArray& operator=(const ByteArray &other);
+    ByteArray& operator=(ByteArray &&other) noexcept;
+
+    void adopt(std::unique_ptr<char[]> data, int size);
+    void adopt(std::vector<char> &&data);
+    std::unique_ptr<char[]> release();
+
+    ByteAllocator* allocator() const;
+
     void append(const ByteArray &array);
     void append(int count, char ch);
     void append(const char* data);
     void append(const char* data, int size);
+    char* extend(int count);
 
     char at(int i) const;
     char back() const;
@@ -49,6 +80,12 @@ public:
     char* data();
 
     int size() const;
+    int capacity() const;
+
+    void reserve(int size);
+    void shrink_to_fit();
+    void truncate(int size);
+    void clear();
 
     bool empty() const;
 
@@ -59,8 +96,53 @@ protected:
     void setExtents();
 
 private:
-    std::vector<char> mData; //!< the serialized data
+    bool reserveForAppend(int count);
+    void reallocate(int capacity);
+    void reset();
+
+    char *mData; //!< the serialized data, owned by mBuffer or mVector
+    int mSize; //!< the number of bytes of data
+    int mCapacity; //!< the number of bytes mData can hold
+    std::unique_ptr<char[]> mBuffer; //!< heap storage allocated or adopted
+    std::vector<char> mVector; //!< storage adopted from a vector
+    ByteAllocator *mAllocator; //!< allocates the storage, nullptr for new[]
+    char *mAllocation; //!< storage from mAllocator, nullptr if there is none
+    char mInline[InlineCapacity]; //!< storage for data that fits in the array
+
+    static_assert(InlineCapacity > 0, "SERIAL_BYTE_ARRAY_INLINE_CAPACITY must be positive");
 
 };
 
+/*!
+    \brief Returns an iterator at the front of the array
+    \return an iterator at the front
+*/
+inline ByteArray::iterator ByteArray::begin() {
+    return mData;
+}
+
+/*!
+    \brief Returns an iterator at the end of the array
+    \return Returns an iterator a the end of the array
+*/
+inline ByteArray::iterator ByteArray::end() {
+    return mData + mSize;
+}
+
+/*!
+  \brief returns an iterator to the begining of the function that is const
+  \return a const iterator at the begining
+*/
+inline ByteArray::const_iterator ByteArray::begin() const {
+    return mData;
+}
+
+/*!
+    \brief Returns a iterator to the end of the array which is const
+    \return returns a const iterator at the end
+*/
+inline ByteArray::const_iterator ByteArray::end() const {
+    return mData + mSize;
+}
+
 #endif // APP_HPP
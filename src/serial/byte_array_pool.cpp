@@ -0,0 +1,147 @@
+/*!
+    \file byte_array_pool.cpp
+    \brief file to implement the ByteArrayPool class
+*/
+#include "byte_array_pool.hpp"
+
+namespace {
+//! The number of power of two size classes from MinBlockSize to MaxBlockSize
+const std::size_t SizeClasses = 15;
+
+static_assert(ByteArrayPool::MinBlockSize << (SizeClasses - 1) == ByteArrayPool::MaxBlockSize,
+              "SizeClasses must span MinBlockSize to MaxBlockSize");
+}
+
+/*!
+    \brief Creates an empty pool
+    \param maxCachedBlocks the most free buffers to keep for each size class
+*/
+ByteArrayPool::ByteArrayPool(std::size_t maxCachedBlocks) :
+mFree(SizeClasses),
+mMaxCachedBlocks(maxCachedBlocks),
+mHeapAllocations(0),
+mOwner(std::this_thread::get_id()){
+
+}
+
+/*!
+    \brief Frees every cached buffer
+
+    Arrays still using the pool must be destroyed before it.
+*/
+ByteArrayPool::~ByteArrayPool() {
+    trim();
+}
+
+/*!
+    \brief Returns the pool of the calling thread, creating it on first use
+
+    Arrays from the pool must not outlive the thread.
+
+    \return the pool of the calling thread
+*/
+ByteArrayPool& ByteArrayPool::local() {
+    static thread_local ByteArrayPool pool;
+    return pool;
+}
+
+/*!
+    \brief Returns an empty array which allocates from this pool
+    \param capacity the number of bytes to reserve in the array
+    \return the array
+*/
+ByteArray ByteArrayPool::acquire(int capacity) {
+    ByteArray array(this);
+    array.reserve(capacity);
+    return array;
+}
+
+/*!
+    \brief Hands out a cached buffer of the size class of size, if there is one
+    \param size the number of bytes wanted, set to the size of the class
+    \return the buffer
+*/
+char* ByteArrayPool::allocate(std::size_t &size) {
+    if(size > MaxBlockSize) {
+        mHeapAllocations++;
+        return new char[size];
+    }
+
+    const std::size_t index = sizeClass(size);
+    size = MinBlockSize << index;
+
+    std::vector<char*> &free = mFree[index];
+    if(!free.empty()) {
+        char *data = free.back();
+        free.pop_back();
+        return data;
+    }
+
+    mHeapAllocations++;
+    return new char[size];
+}
+
+/*!
+    \brief Keeps data for reuse, or frees it if its size class is full
+    \param data the buffer to give back
+    \param size the size allocate() returned for it
+*/
+void ByteArrayPool::deallocate(char *data, std::size_t size) {
+    if(size <= MaxBlockSize && std::this_thread::get_id() == mOwner) {
+        std::vector<char*> &free = mFree[sizeClass(size)];
+        if(free.size() < mMaxCachedBlocks) {
+            free.push_back(data);
+            return;
+        }
+    }
+
+    delete[] data;
+}
+
+/*!
+    \brief Returns the number of free buffers held by the pool
+    \return the number of cached buffers
+*/
+std::size_t ByteArrayPool::cachedBlocks() const {
+    std::size_t count = 0;
+    for(const std::vector<char*> &free : mFree) {
+        count += free.size();
+    }
+    return count;
+}
+
+/*!
+    \brief Returns how many buffers the pool has had to take from the heap
+
+    This stops growing once the pool has warmed up to a steady workload.
+
+    \return the number of heap allocations
+*/
+uint64_t ByteArrayPool::heapAllocations() const {
+    return mHeapAllocations;
+}
+
+/*!
+    \brief Frees every cached buffer back to the heap
+*/
+void ByteArrayPool::trim() {
+    for(std::vector<char*> &free : mFree) {
+        for(char *data : free) {
+            delete[] data;
+        }
+        free.clear();
+    }
+}
+
+/*!
+    \brief Returns the index of the smallest size class that holds size bytes
+    \param size the number of bytes, at most MaxBlockSize
+    \return the index of the size class
+*/
+std::size_t ByteArrayPool::sizeClass(std::size_t size) {
+    std::size_t index = 0;
+    while((MinBlockSize << index) < size) {
+        index++;
+    }
+    return index;
+}
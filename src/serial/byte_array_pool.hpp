@@ -0,0 +1,64 @@
+/*!
+    \file byte_array_pool.hpp
+    \brief File to define the ByteArrayPool class
+*/
+
+#ifndef BYTE_ARRAY_POOL_HPP
+#define BYTE_ARRAY_POOL_HPP
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "byte_allocator.hpp"
+#include "byte_array.hpp"
+
+/*!
+    \brief Allocator which recycles ByteArray buffers instead of freeing them
+
+    Buffers are rounded up to a power of two size class between MinBlockSize
+    and MaxBlockSize, and freed buffers are kept in a list per class to be
+    handed out again. Once the lists hold enough buffers for a workload,
+    creating and destroying arrays no longer touches the heap. Buffers larger
+    than MaxBlockSize are never cached.
+
+    A pool is not thread safe. Use local() for a pool per thread; a buffer
+    freed on a thread other than the one that created its pool is freed to
+    the heap instead of being cached.
+*/
+class ByteArrayPool : public ByteAllocator {
+public:
+    //! The size of the smallest size class
+    static const std::size_t MinBlockSize = 64;
+    //! The size of the largest size class, larger buffers aren't cached
+    static const std::size_t MaxBlockSize = 1024 * 1024;
+    //! The number of free buffers kept per size class if none is given
+    static const std::size_t DefaultMaxCachedBlocks = 32;
+
+    explicit ByteArrayPool(std::size_t maxCachedBlocks = DefaultMaxCachedBlocks);
+    ~ByteArrayPool() override;
+
+    ByteArrayPool(const ByteArrayPool &other) = delete;
+    ByteArrayPool& operator=(const ByteArrayPool &other) = delete;
+
+    static ByteArrayPool& local();
+
+    ByteArray acquire(int capacity = 0);
+
+    char* allocate(std::size_t &size) override;
+    void deallocate(char *data, std::size_t size) override;
+
+    std::size_t cachedBlocks() const;
+    uint64_t heapAllocations() const;
+    void trim();
+
+private:
+    static std::size_t sizeClass(std::size_t size);
+
+    std::vector<std::vector<char*>> mFree; //!< the free buffers by size class
+    std::size_t mMaxCachedBlocks; //!< the most free buffers kept per class
+    uint64_t mHeapAllocations; //!< the number of buffers taken from the heap
+    std::thread::id mOwner; //!< the thread which may cache freed buffers
+};
+
+#endif // BYTE_ARRAY_POOL_HPP
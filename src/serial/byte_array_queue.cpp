@@ -0,0 +1,215 @@
+/*!
+    \file byte_array_queue.cpp
+    \brief file to implement the SpscByteArrayQueue and MpscByteArrayQueue classes
+*/
+#include "byte_array_queue.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+/*!
+    \brief Rounds capacity up to a power of two, of at least 2
+*/
+std::size_t roundCapacity(std::size_t capacity) {
+    std::size_t rounded = 2;
+    while(rounded < capacity) {
+        rounded <<= 1;
+    }
+    return rounded;
+}
+}
+
+/*!
+    \brief Constructs an empty queue
+    \param capacity the most arrays the queue holds, rounded up to a power of two
+*/
+SpscByteArrayQueue::SpscByteArrayQueue(std::size_t capacity) :
+mSlots(new ByteArray[roundCapacity(capacity)]),
+mMask(roundCapacity(capacity) - 1),
+mTail(0),
+mCachedHead(0),
+mHead(0),
+mCachedTail(0){
+
+}
+
+/*!
+    \brief Moves array onto the back of the queue, only from the producer thread
+    \param array the array to push, left untouched if the queue is full
+    \return true if the array was pushed, false if the queue is full
+*/
+bool SpscByteArrayQueue::tryPush(ByteArray &&array) {
+    const std::size_t tail = mTail.load(std::memory_order_relaxed);
+    if(tail - mCachedHead > mMask) {
+        mCachedHead = mHead.load(std::memory_order_acquire);
+        if(tail - mCachedHead > mMask) {
+            return false;
+        }
+    }
+
+    mSlots[tail & mMask] = std::move(array);
+    mTail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/*!
+    \brief Moves the array at the front of the queue into array, only from the
+    consumer thread
+    \param array set to the popped array
+    \return true if an array was popped, false if the queue is empty
+*/
+bool SpscByteArrayQueue::tryPop(ByteArray &array) {
+    return popBatch(&array, 1) == 1;
+}
+
+/*!
+    \brief Moves up to maxCount arrays from the front of the queue into arrays,
+    only from the consumer thread
+    \param arrays where to move the popped arrays
+    \param maxCount the most arrays to pop
+    \return the number of arrays popped
+*/
+std::size_t SpscByteArrayQueue::popBatch(ByteArray *arrays, std::size_t maxCount) {
+    const std::size_t head = mHead.load(std::memory_order_relaxed);
+    if(mCachedTail - head < maxCount) {
+        mCachedTail = mTail.load(std::memory_order_acquire);
+    }
+
+    const std::size_t count = std::min(mCachedTail - head, maxCount);
+    for(std::size_t i = 0; i < count; i++) {
+        arrays[i] = std::move(mSlots[(head + i) & mMask]);
+    }
+    if(count > 0) {
+        mHead.store(head + count, std::memory_order_release);
+    }
+    return count;
+}
+
+/*!
+    \brief Returns the most arrays the queue holds
+*/
+std::size_t SpscByteArrayQueue::capacity() const {
+    return mMask + 1;
+}
+
+/*!
+    \brief Returns the number of arrays in the queue, which may be out of date
+    by the time it returns if the other thread is active
+*/
+std::size_t SpscByteArrayQueue::size() const {
+    const std::size_t head = mHead.load(std::memory_order_acquire);
+    return mTail.load(std::memory_order_acquire) - head;
+}
+
+/*!
+    \brief Returns true if the queue is empty, see size()
+*/
+bool SpscByteArrayQueue::empty() const {
+    return size() == 0;
+}
+
+/*!
+    \brief Constructs an empty queue
+    \param capacity the most arrays the queue holds, rounded up to a power of two
+*/
+MpscByteArrayQueue::MpscByteArrayQueue(std::size_t capacity) :
+mSlots(new Slot[roundCapacity(capacity)]),
+mMask(roundCapacity(capacity) - 1),
+mTail(0),
+mHead(0){
+    for(std::size_t i = 0; i <= mMask; i++) {
+        mSlots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+/*!
+    \brief Moves array onto the back of the queue, from any thread
+    \param array the array to push, left untouched if the queue is full
+    \return true if the array was pushed, false if the queue is full
+*/
+bool MpscByteArrayQueue::tryPush(ByteArray &&array) {
+    std::size_t tail = mTail.load(std::memory_order_relaxed);
+    Slot* slot;
+    while(true) {
+        slot = &mSlots[tail & mMask];
+        const std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        if(sequence == tail) {
+            if(mTail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(sequence < tail) {
+            // The slot still holds the array from the last lap
+            return false;
+        } else {
+            tail = mTail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->array = std::move(array);
+    slot->sequence.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+/*!
+    \brief Moves the array at the front of the queue into array, only from the
+    consumer thread
+    \param array set to the popped array
+    \return true if an array was popped, false if the queue is empty
+*/
+bool MpscByteArrayQueue::tryPop(ByteArray &array) {
+    return popBatch(&array, 1) == 1;
+}
+
+/*!
+    \brief Moves up to maxCount arrays from the front of the queue into arrays,
+    only from the consumer thread
+
+    Stops early at a slot which a producer has claimed but not filled yet.
+
+    \param arrays where to move the popped arrays
+    \param maxCount the most arrays to pop
+    \return the number of arrays popped
+*/
+std::size_t MpscByteArrayQueue::popBatch(ByteArray *arrays, std::size_t maxCount) {
+    const std::size_t head = mHead.load(std::memory_order_relaxed);
+    std::size_t count = 0;
+    while(count < maxCount) {
+        Slot& slot = mSlots[(head + count) & mMask];
+        if(slot.sequence.load(std::memory_order_acquire) != head + count + 1) {
+            break;
+        }
+        arrays[count] = std::move(slot.array);
+        // Free the slot for the producers of the next lap
+        slot.sequence.store(head + count + mMask + 1, std::memory_order_release);
+        count++;
+    }
+    if(count > 0) {
+        mHead.store(head + count, std::memory_order_relaxed);
+    }
+    return count;
+}
+
+/*!
+    \brief Returns the most arrays the queue holds
+*/
+std::size_t MpscByteArrayQueue::capacity() const {
+    return mMask + 1;
+}
+
+/*!
+    \brief Returns the number of arrays claimed by producers and not popped yet,
+    which may be out of date by the time it returns
+*/
+std::size_t MpscByteArrayQueue::size() const {
+    const std::size_t head = mHead.load(std::memory_order_relaxed);
+    const std::size_t tail = mTail.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+}
+
+/*!
+    \brief Returns true if the queue is empty, see size()
+*/
+bool MpscByteArrayQueue::empty() const {
+    return size() == 0;
+}
@@ -0,0 +1,105 @@
+/*!
+    \file byte_array_queue.hpp
+    \brief File to define the SpscByteArrayQueue and MpscByteArrayQueue classes
+*/
+
+#ifndef BYTE_ARRAY_QUEUE_HPP
+#define BYTE_ARRAY_QUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+#include "byte_array.hpp"
+
+/*!
+    \brief The size of a cache line, which the indices of a queue are spaced by
+    so producers and consumers don't contend for the same line
+*/
+const std::size_t QueueCacheLineSize = 64;
+
+/*!
+    \brief Bounded lock free queue moving ByteArrays from one thread to another
+
+    Arrays are moved in and out, so the buffer of an array on the heap changes
+    hands without being copied. Only one thread may push and only one thread
+    may pop at a time. The capacity is rounded up to a power of two.
+
+    Each side keeps a cached copy of the other side's index, so it only reads
+    the shared index when the queue looks full or empty. popBatch() takes every
+    ready array with a single acquire and release.
+
+    An array from a ByteArrayPool which is destroyed on the consuming thread is
+    freed to the heap, not returned to the pool of the producing thread.
+*/
+class SpscByteArrayQueue {
+public:
+    explicit SpscByteArrayQueue(std::size_t capacity);
+
+    SpscByteArrayQueue(const SpscByteArrayQueue &other) = delete;
+    SpscByteArrayQueue& operator=(const SpscByteArrayQueue &other) = delete;
+
+    bool tryPush(ByteArray &&array);
+    bool tryPop(ByteArray &array);
+    std::size_t popBatch(ByteArray *arrays, std::size_t maxCount);
+
+    std::size_t capacity() const;
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    std::unique_ptr<ByteArray[]> mSlots; //!< the ring of arrays
+    std::size_t mMask; //!< the capacity less one, to wrap indices
+
+    alignas(QueueCacheLineSize) std::atomic<std::size_t> mTail; //!< the next slot to push to
+    std::size_t mCachedHead; //!< the producer's copy of mHead
+
+    alignas(QueueCacheLineSize) std::atomic<std::size_t> mHead; //!< the next slot to pop from
+    std::size_t mCachedTail; //!< the consumer's copy of mTail
+};
+
+/*!
+    \brief Bounded lock free queue moving ByteArrays from many threads to one
+
+    Any number of threads may push at once, only one thread may pop at a time.
+    Arrays are moved without copying their buffers, as in SpscByteArrayQueue.
+
+    Every slot has a sequence number saying whether it is free or filled for
+    a given lap of the ring. Producers claim a slot with a compare and swap on
+    the tail, and publish it by advancing its sequence, so a slow producer only
+    delays the consumer at its own slot. The single consumer needs no atomic
+    read-modify-write at all.
+*/
+class MpscByteArrayQueue {
+public:
+    explicit MpscByteArrayQueue(std::size_t capacity);
+
+    MpscByteArrayQueue(const MpscByteArrayQueue &other) = delete;
+    MpscByteArrayQueue& operator=(const MpscByteArrayQueue &other) = delete;
+
+    bool tryPush(ByteArray &&array);
+    bool tryPop(ByteArray &array);
+    std::size_t popBatch(ByteArray *arrays, std::size_t maxCount);
+
+    std::size_t capacity() const;
+    std::size_t size() const;
+    bool empty() const;
+
+private:
+    /*!
+        \brief A slot of the ring, the sequence is its index when free and its
+        index plus one when filled
+    */
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        ByteArray array;
+    };
+
+    std::unique_ptr<Slot[]> mSlots; //!< the ring of slots
+    std::size_t mMask; //!< the capacity less one, to wrap indices
+
+    alignas(QueueCacheLineSize) std::atomic<std::size_t> mTail; //!< the next slot to claim for a push
+    alignas(QueueCacheLineSize) std::atomic<std::size_t> mHead; //!< the next slot to pop from
+};
+
+#endif // BYTE_ARRAY_QUEUE_HPP
@@ -0,0 +1,175 @@
+/*!
+    \file byte_order.cpp
+    \brief file to implement the bulk byte order conversion kernels
+*/
+#include "byte_order.hpp"
+
+#include <cassert>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define SERIAL_X86_KERNELS 1
+    #include <immintrin.h>
+#else
+    #define SERIAL_X86_KERNELS 0
+#endif
+
+namespace {
+
+using SwapKernel = void (*)(char*, const char*, std::size_t, std::size_t);
+
+/*!
+    \brief Swaps count values of Size bytes one at a time
+    \param destination where to write the swapped values
+    \param source the values to swap
+    \param count the number of values
+*/
+template<std::size_t Size>
+void swapScalar(char *destination, const char *source, std::size_t count) {
+    using Swapper = ByteSwapper<Size>;
+    for(std::size_t i = 0; i < count; i++) {
+        typename Swapper::Raw raw;
+        std::memcpy(&raw, source + i * Size, Size);
+        raw = Swapper::swap(raw);
+        std::memcpy(destination + i * Size, &raw, Size);
+    }
+}
+
+/*!
+    \brief Portable kernel, swaps the values one at a time
+    \param destination where to write the swapped values
+    \param source the values to swap
+    \param count the number of values
+    \param width the size of each value, 2, 4 or 8
+*/
+void swapGeneric(char *destination, const char *source, std::size_t count,
+                 std::size_t width) {
+    switch(width) {
+        case 2:
+            swapScalar<2>(destination, source, count);
+            break;
+        case 4:
+            swapScalar<4>(destination, source, count);
+            break;
+        case 8:
+            swapScalar<8>(destination, source, count);
+            break;
+    }
+}
+
+#if SERIAL_X86_KERNELS
+/*!
+    \brief Returns the pshufb control which reverses each value of width bytes
+    \param width the size of each value, 2, 4 or 8
+    \return the byte indices of a 16 byte lane
+*/
+const char* shuffleControl(std::size_t width) {
+    static const char swap16[16] = {1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14};
+    static const char swap32[16] = {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12};
+    static const char swap64[16] = {7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8};
+    return width == 2 ? swap16 : (width == 4 ? swap32 : swap64);
+}
+
+/*!
+    \brief SSSE3 kernel, swaps 16 bytes per shuffle
+    \param destination where to write the swapped values
+    \param source the values to swap
+    \param count the number of values
+    \param width the size of each value, 2, 4 or 8
+*/
+__attribute__((target("ssse3")))
+void swapSsse3(char *destination, const char *source, std::size_t count,
+               std::size_t width) {
+    const __m128i control = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(shuffleControl(width)));
+    const std::size_t bytes = count * width;
+
+    std::size_t i = 0;
+    for(; i + 16 <= bytes; i += 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+        block = _mm_shuffle_epi8(block, control);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i), block);
+    }
+
+    // 16 is a multiple of every width, so the tail is whole values
+    swapGeneric(destination + i, source + i, (bytes - i) / width, width);
+}
+
+/*!
+    \brief AVX2 kernel, swaps 32 bytes per shuffle
+    \param destination where to write the swapped values
+    \param source the values to swap
+    \param count the number of values
+    \param width the size of each value, 2, 4 or 8
+*/
+__attribute__((target("avx2")))
+void swapAvx2(char *destination, const char *source, std::size_t count,
+              std::size_t width) {
+    // vpshufb shuffles each 128 bit lane separately, so repeat the control
+    const __m128i lane = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(shuffleControl(width)));
+    const __m256i control = _mm256_broadcastsi128_si256(lane);
+    const std::size_t bytes = count * width;
+
+    std::size_t i = 0;
+    for(; i + 64 <= bytes; i += 64) {
+        __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i + 32));
+        first = _mm256_shuffle_epi8(first, control);
+        second = _mm256_shuffle_epi8(second, control);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), first);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i + 32), second);
+    }
+    for(; i + 32 <= bytes; i += 32) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+        block = _mm256_shuffle_epi8(block, control);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), block);
+    }
+
+    swapGeneric(destination + i, source + i, (bytes - i) / width, width);
+}
+#endif
+
+/*!
+    \brief Picks the fastest kernel the processor supports
+    \return the kernel to use
+*/
+SwapKernel selectKernel() {
+#if SERIAL_X86_KERNELS
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return swapAvx2;
+    }
+    if(__builtin_cpu_supports("ssse3")) {
+        return swapSsse3;
+    }
+#endif
+    return swapGeneric;
+}
+
+} // namespace
+
+/*!
+    \brief Copies count values of width bytes, reversing the bytes of each one
+
+    Uses AVX2 or SSSE3 shuffles when the processor supports them, chosen once
+    at runtime, and a scalar loop otherwise. destination may equal source to
+    swap in place, but the ranges must not otherwise overlap.
+
+    \param destination where to write the swapped values
+    \param source the values to swap
+    \param count the number of values
+    \param width the size of each value in bytes, 1, 2, 4 or 8
+*/
+void swapBytesCopy(char *destination, const char *source, std::size_t count,
+                   std::size_t width) {
+    assert(width == 1 || width == 2 || width == 4 || width == 8);
+    if(width == 1) {
+        if(destination != source) {
+            std::memcpy(destination, source, count);
+        }
+        return;
+    }
+
+    static const SwapKernel kernel = selectKernel();
+    kernel(destination, source, count, width);
+}
@@ -0,0 +1,144 @@
+/*!
+    \file byte_order.hpp
+    \brief File to define helpers for converting between byte orders
+*/
+
+#ifndef BYTE_ORDER_HPP
+#define BYTE_ORDER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#ifdef WIN32
+    #include "stdlib.h"
+#endif
+
+/*!
+    \brief Set to 1 when the host stores values most significant byte first
+*/
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+    __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    #define SERIAL_HOST_BIG_ENDIAN 1
+#else
+    #define SERIAL_HOST_BIG_ENDIAN 0
+#endif
+
+/*!
+    \brief Reverses the bytes of a 16 bit value
+    \param value the value to swap
+    \return the swapped value
+*/
+inline uint16_t byteSwap16(uint16_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap16(value);
+#elif defined(WIN32)
+    return _byteswap_ushort(value);
+#else
+    return static_cast<uint16_t>((value >> 8) | (value << 8));
+#endif
+}
+
+/*!
+    \brief Reverses the bytes of a 32 bit value
+    \param value the value to swap
+    \return the swapped value
+*/
+inline uint32_t byteSwap32(uint32_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap32(value);
+#elif defined(WIN32)
+    return _byteswap_ulong(value);
+#else
+    return ((value & 0x000000FFu) << 24) | ((value & 0x0000FF00u) << 8) |
+           ((value & 0x00FF0000u) >> 8) | ((value & 0xFF000000u) >> 24);
+#endif
+}
+
+/*!
+    \brief Reverses the bytes of a 64 bit value
+    \param value the value to swap
+    \return the swapped value
+*/
+inline uint64_t byteSwap64(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_bswap64(value);
+#elif defined(WIN32)
+    return _byteswap_uint64(value);
+#else
+    return (static_cast<uint64_t>(byteSwap32(static_cast<uint32_t>(value))) << 32) |
+           byteSwap32(static_cast<uint32_t>(value >> 32));
+#endif
+}
+
+/*!
+    \brief Reverses the bytes of raw values of each width
+*/
+template<std::size_t Size>
+struct ByteSwapper;
+
+template<>
+struct ByteSwapper<1> {
+    static uint8_t swap(uint8_t value) { return value; }
+    using Raw = uint8_t;
+};
+
+template<>
+struct ByteSwapper<2> {
+    static uint16_t swap(uint16_t value) { return byteSwap16(value); }
+    using Raw = uint16_t;
+};
+
+template<>
+struct ByteSwapper<4> {
+    static uint32_t swap(uint32_t value) { return byteSwap32(value); }
+    using Raw = uint32_t;
+};
+
+template<>
+struct ByteSwapper<8> {
+    static uint64_t swap(uint64_t value) { return byteSwap64(value); }
+    using Raw = uint64_t;
+};
+
+/*!
+    \brief Reverses the bytes of an arithmetic value
+
+    Floating point values are swapped through their IEEE 754 bit pattern.
+
+    \param value the value to swap
+    \return the swapped value
+*/
+template<typename T>
+inline T swapBytes(T value) {
+    static_assert(std::is_arithmetic<T>::value, "only arithmetic types can be swapped");
+
+    using Swapper = ByteSwapper<sizeof(T)>;
+    typename Swapper::Raw raw;
+    std::memcpy(&raw, &value, sizeof(T));
+    raw = Swapper::swap(raw);
+    std::memcpy(&value, &raw, sizeof(T));
+    return value;
+}
+
+void swapBytesCopy(char *destination, const char *source, std::size_t count,
+                   std::size_t width);
+
+/*!
+    \brief The type an arithmetic value is copied out of raw bytes as
+
+    A bool is copied as a byte and converted, so any byte other than 0 reads
+    as true instead of making an invalid bool.
+*/
+template<typename T>
+struct RawType {
+    using type = T;
+};
+
+template<>
+struct RawType<bool> {
+    using type = uint8_t;
+};
+
+#endif // BYTE_ORDER_HPP
@@ -3,22 +3,15 @@
     \brief file to add implementation of the ByteStream class
 */
 #include "byte_stream.hpp"
+#include "checksum.hpp"
+#include "io_device.hpp"
+#include "mapped_byte_array.hpp"
+#include "varint.hpp"
 #include <algorithm>
 #include <cassert>
 #include <limits>
 #include <cstring>
 
-#ifdef LINUX
-    #include <endian.h>
-#endif
-
-#ifdef WIN32
-    #include "stdlib.h"
-#endif
-
-#ifdef MACOS
-    #include <endian.h>
-#endif
 /*!
     \brief Default constructor for the ByteStream class
 
@@ -28,8 +21,22 @@ ByteStream::ByteStream() :
 mArray(nullptr),
 mMode(OpenMode::ReadWrite),
 mOrder(ByteOrder::BigEndian),
-mStatus(Status::Ok){
-
+mSwap(hostByteOrder() != ByteOrder::BigEndian),
+mEncoding(IntegerEncoding::Fixed),
+mMaxStringLength(DefaultMaxStringLength),
+mStatus(Status::Ok),
+mBegin(nullptr),
+mCur(nullptr),
+mEnd(nullptr),
+mDevice(nullptr),
+mBufferSize(0),
+mDeviceAtEnd(false),
+mChecksumming(false),
+mChecksum(0),
+mChecksumStart(0){
+#if SERIAL_ENABLE_INSTRUMENTATION
+    mOperationDepth = 0;
+#endif
 }
 
 /*!
@@ -38,36 +45,79 @@ mStatus(Status::Ok){
     \param mode The mode to read or write from the byte array on
 */
 ByteStream::ByteStream(ByteArray* array, ByteStream::OpenMode mode) :
-mArray(array),
-mMode(mode),
-mOrder(ByteOrder::BigEndian),
-mStatus(Status::Ok),
-mIter(mArray->begin()){
+ByteStream(){
+    setDevice(array, mode);
+}
+
+/*!
+    \brief Constructs a read only ByteStream over memory it does not own
+
+    Nothing is copied, the memory referred to by view must outlive the stream.
 
+    \param view the bytes to read from
+*/
+ByteStream::ByteStream(const ByteView& view) :
+ByteStream(){
+    setDevice(view);
+}
+
+/*!
+    \brief Constructs a ByteStream over a memory mapped file
+    \param array the mapping to operate on
+    \param mode The mode to read or write from the mapping on
+*/
+ByteStream::ByteStream(MappedByteArray* array, ByteStream::OpenMode mode) :
+ByteStream(){
+    setDevice(array, mode);
+}
+
+/*!
+    \brief Constructs a buffered ByteStream which reads or writes an IODevice
+    \param device the device to operate on
+    \param mode ReadOnly to read from the device, otherwise writes to it
+    \param bufferSize the size of the buffer between the stream and device
+*/
+ByteStream::ByteStream(IODevice* device, ByteStream::OpenMode mode, std::size_t bufferSize) :
+ByteStream(){
+    setDevice(device, mode, bufferSize);
 }
 
 /*!
-    \brief Default destructor for the ByteStream class
+    \brief Destructor for the ByteStream class
 
-    Since we do not take ownership of the byte array we don't reallocate.
+    Since we do not take ownership of the device we don't free it, but any
+    data still buffered for an IODevice is written to it.
 */
-ByteStream::~ByteStream() = default;
+ByteStream::~ByteStream() {
+    releaseDevice();
+}
 
 /*!
     \brief Returns true if the buffer iterator has reached the end, or if there
     is no buffer at all; otherwise this function returns false
+
+    A stream reading an IODevice reads ahead from it when the buffer is empty,
+    to find out whether the device has any more data.
+
     \return returns true if at the end
 */
 bool ByteStream::atEnd() const {
-    if(!mArray || mIter == mArray->end()) {
-        return false;
-    } else {
+    if(writesToDevice()) {
         return true;
     }
+    const_cast<ByteStream*>(this)->checkArray();
+    if(mCur == mEnd && mDevice && !writesToDevice() && !mDeviceAtEnd) {
+        // Refilling doesn't change what is left to read, only where it's kept
+        const_cast<ByteStream*>(this)->fillBuffer(1);
+    }
+    return mCur == mEnd;
 }
 
 /*!
     \brief Returns a pointer to the array, if there is no array returns nullptr
+
+    Streams over a ByteView have no array, and return nullptr as well.
+
     \return returns pointer to the attached array
 */
 ByteArray*ByteStream::device() const {
@@ -79,6 +129,14 @@ ByteArray*ByteStream::device() const {
     }
 }
 
+/*!
+    \brief Returns the IODevice of the stream, nullptr if it isn't using one
+    \return returns pointer to the attached IODevice
+*/
+IODevice* ByteStream::ioDevice() const {
+    return mDevice;
+}
+
 /*!
     \brief Returns the open mode of the ByteStream
     \return the open mode of the byte stream
@@ -92,8 +150,13 @@ ByteStream::OpenMode ByteStream::mode() const {
     \param array the array to set to
 */
 void ByteStream::setDevice(ByteArray* array) {
+    releaseDevice();
     mArray = array;
-    mIter = mArray->begin();
+    if(mArray) {
+        syncWithArray(mMode == OpenMode::Append ? static_cast<uint64_t>(mArray->size()) : 0);
+    } else {
+        mBegin = mCur = mEnd = nullptr;
+    }
     resetStatus();
 }
 
@@ -103,8 +166,95 @@ void ByteStream::setDevice(ByteArray* array) {
     \param mode the open mode for the device
 */
 void ByteStream::setDevice(ByteArray* array, ByteStream::OpenMode mode) {
+    releaseDevice();
+    mMode = mode;
     this->setDevice(array);
+}
+
+/*!
+    \brief Sets the device to memory the stream does not own, in ReadOnly mode
+    \param view the bytes to read from
+*/
+void ByteStream::setDevice(const ByteView& view) {
+    releaseDevice();
+    mArray = nullptr;
+    mMode = OpenMode::ReadOnly;
+    // The stream never writes in ReadOnly mode, so dropping const is safe
+    mBegin = const_cast<char*>(view.data());
+    mCur = mBegin;
+    mEnd = mBegin + view.size();
+    resetStatus();
+}
+
+/*!
+    \brief Sets the device to a memory mapped file
+
+    A mapping can't grow, so Append mode starts at the end and fails like
+    WriteOnly. A read only mapping always opens the stream ReadOnly.
+
+    \param array the mapping to operate on
+    \param mode the open mode for the device
+*/
+void ByteStream::setDevice(MappedByteArray* array, ByteStream::OpenMode mode) {
+    if(array->mode() == MappedByteArray::Mode::ReadOnly) {
+        setDevice(array->view());
+        return;
+    }
+
+    releaseDevice();
+    mArray = nullptr;
     mMode = mode;
+    mBegin = array->data();
+    mEnd = mBegin + array->size();
+    mCur = mode == OpenMode::Append ? mEnd : mBegin;
+    resetStatus();
+}
+
+/*!
+    \brief Sets the device to an IODevice, which the stream reads or writes
+    through a buffer of bufferSize bytes
+
+    In ReadOnly mode the buffer is refilled from the device as it is read,
+    in every other mode the buffer is written to the device when it fills up,
+    on flush(), and when the stream is destroyed or set to another device.
+    Reads and writes larger than the buffer go straight to the device.
+
+    A stream writing to a device can't read, so ReadWrite opens it WriteOnly
+    and reads fail with ReadWritePastEnd.
+
+    \param device the device to operate on
+    \param mode ReadOnly to read from the device, otherwise writes to it
+    \param bufferSize the size of the buffer
+*/
+void ByteStream::setDevice(IODevice* device, ByteStream::OpenMode mode, std::size_t bufferSize) {
+    releaseDevice();
+    mArray = nullptr;
+    mMode = mode == OpenMode::ReadWrite ? OpenMode::WriteOnly : mode;
+    mDevice = device;
+    mDeviceAtEnd = false;
+    if(!mBuffer || mBufferSize != bufferSize) {
+        mBuffer.reset(new char[std::max<std::size_t>(bufferSize, 1)]);
+        mBufferSize = std::max<std::size_t>(bufferSize, 1);
+    }
+
+    mBegin = mBuffer.get();
+    mCur = mBegin;
+    mEnd = writesToDevice() ? mBegin + mBufferSize : mBegin;
+    resetStatus();
+}
+
+/*!
+    \brief Writes any buffered data to the IODevice and flushes the device
+
+    Does nothing for other devices.
+
+    \return true if the data was written, otherwise false
+*/
+bool ByteStream::flush() {
+    if(!writesToDevice()) {
+        return true;
+    }
+    return flushBuffer() && mDevice->flush();
 }
 
 /*!
@@ -143,6 +293,46 @@ ByteStream::ByteOrder ByteStream::order() const {
 */
 void ByteStream::setByteOrder(ByteStream::ByteOrder bo) {
     mOrder = bo;
+    mSwap = bo != hostByteOrder();
+}
+
+/*!
+    \brief Returns how the integer operators encode values
+    \return the integer encoding of the stream
+*/
+ByteStream::IntegerEncoding ByteStream::integerEncoding() const {
+    return mEncoding;
+}
+
+/*!
+    \brief Sets how the integer operators encode 16, 32 and 64 bit values
+
+    8 bit values are always written as a single byte.
+
+    \param encoding the integer encoding to use
+*/
+void ByteStream::setIntegerEncoding(ByteStream::IntegerEncoding encoding) {
+    mEncoding = encoding;
+}
+
+/*!
+    \brief Returns the longest string the stream reads
+    \return the most bytes a string may have
+*/
+uint32_t ByteStream::maxStringLength() const {
+    return mMaxStringLength;
+}
+
+/*!
+    \brief Sets the longest string the stream reads
+
+    A longer length prefix is treated as corrupt data, so a bad prefix can't
+    make a stream reading an IODevice grow its buffer to hold it.
+
+    \param length the most bytes a string may have
+*/
+void ByteStream::setMaxStringLength(uint32_t length) {
+    mMaxStringLength = length;
 }
 
 /*!
@@ -152,6 +342,7 @@ void ByteStream::setByteOrder(ByteStream::ByteOrder bo) {
     Ok - Status is ok
     ReadPastEnd - ByteStream tried to read past the buffer
     WriteFailed - Write to the buffer failed
+    ReadCorruptData - ByteStream read a malformed or out of range value
 
     \return returns thr status of the byte stream
 */
@@ -174,14 +365,62 @@ void ByteStream::resetStatus() {
     mStatus = Status::Ok;
 }
 
+/*!
+    \brief Returns what the stream has done since it was constructed or the
+    counters were reset
+
+    The counters carry on across setDevice(). Without instrumentation, see
+    instrumentation.hpp, they are all 0.
+
+    \return a copy of the counters of the stream
+*/
+StreamCounters ByteStream::counters() const {
+#if SERIAL_ENABLE_INSTRUMENTATION
+    return mCounters;
+#else
+    return StreamCounters();
+#endif
+}
+
+/*!
+    \brief Sets the counters of the stream back to 0, the global counters are kept
+*/
+void ByteStream::resetCounters() {
+#if SERIAL_ENABLE_INSTRUMENTATION
+    mCounters = StreamCounters();
+#endif
+}
+
 /*!
     \brief Function to skip length number of bytes
     \param length the length of bytes to skip over
     \return returns the length of bytes skipped
 */
 uint32_t ByteStream::skipRawData(uint32_t length) {
+    OperationCounter counted(*this, StreamOperation::RawData, StreamDirection::Read);
+    checkArray();
+    if(writesToDevice()) {
+        failPastEnd();
+        return 0;
+    }
+    if(mDevice) {
+        uint64_t remaining = length;
+        while(remaining > 0 && mStatus == Status::Ok) {
+            if(mCur == mEnd && !fillBuffer(1)) {
+                failPastEnd();
+                return 0;
+            }
+            const uint64_t skipped = std::min(remaining, static_cast<uint64_t>(mEnd - mCur));
+            mCur += skipped;
+            remaining -= skipped;
+            countBytesRead(skipped);
+        }
+        return mStatus == Status::Ok ? length : 0;
+    }
+
     if(moveWillStayInBounds(length)) {
-        mIter += length;
+        mCur += length;
+        countBytesRead(length);
         return length;
     } else {
         return 0;
@@ -194,13 +433,12 @@ uint32_t ByteStream::skipRawData(uint32_t length) {
     \param len the number of bytes to write
  */
 void ByteStream::writeBytes(const char* s, uint64_t len) {
+    OperationCounter counted(*this, StreamOperation::RawData, StreamDirection::Write);
     if(!s || mode() == OpenMode::ReadOnly || status() != Status::Ok) {
         return;
     }
 
-    if(moveWillStayInBounds(len)) {
-        std::copy(s, s+len, mIter);
-    }
+    writeData(s, len);
 }
 
 /*!
@@ -210,11 +448,10 @@ void ByteStream::writeBytes(const char* s, uint64_t len) {
     \return returns the number of bytes read in
 */
 int ByteStream::writeRawData(const char* s, uint32_t len) {
+    OperationCounter counted(*this, StreamOperation::RawData, StreamDirection::Write);
     if(!s || mode() == OpenMode::ReadOnly || status() != Status::Ok) {
         return -1;
-    } else if(moveWillStayInBounds(len)) {
-        std::copy(s,s+len, mIter);
-        mIter += len;
+    } else if(writeData(s, len)) {
         return static_cast<int>(len);
     } else {
         return -1;
@@ -228,17 +465,403 @@ int ByteStream::writeRawData(const char* s, uint32_t len) {
     \return returns the number of bytes read
  */
 int ByteStream::readRawData(char *s, uint32_t len) {
-    if(!s || mode() == OpenMode::WriteOnly || status() != Status::Ok) {
+    OperationCounter counted(*this, StreamOperation::RawData, StreamDirection::Read);
+    if(!s || isWriteOnly() || status() != Status::Ok) {
         return -1;
-    } else if(moveWillStayInBounds(len)) {
-        std::copy(mIter, mIter + len, s);
-        mIter += len;
+    } else if(readData(s, len)) {
         return static_cast<int>(len);
     } else {
         return -1;
     }
 }
 
+/*!
+    \brief Starts a section of the stream covered by a CRC32C checksum
+
+    Every byte read or written from here on is added to the checksum until
+    writeChecksum() or verifyChecksum(), which start the next section right
+    after the trailer. Checksumming costs nothing until it is begun, and
+    afterwards the bytes are checksummed a buffer at a time rather than per
+    value.
+*/
+void ByteStream::beginChecksum() {
+    checkArray();
+    mChecksumming = true;
+    mChecksum = 0;
+    mChecksumStart = static_cast<uint64_t>(mCur - mBegin);
+}
+
+/*!
+    \brief Writes the checksum of the section as a 4 byte little endian trailer
+
+    The checksum covers the bytes written since beginChecksum() or the last
+    trailer, and a new section starts after this trailer.
+*/
+void ByteStream::writeChecksum() {
+    assert(!isReadOnly());
+    assert(mChecksumming && "writeChecksum() needs a beginChecksum() first");
+
+    updateChecksum();
+    const uint32_t checksum = SERIAL_HOST_BIG_ENDIAN ? byteSwap32(mChecksum) : mChecksum;
+    char trailer[sizeof(checksum)];
+    std::memcpy(trailer, &checksum, sizeof(checksum));
+
+    mChecksumming = false;
+    writeData(trailer, sizeof(trailer));
+    beginChecksum();
+}
+
+/*!
+    \brief Reads a checksum trailer and compares it to the bytes of the section
+
+    The status is set to ReadCorruptData if the checksum doesn't match. The
+    values read from the section should be discarded then. A new section starts
+    after this trailer.
+
+    \return true if the checksum matched, otherwise false
+*/
+bool ByteStream::verifyChecksum() {
+    assert(!isWriteOnly());
+    assert(mChecksumming && "verifyChecksum() needs a beginChecksum() first");
+
+    updateChecksum();
+    const uint32_t expected = mChecksum;
+    char trailer[sizeof(expected)];
+
+    mChecksumming = false;
+    const bool read = readData(trailer, sizeof(trailer));
+    beginChecksum();
+    if(!read || mStatus != Status::Ok) {
+        return false;
+    }
+
+    uint32_t checksum;
+    std::memcpy(&checksum, trailer, sizeof(checksum));
+    if(SERIAL_HOST_BIG_ENDIAN) {
+        checksum = byteSwap32(checksum);
+    }
+    if(checksum != expected) {
+        mStatus = Status::ReadCorruptData;
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \brief Writes value as a LEB128 varint, whatever the integer encoding
+    \param value the value to write
+*/
+void ByteStream::writeVarint(uint64_t value) {
+    assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Varint, StreamDirection::Write);
+
+    checkArray();
+    if(static_cast<std::size_t>(mEnd - mCur) >= MaxVarintLength &&
+       mStatus == Status::Ok && !isReadOnly()) {
+        const int length = encodeVarint(value, mCur);
+        mCur += length;
+        countBytesWritten(static_cast<uint64_t>(length));
+    } else {
+        char buffer[MaxVarintLength];
+        writeData(buffer, static_cast<uint64_t>(encodeVarint(value, buffer)));
+    }
+}
+
+/*!
+    \brief Reads a LEB128 varint, whatever the integer encoding
+
+    Sets the status to ReadCorruptData if the varint is malformed.
+
+    \param value the value to read into
+*/
+void ByteStream::readVarint(uint64_t &value) {
+    assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Varint, StreamDirection::Read);
+
+    checkArray();
+    if(mStatus != Status::Ok || (!mArray && !mBegin)) {
+        return;
+    }
+    if(writesToDevice()) {
+        failPastEnd();
+        return;
+    }
+
+    int length = decodeVarint(mCur, mEnd, value);
+    if(length == 0 && mDevice) {
+        fillBuffer(MaxVarintLength);
+        length = decodeVarint(mCur, mEnd, value);
+    }
+
+    if(length > 0) {
+        mCur += length;
+        countBytesRead(static_cast<uint64_t>(length));
+    } else if(length == 0) {
+        failPastEnd();
+    } else {
+        mStatus = Status::ReadCorruptData;
+    }
+}
+
+/*!
+    \brief Writes len bytes of s prefixed with their length as a varint
+
+    The length is always a varint, whatever the integer encoding.
+
+    \param s the bytes of the string
+    \param len the number of bytes
+*/
+void ByteStream::writeString(const char* s, std::size_t len) {
+    assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::String, StreamDirection::Write);
+
+    writeVarint(len);
+    if(len > 0) {
+        writeBytes(s, len);
+    }
+}
+
+/*!
+    \brief Reads a string written by writeString() without copying it
+
+    view refers straight into the device of the stream, so it stays valid as
+    long as the ByteArray, ByteView or mapping being read does, and isn't
+    modified. Reading an IODevice it points into the stream buffer, and is
+    only valid until the next read. view is left untouched if the read fails.
+    A length over maxStringLength() sets the status to ReadCorruptData.
+
+    \param view set to the bytes of the string
+*/
+void ByteStream::readStringView(ByteView& view) {
+    assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::String, StreamDirection::Read);
+
+    uint64_t len = 0;
+    readVarint(len);
+    if(mStatus != Status::Ok) {
+        return;
+    }
+
+    // Reject lengths which can't be right before a device buffer grows to them
+    if(len > mMaxStringLength) {
+        mStatus = Status::ReadCorruptData;
+        return;
+    }
+
+    const char* data = claimRead(len);
+    if(data) {
+        view = ByteView(data, static_cast<std::size_t>(len));
+    }
+}
+
+/*!
+    \brief Reads a string written by writeString() into s
+
+    s is left untouched if the read fails.
+
+    \param s the string to read into
+*/
+void ByteStream::readString(std::string& s) {
+    OperationCounter counted(*this, StreamOperation::String, StreamDirection::Read);
+    ByteView view;
+    readStringView(view);
+    if(mStatus == Status::Ok) {
+        s.assign(view.data(), view.size());
+    }
+}
+
+/*!
+    \brief Writes value as a ZigZag varint, whatever the integer encoding
+    \param value the value to write
+*/
+void ByteStream::writeZigZagVarint(int64_t value) {
+    OperationCounter counted(*this, StreamOperation::Varint, StreamDirection::Write);
+    writeVarint(zigZagEncode(value));
+}
+
+/*!
+    \brief Reads a ZigZag varint, whatever the integer encoding
+    \param value the value to read into
+*/
+void ByteStream::readZigZagVarint(int64_t &value) {
+    OperationCounter counted(*this, StreamOperation::Varint, StreamDirection::Read);
+    uint64_t encoded = 0;
+    readVarint(encoded);
+    if(mStatus == Status::Ok) {
+        value = zigZagDecode(encoded);
+    }
+}
+
+/*!
+    \brief Writes count values as consecutive LEB128 varints
+    \param values the values to write
+    \param count the number of values
+*/
+void ByteStream::writeVarints(const uint64_t *values, std::size_t count) {
+    OperationCounter counted(*this, StreamOperation::Varint, StreamDirection::Write);
+    for(std::size_t i = 0; i < count && mStatus == Status::Ok; i++) {
+        writeVarint(values[i]);
+    }
+}
+
+/*!
+    \brief Reads count consecutive LEB128 varints with the bulk decoder
+
+    Nothing is consumed if any of the varints is truncated or malformed,
+    except when reading an IODevice, where the values before it are consumed.
+
+    \param values where to store the values
+    \param count the number of values
+*/
+void ByteStream::readVarints(uint64_t *values, std::size_t count) {
+    assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Varint, StreamDirection::Read);
+
+    checkArray();
+    if(mStatus != Status::Ok || (!mArray && !mBegin)) {
+        return;
+    }
+    if(writesToDevice()) {
+        failPastEnd();
+        return;
+    }
+
+    std::size_t decoded = 0;
+    while(true) {
+        const char *cursor = mCur;
+        decoded += decodeVarints(cursor, mEnd, values + decoded, count - decoded);
+        if(decoded == count) {
+            countBytesRead(static_cast<uint64_t>(cursor - mCur));
+            mCur = const_cast<char*>(cursor);
+            return;
+        }
+
+        uint64_t unused;
+        const int length = decodeVarint(cursor, mEnd, unused);
+        if(length == 0 && mDevice) {
+            // Keep what was decoded and refill, as long as that makes progress
+            countBytesRead(static_cast<uint64_t>(cursor - mCur));
+            mCur = const_cast<char*>(cursor);
+            const std::ptrdiff_t available = mEnd - mCur;
+            if(fillBuffer(MaxVarintLength) || mEnd - mCur > available) {
+                continue;
+            }
+        }
+
+        if(length == 0) {
+            failPastEnd();
+        } else {
+            mStatus = Status::ReadCorruptData;
+        }
+        return;
+    }
+}
+
+/*!
+    \brief Reads an unsigned varint into value, checking it fits in T
+    \param value the value to read into
+*/
+template<typename T>
+void ByteStream::readUnsignedVarint(T &value) {
+    uint64_t decoded = 0;
+    readVarint(decoded);
+    if(mStatus != Status::Ok) {
+        return;
+    }
+
+    if(decoded > std::numeric_limits<T>::max()) {
+        mStatus = Status::ReadCorruptData;
+    } else {
+        value = static_cast<T>(decoded);
+    }
+}
+
+/*!
+    \brief Reads a ZigZag varint into value, checking it fits in T
+    \param value the value to read into
+*/
+template<typename T>
+void ByteStream::readSignedVarint(T &value) {
+    int64_t decoded = 0;
+    readZigZagVarint(decoded);
+    if(mStatus != Status::Ok) {
+        return;
+    }
+
+    if(decoded > std::numeric_limits<T>::max() || decoded < std::numeric_limits<T>::min()) {
+        mStatus = Status::ReadCorruptData;
+    } else {
+        value = static_cast<T>(decoded);
+    }
+}
+
+/*!
+    \brief Copies count values of width bytes into the device in stream order
+    \param data the values to write
+    \param count the number of values
+    \param width the size of each value
+*/
+void ByteStream::writeArrayData(const char* data, std::size_t count, std::size_t width) {
+    assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Array, StreamDirection::Write);
+
+    if(count > std::numeric_limits<uint64_t>::max() / width) {
+        mStatus = Status::WriteFailed;
+        return;
+    }
+
+    // An IODevice is written a buffer at a time, anything else all at once
+    const std::size_t chunk = mDevice ? std::max<std::size_t>(mBufferSize / width, 1) : count;
+    while(count > 0) {
+        const std::size_t values = std::min(count, chunk);
+        char* destination = claimWrite(values * width);
+        if(!destination) {
+            return;
+        }
+
+        if(mSwap) {
+            swapBytesCopy(destination, data, values, width);
+        } else {
+            std::memcpy(destination, data, values * width);
+        }
+        data += values * width;
+        count -= values;
+    }
+}
+
+/*!
+    \brief Copies count values of width bytes from the device in host order
+    \param data where to store the values
+    \param count the number of values
+    \param width the size of each value
+*/
+void ByteStream::readArrayData(char* data, std::size_t count, std::size_t width) {
+    assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Array, StreamDirection::Read);
+
+    if(count > std::numeric_limits<uint64_t>::max() / width) {
+        failPastEnd();
+        return;
+    }
+
+    const std::size_t chunk = mDevice ? std::max<std::size_t>(mBufferSize / width, 1) : count;
+    while(count > 0) {
+        const std::size_t values = std::min(count, chunk);
+        const char* source = claimRead(values * width);
+        if(!source) {
+            return;
+        }
+
+        if(mSwap) {
+            swapBytesCopy(data, source, values, width);
+        } else {
+            std::memcpy(data, source, values * width);
+        }
+        data += values * width;
+        count -= values;
+    }
+}
+
 /*!
     \brief Operator to write a uint8_t into the device
     \param i the values to write into
@@ -246,10 +869,8 @@ int ByteStream::readRawData(char *s, uint32_t len) {
 void ByteStream::operator<<(uint8_t i) {
     assert(!isReadOnly());
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
-    }
+    // Single bytes have no byte order
+    put<false>(i);
 }
 
 /*!
@@ -258,10 +879,14 @@ void ByteStream::operator<<(uint8_t i) {
 */
 void ByteStream::operator<<(uint16_t i) {
     assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Write);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        writeVarint(i);
+    } else if(mSwap) {
+        put<true>(i);
+    } else {
+        put<false>(i);
     }
 }
 
@@ -271,10 +896,14 @@ void ByteStream::operator<<(uint16_t i) {
 */
 void ByteStream::operator<<(uint32_t i) {
     assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Write);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        writeVarint(i);
+    } else if(mSwap) {
+        put<true>(i);
+    } else {
+        put<false>(i);
     }
 }
 
@@ -284,10 +913,14 @@ void ByteStream::operator<<(uint32_t i) {
 */
 void ByteStream::operator<<(uint64_t i) {
     assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Write);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        writeVarint(i);
+    } else if(mSwap) {
+        put<true>(i);
+    } else {
+        put<false>(i);
     }
 }
 
@@ -298,10 +931,8 @@ void ByteStream::operator<<(uint64_t i) {
 void ByteStream::operator<<(int8_t i) {
     assert(!isReadOnly());
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
-    }
+    // Single bytes have no byte order
+    put<false>(i);
 }
 
 /*!
@@ -310,10 +941,14 @@ void ByteStream::operator<<(int8_t i) {
 */
 void ByteStream::operator<<(int16_t i) {
     assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Write);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        writeZigZagVarint(i);
+    } else if(mSwap) {
+        put<true>(i);
+    } else {
+        put<false>(i);
     }
 }
 
@@ -323,10 +958,14 @@ void ByteStream::operator<<(int16_t i) {
 */
 void ByteStream::operator<<(int32_t i) {
     assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Write);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        writeZigZagVarint(i);
+    } else if(mSwap) {
+        put<true>(i);
+    } else {
+        put<false>(i);
     }
 }
 
@@ -336,10 +975,14 @@ void ByteStream::operator<<(int32_t i) {
 */
 void ByteStream::operator<<(int64_t i) {
     assert(!isReadOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Write);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(&i, &i+sizeof(i), mIter);
-        mIter += sizeof(i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        writeZigZagVarint(i);
+    } else if(mSwap) {
+        put<true>(i);
+    } else {
+        put<false>(i);
     }
 }
 
@@ -350,20 +993,37 @@ void ByteStream::operator<<(int64_t i) {
 void ByteStream::operator<<(bool b) {
     assert(!isReadOnly());
 
-    if(moveWillStayInBounds(sizeof(b))) {
-        std::copy(&b, &b+sizeof(b), mIter);
-        mIter += sizeof(b);
-    }
+    // Single bytes have no byte order
+    put<false>(b);
 }
 
 /*!
-    \brief Operator to write a char* which is null ended into the device
-    \param The buffer to write in
+    \brief Operator to write a null terminated string into the device
+
+    The string is written by writeString(), without its terminator.
+
+    \param s the string to write
 */
 void ByteStream::operator<<(const char*& s) {
     assert(!isReadOnly());
 
-    writeBytes(s, strlen(s));
+    writeString(s, s ? strlen(s) : 0);
+}
+
+/*!
+    \brief Operator to write a string into the device, see writeString()
+    \param s the string to write
+*/
+void ByteStream::operator<<(const std::string& s) {
+    writeString(s.data(), s.size());
+}
+
+/*!
+    \brief Operator to write a view as a string, see writeString()
+    \param view the bytes to write
+*/
+void ByteStream::operator<<(const ByteView& view) {
+    writeString(view.data(), view.size());
 }
 
 /*!
@@ -373,9 +1033,10 @@ void ByteStream::operator<<(const char*& s) {
 void ByteStream::operator<<(float f) {
     assert(!isReadOnly());
 
-    if(moveWillStayInBounds(sizeof(int32_t))) {
-        std::copy(&f, &f+sizeof(f), mIter);
-        mIter += sizeof(f);
+    if(mSwap) {
+        put<true>(f);
+    } else {
+        put<false>(f);
     }
 }
 
@@ -386,9 +1047,10 @@ void ByteStream::operator<<(float f) {
 void ByteStream::operator<<(double d) {
     assert(!isReadOnly());
 
-    if(moveWillStayInBounds(sizeof(int64_t))) {
-        std::copy(&d, &d+sizeof(d), mIter);
-        mIter += sizeof(d);
+    if(mSwap) {
+        put<true>(d);
+    } else {
+        put<false>(d);
     }
 }
 
@@ -399,9 +1061,8 @@ void ByteStream::operator<<(double d) {
 void ByteStream::operator>>(uint8_t& i) {
     assert(!isWriteOnly());
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
-    }
+    // Single bytes have no byte order
+    get<false>(i);
 }
 
 /*!
@@ -410,9 +1071,14 @@ void ByteStream::operator>>(uint8_t& i) {
 */
 void ByteStream::operator>>(uint16_t &i) {
     assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Read);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        readUnsignedVarint(i);
+    } else if(mSwap) {
+        get<true>(i);
+    } else {
+        get<false>(i);
     }
 }
 
@@ -422,9 +1088,14 @@ void ByteStream::operator>>(uint16_t &i) {
 */
 void ByteStream::operator>>(uint32_t &i) {
     assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Read);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        readUnsignedVarint(i);
+    } else if(mSwap) {
+        get<true>(i);
+    } else {
+        get<false>(i);
     }
 }
 
@@ -434,9 +1105,14 @@ void ByteStream::operator>>(uint32_t &i) {
 */
 void ByteStream::operator>>(uint64_t &i) {
     assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Read);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        readUnsignedVarint(i);
+    } else if(mSwap) {
+        get<true>(i);
+    } else {
+        get<false>(i);
     }
 }
 
@@ -447,9 +1123,8 @@ void ByteStream::operator>>(uint64_t &i) {
 void ByteStream::operator>>(int8_t &i) {
     assert(!isWriteOnly());
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
-    }
+    // Single bytes have no byte order
+    get<false>(i);
 }
 
 /*!
@@ -458,9 +1133,14 @@ void ByteStream::operator>>(int8_t &i) {
 */
 void ByteStream::operator>>(int16_t &i) {
     assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Read);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        readSignedVarint(i);
+    } else if(mSwap) {
+        get<true>(i);
+    } else {
+        get<false>(i);
     }
 }
 
@@ -470,9 +1150,14 @@ void ByteStream::operator>>(int16_t &i) {
 */
 void ByteStream::operator>>(int32_t &i) {
     assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Read);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        readSignedVarint(i);
+    } else if(mSwap) {
+        get<true>(i);
+    } else {
+        get<false>(i);
     }
 }
 
@@ -482,63 +1167,388 @@ void ByteStream::operator>>(int32_t &i) {
 */
 void ByteStream::operator>>(int64_t &i) {
     assert(!isWriteOnly());
+    OperationCounter counted(*this, StreamOperation::Integer, StreamDirection::Read);
 
-    if(moveWillStayInBounds(sizeof(i))) {
-        std::copy(mIter, mIter+sizeof(i), &i);
+    if(mEncoding == IntegerEncoding::Varint) {
+        readSignedVarint(i);
+    } else if(mSwap) {
+        get<true>(i);
+    } else {
+        get<false>(i);
     }
 }
 
 void ByteStream::operator>>(bool &b) {
     assert(!isWriteOnly());
 
-    if(moveWillStayInBounds(sizeof(bool))) {
-        std::copy(mIter, mIter+sizeof(bool), &b);
-    }
+    // Single bytes have no byte order
+    get<false>(b);
 }
 
+/*!
+    \brief Operator to read a string into a new null terminated buffer
+
+    The buffer is allocated with new[] and belongs to the caller, s is set to
+    nullptr if the read fails. Use readStringView() to avoid the allocation.
+
+    \param s set to the string
+*/
 void ByteStream::operator>>(const char *&s) {
+    ByteView view;
+    readStringView(view);
+    if(mStatus != Status::Ok) {
+        s = nullptr;
+        return;
+    }
+
+    char* copy = new char[view.size() + 1];
+    std::copy(view.begin(), view.end(), copy);
+    copy[view.size()] = '\0';
+    s = copy;
+}
+
+/*!
+    \brief Operator to read a string into s, see readString()
+    \param s the string to read into
+*/
+void ByteStream::operator>>(std::string& s) {
+    readString(s);
+}
 
+/*!
+    \brief Operator to read a string without copying it, see readStringView()
+    \param view set to the bytes of the string
+*/
+void ByteStream::operator>>(ByteView& view) {
+    readStringView(view);
 }
 
 void ByteStream::operator>>(float &f) {
     assert(!isWriteOnly());
 
-    if(moveWillStayInBounds(sizeof(int32_t))) {
-        std::copy(mIter, mIter+sizeof(int32_t), &f);
+    if(mSwap) {
+        get<true>(f);
+    } else {
+        get<false>(f);
     }
 }
 
 void ByteStream::operator>>(double &d) {
     assert(!isWriteOnly());
 
-    if(moveWillStayInBounds(sizeof(int64_t))) {
-        std::copy(mIter, mIter+sizeof(int64_t), &d);
+    if(mSwap) {
+        get<true>(d);
+    } else {
+        get<false>(d);
     }
 }
 
 /*!
-    \brief Checks to see if the iterator move will stay in bounds
-    \param move the moves to make with the iterator
-    \return true if it will stay in bounds, otherwise false
+    \brief Copies len bytes from s into the device and advances the stream
+    \param s the buffer to copy from
+    \param len the number of bytes to write
+    \return true if the bytes were written, otherwise false
 */
-bool ByteStream::moveWillStayInBounds(const uint64_t move) {
-    if(!mArray) {
+bool ByteStream::writeData(const char* s, uint64_t len) {
+    if(writesToDevice() && len >= mBufferSize && mStatus == Status::Ok) {
+        // Too big to be worth buffering, so write it directly
+        if(!flushBuffer() || mDevice->write(s, len) != static_cast<int64_t>(len)) {
+            mStatus = Status::WriteFailed;
+            return false;
+        }
+        if(mChecksumming) {
+            mChecksum = crc32c(s, len, mChecksum);
+        }
+        countBytesWritten(len);
+        return true;
+    }
+
+    char* destination = claimWrite(len);
+    if(destination) {
+        std::memcpy(destination, s, len);
+        return true;
+    }
+    return false;
+}
+
+/*!
+    \brief Copies len bytes from the device into s and advances the stream
+    \param s the buffer to copy into
+    \param len the number of bytes to read
+    \return true if the bytes were read, otherwise false
+*/
+bool ByteStream::readData(char* s, uint64_t len) {
+    if(mDevice && !writesToDevice() && len >= mBufferSize && mStatus == Status::Ok) {
+        // Too big to be worth buffering, so read the rest directly
+        const uint64_t buffered = static_cast<uint64_t>(mEnd - mCur);
+        std::memcpy(s, mCur, buffered);
+        mCur = mEnd;
+        if(mChecksumming) {
+            updateChecksum();
+        }
+
+        uint64_t filled = buffered;
+        while(filled < len) {
+            const int64_t result = mDevice->read(s + filled, len - filled);
+            if(result <= 0) {
+                mDeviceAtEnd = result == 0;
+                failPastEnd();
+                return false;
+            }
+            filled += static_cast<uint64_t>(result);
+        }
+        if(mChecksumming) {
+            mChecksum = crc32c(s + buffered, len - buffered, mChecksum);
+        }
+        countBytesRead(len);
+        return true;
+    }
+
+    const char* source = claimRead(len);
+    if(source) {
+        std::memcpy(s, source, len);
+        return true;
+    }
+    return false;
+}
+
+/*!
+    \brief Reserves len bytes at the cursor for writing and advances past them
+
+    In Append mode the device grows when the bytes don't fit, otherwise writing
+    past the end fails. Either way nothing is written when this fails.
+
+    \param len the number of bytes to reserve
+    \return where to write the bytes, nullptr on failure
+*/
+char* ByteStream::claimWrite(uint64_t len) {
+    checkArray();
+    if(isReadOnly()) {
+        mStatus = Status::WriteFailed;
+        return nullptr;
+    }
+
+    if(writesToDevice() && mStatus == Status::Ok &&
+       len > static_cast<uint64_t>(mEnd - mCur)) {
+        if(!flushBuffer()) {
+            return nullptr;
+        }
+        if(len > mBufferSize) {
+            growBuffer(static_cast<std::size_t>(len));
+        }
+        mCur += len;
+        countBytesWritten(len);
+        return mCur - len;
+    }
+
+    if(mMode == OpenMode::Append && mArray && mStatus == Status::Ok &&
+       len > static_cast<uint64_t>(mEnd - mCur)) {
+        const uint64_t pos = static_cast<uint64_t>(mCur - mBegin);
+        if(pos + len > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+            mStatus = Status::WriteFailed;
+            return nullptr;
+        }
+
+        mArray->extend(static_cast<int>(pos + len) - mArray->size());
+        syncWithArray(pos + len);
+        countBytesWritten(len);
+        return mCur - len;
+    }
+
+    if(moveWillStayInBounds(len)) {
+        char* destination = mCur;
+        mCur += len;
+        countBytesWritten(len);
+        return destination;
+    }
+    return nullptr;
+}
+
+/*!
+    \brief Reserves len bytes at the cursor for reading and advances past them
+    \param len the number of bytes to reserve
+    \return where to read the bytes from, nullptr on failure
+*/
+const char* ByteStream::claimRead(uint64_t len) {
+    checkArray();
+    if(writesToDevice()) {
+        // The buffer holds bytes waiting to be written, there is nothing to read
+        failPastEnd();
+        return nullptr;
+    }
+    if(mDevice && mStatus == Status::Ok && len > static_cast<uint64_t>(mEnd - mCur)) {
+        fillBuffer(len);
+    }
+
+    if(moveWillStayInBounds(len)) {
+        const char* source = mCur;
+        mCur += len;
+        countBytesRead(len);
+        return source;
+    }
+    return nullptr;
+}
+
+/*!
+    \brief Points the stream at the current storage of the array
+
+    Called whenever the array may have reallocated.
+
+    \param pos the offset of the next byte to read or write
+*/
+void ByteStream::syncWithArray(uint64_t pos) {
+    mBegin = mArray->begin();
+    mEnd = mArray->end();
+    mCur = mBegin + pos;
+}
+
+/*!
+    \brief Points the stream at the array again after it changed outside the
+    stream
+
+    A stream in Append mode carries on at the end of the array, any other
+    stream keeps its offset, or stops at the end if the array shrank below it.
+*/
+void ByteStream::resyncArray() {
+    const uint64_t size = static_cast<uint64_t>(mArray->size());
+    uint64_t pos = std::min(static_cast<uint64_t>(mCur - mBegin), size);
+    if(mMode == OpenMode::Append) {
+        pos = size;
+    }
+    mChecksumStart = std::min(mChecksumStart, pos);
+    syncWithArray(pos);
+}
+
+/*!
+    \brief Adds the bytes between mChecksumStart and the cursor to mChecksum
+
+    Called before the bytes behind the cursor are flushed or moved, and before
+    a trailer.
+*/
+void ByteStream::updateChecksum() {
+    checkArray();
+    const uint64_t position = static_cast<uint64_t>(mCur - mBegin);
+    if(position > mChecksumStart) {
+        mChecksum = crc32c(mBegin + mChecksumStart, position - mChecksumStart, mChecksum);
+    }
+    mChecksumStart = position;
+}
+
+/*!
+    \brief Flushes pending writes to the IODevice and detaches from it
+
+    A checksum section in progress is dropped.
+*/
+void ByteStream::releaseDevice() {
+    if(writesToDevice()) {
+        flushBuffer();
+    }
+    mDevice = nullptr;
+    mChecksumming = false;
+}
+
+/*!
+    \brief Writes the buffered bytes to the IODevice and empties the buffer
+    \return true if the bytes were written, otherwise false
+*/
+bool ByteStream::flushBuffer() {
+    if(mChecksumming) {
+        updateChecksum();
+    }
+
+    const uint64_t pending = static_cast<uint64_t>(mCur - mBegin);
+    if(pending > 0 && mDevice->write(mBegin, pending) != static_cast<int64_t>(pending)) {
+        mStatus = Status::WriteFailed;
         return false;
     }
 
+    mCur = mBegin;
+    mChecksumStart = 0;
+    return true;
+}
+
+/*!
+    \brief Reads from the IODevice until at least len bytes are buffered
+
+    The unread bytes are moved to the front of the buffer first, and the
+    buffer grows if it is smaller than len.
+
+    \param len the number of bytes wanted
+    \return true if len bytes are buffered, false if the device ran out
+*/
+bool ByteStream::fillBuffer(uint64_t len) {
+    if(mChecksumming) {
+        updateChecksum();
+    }
+
+    const std::size_t buffered = static_cast<std::size_t>(mEnd - mCur);
+    std::memmove(mBegin, mCur, buffered);
+    mCur = mBegin;
+    mChecksumStart = 0;
+    mEnd = mBegin + buffered;
+
+    if(len > mBufferSize) {
+        growBuffer(static_cast<std::size_t>(len));
+    }
+
+    while(static_cast<uint64_t>(mEnd - mCur) < len && !mDeviceAtEnd) {
+        const int64_t result = mDevice->read(mEnd, static_cast<uint64_t>(mBegin + mBufferSize - mEnd));
+        if(result <= 0) {
+            mDeviceAtEnd = true;
+            break;
+        }
+        mEnd += result;
+    }
+    return static_cast<uint64_t>(mEnd - mCur) >= len;
+}
 
-    if(move > std::numeric_limits<int64_t>::max()) {
+/*!
+    \brief Replaces the buffer with one of size bytes, keeping its contents
+    \param size the new size of the buffer
+*/
+void ByteStream::growBuffer(std::size_t size) {
+    std::unique_ptr<char[]> buffer(new char[size]);
+    std::memcpy(buffer.get(), mBegin, static_cast<std::size_t>(mEnd - mBegin));
+
+    mCur = buffer.get() + (mCur - mBegin);
+    mEnd = writesToDevice() ? buffer.get() + size : buffer.get() + (mEnd - mBegin);
+    mBegin = buffer.get();
+    mBuffer = std::move(buffer);
+    mBufferSize = size;
+}
+
+/*!
+    \brief Checks to see if the iterator move will stay in bounds
+    \param move the moves to make with the iterator
+    \return true if it will stay in bounds, otherwise false
+*/
+bool ByteStream::moveWillStayInBounds(const uint64_t move) {
+    if(!mArray && !mBegin) {
         return false;
     }
 
-    if(mIter + static_cast<int64_t>(move) <= mArray->end() && mStatus == Status::Ok) {
+    if(move <= static_cast<uint64_t>(mEnd - mCur) && mStatus == Status::Ok) {
         return true;
     } else {
-        mStatus = Status::ReadWritePastEnd;
+        failPastEnd();
         return false;
     }
 }
 
+/*!
+    \brief Sets the status to ReadWritePastEnd, counting a bounds failure if
+    the stream was Ok until now
+*/
+void ByteStream::failPastEnd() {
+#if SERIAL_ENABLE_INSTRUMENTATION
+    if(mStatus == Status::Ok) {
+        mCounters.boundsFailures++;
+        detail::addCounter(detail::BoundsFailuresCounter, 1);
+    }
+#endif
+    mStatus = Status::ReadWritePastEnd;
+}
+
 /*!
     \brief Function to return if the steam is read only of the Byte Stream
     \return true if read only, otherwise false
@@ -549,48 +1559,11 @@ bool ByteStream::isReadOnly() const {
 
 /*!
     \brief Function to return if the steam is write only of the Byte Stream
+
+    Append mode is write only as well.
+
     \return true if write only, otherwise false
 */
 bool ByteStream::isWriteOnly() const {
-    return mMode == OpenMode::WriteOnly;
-}
-
-template<typename T>
-T ByteStream::toBigEndian(T value) {
-    switch(sizeof(T)) {
-        case 1:
-
-        case 2:
-            #ifdef LINUX
-            return htobe16(value);
-            #endif
-        case 3:
-            #ifdef LINUX
-            return htobe32(value);
-            #endif
-        case 4:
-            #ifdef LINUX
-            return htobe64(value);
-            #endif
-    }
-}
-
-template<typename T>
-T ByteStream::toLitteEndian(T value){
-    switch(sizeof(T)) {
-        case 1:
-
-        case 2:
-            #ifdef LINUX
-            return htole16(value);
-            #endif
-        case 3:
-            #ifdef LINUX
-            return htole32(value);
-            #endif
-        case 4:
-            #ifdef LINUX
-            return htole64(value);
-            #endif
-    }
+    return mMode == OpenMode::WriteOnly || mMode == OpenMode::Append;
 }
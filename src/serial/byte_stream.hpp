@@ -6,18 +6,37 @@
 #ifndef BYTE_STREAM_HPP
 #define BYTE_STREAM_HPP
 
+#include <cassert>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
 #include "byte_array.hpp"
+#include "byte_order.hpp"
+#include "byte_view.hpp"
+#include "instrumentation.hpp"
+
+class IODevice;
+class MappedByteArray;
 
 /*!
     \brief Class to handle binary streams to and from ByteArrays
 */
 class ByteStream {
 public:
+    /*!
+        \brief The ways a stream may operate on its device
+
+        Append is a write only mode which starts at the end of the device and
+        grows it as data is written, rather than failing at the end.
+    */
     enum class OpenMode {
         ReadOnly,
         WriteOnly,
-        ReadWrite
+        ReadWrite,
+        Append
     };
 
     enum class ByteOrder {
@@ -25,36 +44,85 @@ public:
         LittleEndian
     };
 
+    /*!
+        \brief Returns the byte order of the machine the code runs on
+        \return the byte order of the host
+    */
+    static constexpr ByteOrder hostByteOrder() {
+        return SERIAL_HOST_BIG_ENDIAN ? ByteOrder::BigEndian : ByteOrder::LittleEndian;
+    }
+
+
+    /*!
+        \brief How the integer operators encode 16, 32 and 64 bit values
+
+        Fixed writes every value at its full width. Varint writes unsigned
+        values as LEB128 varints and signed values as ZigZag varints, so small
+        magnitudes take fewer bytes.
+    */
+    enum class IntegerEncoding {
+        Fixed,
+        Varint
+    };
 
     enum class Status {
         Ok,
         ReadWritePastEnd,
-        WriteFailed
+        WriteFailed,
+        ReadCorruptData
     };
 
+    class WriteBatch;
+    class ReadBatch;
+
     ByteStream();
     ByteStream(ByteArray *array, OpenMode mode);
+    explicit ByteStream(const ByteView &view);
+    ByteStream(MappedByteArray *array, OpenMode mode);
+    ByteStream(IODevice *device, OpenMode mode,
+               std::size_t bufferSize = DefaultBufferSize);
 
     ~ByteStream();
 
+    //! The size of the buffer used for an IODevice if none is given
+    static const std::size_t DefaultBufferSize = 64 * 1024;
+    //! The longest string a stream reads unless setMaxStringLength() is called
+    static const uint32_t DefaultMaxStringLength = 64 * 1024 * 1024;
+
     bool atEnd() const;
 
     ByteArray* device() const;
+    IODevice* ioDevice() const;
 
     OpenMode mode() const;
 
     void setDevice(ByteArray *array);
     void setDevice(ByteArray *array, OpenMode mode);
+    void setDevice(const ByteView &view);
+    void setDevice(MappedByteArray *array, OpenMode mode);
+    void setDevice(IODevice *device, OpenMode mode,
+                   std::size_t bufferSize = DefaultBufferSize);
+
+    bool flush();
 
     void read(char *&buffer, uint32_t &count);
 
     ByteOrder order() const;
     void setByteOrder(ByteOrder bo);
 
+    IntegerEncoding integerEncoding() const;
+    void setIntegerEncoding(IntegerEncoding encoding);
+
+    uint32_t maxStringLength() const;
+    void setMaxStringLength(uint32_t length);
+
     Status status() const;
     void setStatus(Status status);
     void resetStatus();
 
+    StreamCounters counters() const;
+    void resetCounters();
+
     uint32_t skipRawData(uint32_t length);
 
     void writeBytes(const char *s, uint64_t len);
@@ -62,6 +130,32 @@ public:
     int writeRawData(const char *s, uint32_t len);
     int readRawData(char *s, uint32_t len);
 
+    void writeVarint(uint64_t value);
+    void readVarint(uint64_t &value);
+    void writeZigZagVarint(int64_t value);
+    void readZigZagVarint(int64_t &value);
+
+    void writeVarints(const uint64_t *values, std::size_t count);
+    void readVarints(uint64_t *values, std::size_t count);
+
+    void writeString(const char *s, std::size_t len);
+    void readStringView(ByteView &view);
+    void readString(std::string &s);
+
+    void beginChecksum();
+    void writeChecksum();
+    bool verifyChecksum();
+
+    template<typename T>
+    void writeArray(const T *values, std::size_t count);
+    template<typename T>
+    void writeArray(const std::vector<T> &values);
+
+    template<typename T>
+    void readArray(T *values, std::size_t count);
+    template<typename T>
+    void readArray(std::vector<T> &values, std::size_t count);
+
     //write to the stream
     void operator<<(uint8_t i);
     void operator<<(uint16_t i);
@@ -75,6 +169,10 @@ public:
     void operator<<(bool b);
 
     void operator<<(const char *&s);
+    template<std::size_t N>
+    void operator<<(const char (&s)[N]);
+    void operator<<(const std::string &s);
+    void operator<<(const ByteView &view);
 
     void operator<<(float f);
     void operator<<(double d);
@@ -92,16 +190,42 @@ public:
     void operator>>(bool &b);
 
     void operator>>(const char *&s);
+    void operator>>(std::string &s);
+    void operator>>(ByteView &view);
 
     void operator>>(float &f);
     void operator>>(double &d);
 
+protected:
+    class OperationCounter;
+
+    template<bool Swap, typename T>
+    void put(T value);
+
+    template<bool Swap, typename T>
+    void get(T &value);
+
 private:
-    template<typename T>
-    T toBigEndian(T value);
+    bool writeData(const char *s, uint64_t len);
+    bool readData(char *s, uint64_t len);
+    char* claimWrite(uint64_t len);
+    const char* claimRead(uint64_t len);
+    void writeArrayData(const char *data, std::size_t count, std::size_t width);
+    void readArrayData(char *data, std::size_t count, std::size_t width);
 
     template<typename T>
-    T toLitteEndian(T value);
+    void readUnsignedVarint(T &value);
+    template<typename T>
+    void readSignedVarint(T &value);
+    void syncWithArray(uint64_t pos);
+    void checkArray();
+    void resyncArray();
+    void updateChecksum();
+    void releaseDevice();
+    bool writesToDevice() const;
+    bool flushBuffer();
+    bool fillBuffer(uint64_t len);
+    void growBuffer(std::size_t size);
 
     void checkOpenMode() const;
     bool moveWillStayInBounds(const uint64_t move);
@@ -109,12 +233,421 @@ private:
     bool isReadOnly() const;
     bool isWriteOnly() const;
 
+    template<typename T>
+    static constexpr StreamOperation operationOf();
+    void countBytesRead(uint64_t len);
+    void countBytesWritten(uint64_t len);
+    void failPastEnd();
+
     ByteArray *mArray;
     OpenMode mMode;
     ByteOrder mOrder;
+    bool mSwap; //!< true when mOrder differs from the host byte order
+    IntegerEncoding mEncoding;
+    uint32_t mMaxStringLength; //!< the longest string readStringView() accepts
     Status mStatus;
-    ByteArray::iterator mIter;
+    char *mBegin; //!< the first byte of the device
+    char *mCur; //!< the next byte to read or write
+    char *mEnd; //!< one past the last byte of the device
+    IODevice *mDevice; //!< the device mBuffer is read from or written to
+    std::unique_ptr<char[]> mBuffer; //!< the buffer for mDevice
+    std::size_t mBufferSize;
+    bool mDeviceAtEnd; //!< true once mDevice has no more data to read
+    bool mChecksumming; //!< true between beginChecksum() and the trailer
+    uint32_t mChecksum; //!< the CRC32C of the covered bytes before mChecksumStart
+    uint64_t mChecksumStart; //!< offset from mBegin of the bytes not in mChecksum yet
+#if SERIAL_ENABLE_INSTRUMENTATION
+    StreamCounters mCounters; //!< what the stream has done, see counters()
+    int mOperationDepth; //!< the counted operations in progress
+#endif
 
 
 };
+
+/*!
+    \brief Counts an operation of a stream for as long as it is in scope
+
+    Only the outermost operation counts, so writeString() counts as a String
+    and not also as the Varint of its length. Without instrumentation this
+    does nothing.
+*/
+class ByteStream::OperationCounter {
+public:
+#if SERIAL_ENABLE_INSTRUMENTATION
+    OperationCounter(ByteStream &stream, StreamOperation operation, StreamDirection direction) :
+    mStream(stream){
+        if(mStream.mOperationDepth++ == 0) {
+            const int index = static_cast<int>(operation);
+            if(direction == StreamDirection::Read) {
+                mStream.mCounters.reads[index]++;
+                detail::addCounter(detail::ReadOperationsCounter + index, 1);
+            } else {
+                mStream.mCounters.writes[index]++;
+                detail::addCounter(detail::WriteOperationsCounter + index, 1);
+            }
+        }
+    }
+
+    ~OperationCounter() {
+        mStream.mOperationDepth--;
+    }
+#else
+    OperationCounter(ByteStream &, StreamOperation, StreamDirection) {
+    }
+#endif
+
+    OperationCounter(const OperationCounter &other) = delete;
+    OperationCounter& operator=(const OperationCounter &other) = delete;
+
+#if SERIAL_ENABLE_INSTRUMENTATION
+private:
+    ByteStream &mStream; //!< the stream the operation is on
+#endif
+};
+
+/*!
+    \brief Writes a run of fixed size fields with a single bounds check
+
+    The constructor reserves the whole size of the fields in the stream at
+    once, growing an Append stream or flushing an IODevice as needed. If the
+    space can't be reserved nothing is written, the status of the stream is
+    set and the batch converts to false. Otherwise every put() is an unchecked
+    store in the byte order of the stream.
+
+    Integers are always written at their full width, whatever the integer
+    encoding of the stream. The fields must add up to exactly the reserved
+    size, and the stream must not be used until the batch is destroyed.
+
+    \code
+    ByteStream::WriteBatch batch(stream, 7);
+    if(batch) {
+        batch.put(id);        // uint32_t
+        batch.put(flags);     // uint16_t
+        batch.put(kind);      // uint8_t
+    }
+    \endcode
+*/
+class ByteStream::WriteBatch {
+public:
+    WriteBatch(ByteStream &stream, std::size_t size) :
+    mCur(stream.claimWrite(size)),
+    mEnd(mCur ? mCur + size : nullptr),
+    mSwap(stream.mSwap){
+        OperationCounter counted(stream, StreamOperation::Batch, StreamDirection::Write);
+    }
+
+    WriteBatch(const WriteBatch &other) = delete;
+    WriteBatch& operator=(const WriteBatch &other) = delete;
+
+    ~WriteBatch() {
+        assert(mCur == mEnd && "a WriteBatch must fill all of the bytes it reserves");
+    }
+
+    /*!
+        \brief Returns true if the bytes were reserved
+    */
+    explicit operator bool() const {
+        return mCur != nullptr;
+    }
+
+    /*!
+        \brief Returns the number of reserved bytes not written yet
+    */
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(mEnd - mCur);
+    }
+
+    /*!
+        \brief Writes an arithmetic value without checking for space
+        \param value the value to write
+    */
+    template<typename T>
+    void put(T value) {
+        assert(sizeof(T) <= remaining());
+        if(mSwap) {
+            value = swapBytes(value);
+        }
+        std::memcpy(mCur, &value, sizeof(T));
+        mCur += sizeof(T);
+    }
+
+    /*!
+        \brief Writes len raw bytes without checking for space
+        \param data the bytes to write
+        \param len the number of bytes
+    */
+    void putBytes(const char *data, std::size_t len) {
+        assert(len <= remaining());
+        std::memcpy(mCur, data, len);
+        mCur += len;
+    }
+
+private:
+    char *mCur; //!< the next byte to write, nullptr if the reservation failed
+    char *mEnd; //!< one past the last reserved byte
+    bool mSwap; //!< true if values are byte swapped
+};
+
+/*!
+    \brief Reads a run of fixed size fields with a single bounds check
+
+    The constructor checks that the stream holds the whole size of the fields
+    at once, refilling from an IODevice as needed. If it doesn't nothing is
+    consumed, the status of the stream is set and the batch converts to false.
+    Otherwise every get() is an unchecked load in the byte order of the stream.
+
+    Integers are always read at their full width, whatever the integer encoding
+    of the stream. The stream must not be used until the batch is destroyed.
+*/
+class ByteStream::ReadBatch {
+public:
+    ReadBatch(ByteStream &stream, std::size_t size) :
+    mCur(stream.claimRead(size)),
+    mEnd(mCur ? mCur + size : nullptr),
+    mSwap(stream.mSwap){
+        OperationCounter counted(stream, StreamOperation::Batch, StreamDirection::Read);
+    }
+
+    ReadBatch(const ReadBatch &other) = delete;
+    ReadBatch& operator=(const ReadBatch &other) = delete;
+
+    /*!
+        \brief Returns true if the bytes were available
+    */
+    explicit operator bool() const {
+        return mCur != nullptr;
+    }
+
+    /*!
+        \brief Returns the number of reserved bytes not read yet
+    */
+    std::size_t remaining() const {
+        return static_cast<std::size_t>(mEnd - mCur);
+    }
+
+    /*!
+        \brief Reads an arithmetic value without checking for data
+        \param value the value to read into
+    */
+    template<typename T>
+    void get(T &value) {
+        assert(sizeof(T) <= remaining());
+        typename RawType<T>::type raw;
+        std::memcpy(&raw, mCur, sizeof(T));
+        mCur += sizeof(T);
+        value = static_cast<T>(mSwap ? swapBytes(raw) : raw);
+    }
+
+    /*!
+        \brief Returns the next arithmetic value without checking for data
+        \return the value
+    */
+    template<typename T>
+    T get() {
+        T value;
+        get(value);
+        return value;
+    }
+
+    /*!
+        \brief Returns a view of the next len bytes and skips over them
+        \param len the number of bytes
+        \return the bytes, which belong to the device of the stream
+    */
+    ByteView getBytes(std::size_t len) {
+        assert(len <= remaining());
+        mCur += len;
+        return ByteView(mCur - len, len);
+    }
+
+private:
+    const char *mCur; //!< the next byte to read, nullptr if there wasn't enough
+    const char *mEnd; //!< one past the last reserved byte
+    bool mSwap; //!< true if values are byte swapped
+};
+
+/*!
+    \brief Operator to write a string literal or char array, see writeString()
+
+    Without it a literal would convert to bool rather than to a string.
+
+    \param s the null terminated string to write
+*/
+template<std::size_t N>
+void ByteStream::operator<<(const char (&s)[N]) {
+    writeString(s, strnlen(s, N));
+}
+
+/*!
+    \brief Writes count arithmetic values in the byte order of the stream
+
+    The whole array is bounds checked once and copied in bulk, and swapped with
+    a vectorized kernel when the byte order differs from the host. Nothing is
+    written if the array doesn't fit.
+
+    \param values the values to write
+    \param count the number of values
+*/
+template<typename T>
+void ByteStream::writeArray(const T *values, std::size_t count) {
+    static_assert(std::is_arithmetic<T>::value, "only arithmetic arrays can be written");
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                  "only values of 1, 2, 4 or 8 bytes can be swapped, not long double");
+    writeArrayData(reinterpret_cast<const char*>(values), count, sizeof(T));
+}
+
+/*!
+    \brief Writes the elements of values, see writeArray(const T*, std::size_t)
+    \param values the values to write
+*/
+template<typename T>
+void ByteStream::writeArray(const std::vector<T> &values) {
+    writeArray(values.data(), values.size());
+}
+
+/*!
+    \brief Reads count arithmetic values in the byte order of the stream
+
+    The whole array is bounds checked once and copied in bulk. Nothing is read
+    if the stream holds fewer than count values.
+
+    \param values where to store the values
+    \param count the number of values
+*/
+template<typename T>
+void ByteStream::readArray(T *values, std::size_t count) {
+    static_assert(std::is_arithmetic<T>::value, "only arithmetic arrays can be read");
+    static_assert(sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                  "only values of 1, 2, 4 or 8 bytes can be swapped, not long double");
+    readArrayData(reinterpret_cast<char*>(values), count, sizeof(T));
+    if(std::is_same<T, bool>::value) {
+        // Make every byte a valid bool before it is read as one
+        unsigned char *bytes = reinterpret_cast<unsigned char*>(values);
+        for(std::size_t i = 0; i < count; i++) {
+            bytes[i] = bytes[i] != 0;
+        }
+    }
+}
+
+/*!
+    \brief Resizes values to count and reads into it
+    \param values where to store the values
+    \param count the number of values
+*/
+template<typename T>
+void ByteStream::readArray(std::vector<T> &values, std::size_t count) {
+    values.resize(count);
+    readArray(values.data(), count);
+}
+
+/*!
+    \brief Writes value into the device, reversing its bytes when Swap is set
+
+    Writes which fit are an inlined store, everything else takes the checked
+    path through writeData.
+
+    \param value the value to write
+*/
+template<bool Swap, typename T>
+inline void ByteStream::put(T value) {
+    OperationCounter counted(*this, operationOf<T>(), StreamDirection::Write);
+    checkArray();
+    if(Swap) {
+        value = swapBytes(value);
+    }
+
+    if(sizeof(T) <= static_cast<std::size_t>(mEnd - mCur) &&
+       mStatus == Status::Ok && mMode != OpenMode::ReadOnly) {
+        std::memcpy(mCur, &value, sizeof(T));
+        mCur += sizeof(T);
+        countBytesWritten(sizeof(T));
+    } else {
+        writeData(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+/*!
+    \brief Reads value from the device, reversing its bytes when Swap is set
+
+    value is left untouched if the read fails.
+
+    \param value the value to read into
+*/
+template<bool Swap, typename T>
+inline void ByteStream::get(T &value) {
+    OperationCounter counted(*this, operationOf<T>(), StreamDirection::Read);
+    checkArray();
+    typename RawType<T>::type raw;
+    if(sizeof(T) <= static_cast<std::size_t>(mEnd - mCur) && mStatus == Status::Ok &&
+       !writesToDevice()) {
+        std::memcpy(&raw, mCur, sizeof(T));
+        mCur += sizeof(T);
+        countBytesRead(sizeof(T));
+    } else if(!readData(reinterpret_cast<char*>(&raw), sizeof(T))) {
+        return;
+    }
+
+    value = static_cast<T>(Swap ? swapBytes(raw) : raw);
+}
+
+/*!
+    \brief Returns true if the stream writes into an IODevice
+    \return true if writing to an IODevice, otherwise false
+*/
+inline bool ByteStream::writesToDevice() const {
+    return mDevice && mMode != OpenMode::ReadOnly;
+}
+
+
+/*!
+    \brief Repoints the stream if its array grew, shrank or moved since the
+    stream last used it
+
+    Anything holding the array can append to it, another stream included, so
+    the stream keeps its position as an offset and checks its pointers before
+    using them.
+*/
+inline void ByteStream::checkArray() {
+    if(mArray && (mArray->begin() != mBegin || mArray->end() != mEnd)) {
+        resyncArray();
+    }
+}
+
+/*!
+    \brief Returns the kind of operation reading or writing a T counts as
+    \return Boolean for bool, FloatingPoint for float and double, else Integer
+*/
+template<typename T>
+constexpr StreamOperation ByteStream::operationOf() {
+    return std::is_same<T, bool>::value ? StreamOperation::Boolean
+         : std::is_floating_point<T>::value ? StreamOperation::FloatingPoint
+         : StreamOperation::Integer;
+}
+
+/*!
+    \brief Counts len bytes read, does nothing without instrumentation
+    \param len the number of bytes
+*/
+inline void ByteStream::countBytesRead(uint64_t len) {
+#if SERIAL_ENABLE_INSTRUMENTATION
+    mCounters.bytesRead += len;
+    detail::addCounter(detail::BytesReadCounter, len);
+#else
+    (void)len;
+#endif
+}
+
+/*!
+    \brief Counts len bytes written, does nothing without instrumentation
+    \param len the number of bytes
+*/
+inline void ByteStream::countBytesWritten(uint64_t len) {
+#if SERIAL_ENABLE_INSTRUMENTATION
+    mCounters.bytesWritten += len;
+    detail::addCounter(detail::BytesWrittenCounter, len);
+#else
+    (void)len;
+#endif
+}
+
 #endif //BYTE_STREAM_HPP
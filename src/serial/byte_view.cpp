@@ -0,0 +1,173 @@
+/*!
+    \file byte_view.cpp
+    \brief file to implement the ByteView class
+*/
+#include "byte_view.hpp"
+#include "byte_array.hpp"
+#include <algorithm>
+#include <cstring>
+
+/*!
+    \brief Default constructor for the ByteView
+
+    Generates an empty view
+*/
+ByteView::ByteView()
+: mData(nullptr),
+  mSize(0){
+
+}
+
+/*!
+    \brief Creates a view of size bytes starting at data
+    \param data the first byte of the view
+    \param size the number of bytes in the view
+*/
+ByteView::ByteView(const char* data, std::size_t size)
+: mData(data),
+  mSize(data ? size : 0){
+
+}
+
+/*!
+    \brief Creates a view of the contents of array
+
+    The view is invalidated when the array reallocates or is destroyed, so
+    views of temporary arrays are not allowed.
+
+    \param array the array to view
+*/
+ByteView::ByteView(const ByteArray& array)
+: mData(array.begin()),
+  mSize(static_cast<std::size_t>(array.size())){
+
+}
+
+/*!
+    \brief Returns a pointer to the first byte of the view
+    \return the first byte of the view
+*/
+const char* ByteView::data() const {
+    return mData;
+}
+
+/*!
+    \brief Returns the number of bytes in the view
+    \return the size of the view
+*/
+std::size_t ByteView::size() const {
+    return mSize;
+}
+
+/*!
+    \brief Returns true if the view has no bytes
+    \return true if empty, otherwise false
+*/
+bool ByteView::empty() const {
+    return mSize == 0;
+}
+
+/*!
+    \brief Returns an iterator at the front of the view
+    \return an iterator at the front
+*/
+ByteView::const_iterator ByteView::begin() const {
+    return mData;
+}
+
+/*!
+    \brief Returns an iterator at the end of the view
+    \return an iterator at the end
+*/
+ByteView::const_iterator ByteView::end() const {
+    return mData + mSize;
+}
+
+/*!
+    \brief Gets the byte at index
+    \param i the index of the byte to retrieve
+    \return a copy of the byte at the index
+*/
+char ByteView::at(std::size_t i) const {
+    return mData[i];
+}
+
+/*!
+    \brief Gets the byte at index
+    \param i the index of the byte to retrieve
+    \return a copy of the byte at the index
+*/
+char ByteView::operator[](std::size_t i) const {
+    return mData[i];
+}
+
+/*!
+    \brief Returns a view of the bytes from offset to the end of this view
+    \param offset the index of the first byte, clamped to the size
+    \return the view of the remaining bytes
+*/
+ByteView ByteView::slice(std::size_t offset) const {
+    offset = std::min(offset, mSize);
+    return ByteView(mData + offset, mSize - offset);
+}
+
+/*!
+    \brief Returns a view of length bytes starting at offset
+
+    The range is clamped to this view, so the result may be shorter than length.
+
+    \param offset the index of the first byte
+    \param length the number of bytes
+    \return the view of the range
+*/
+ByteView ByteView::slice(std::size_t offset, std::size_t length) const {
+    ByteView rest = slice(offset);
+    return ByteView(rest.mData, std::min(length, rest.mSize));
+}
+
+/*!
+    \brief Returns true if this view begins with the bytes of other
+    \param other the prefix to look for
+    \return true if other is a prefix of this view
+*/
+bool ByteView::startsWith(const ByteView& other) const {
+    return other.mSize <= mSize && slice(0, other.mSize) == other;
+}
+
+/*!
+    \brief Copies the bytes of the view into a new ByteArray
+    \return an array holding a copy of the bytes
+*/
+ByteArray ByteView::toByteArray() const {
+    return ByteArray(mData, static_cast<int>(mSize));
+}
+
+/*!
+    \brief Compares the bytes of two views
+    \param other the view to compare with
+    \return true if both views hold the same bytes
+*/
+bool ByteView::operator==(const ByteView& other) const {
+    return mSize == other.mSize &&
+           (mSize == 0 || std::memcmp(mData, other.mData, mSize) == 0);
+}
+
+/*!
+    \brief Compares the bytes of two views
+    \param other the view to compare with
+    \return true if the views hold different bytes
+*/
+bool ByteView::operator!=(const ByteView& other) const {
+    return !(*this == other);
+}
+
+/*!
+    \brief Compares the bytes of two views lexicographically, as unsigned bytes
+    \param other the view to compare with
+    \return true if this view orders before other
+*/
+bool ByteView::operator<(const ByteView& other) const {
+    const std::size_t common = std::min(mSize, other.mSize);
+    const int result = common == 0 ? 0 : std::memcmp(mData, other.mData, common);
+    return result < 0 || (result == 0 && mSize < other.mSize);
+}
@@ -0,0 +1,55 @@
+/*!
+    \file byte_view.hpp
+    \brief File to define the ByteView class
+*/
+
+#ifndef BYTE_VIEW_HPP
+#define BYTE_VIEW_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+class ByteArray;
+
+/*!
+    \brief Class which refers to a range of bytes it does not own
+
+    A ByteView is a pointer and a length, it is cheap to copy and never copies
+    the bytes it refers to. The memory must outlive the view.
+*/
+class ByteView {
+public:
+    using const_iterator = const char*;
+
+    ByteView();
+    ByteView(const char* data, std::size_t size);
+    explicit ByteView(const ByteArray &array);
+    ByteView(ByteArray&&) = delete;
+
+    const char* data() const;
+    std::size_t size() const;
+    bool empty() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    char at(std::size_t i) const;
+    char operator[](std::size_t i) const;
+
+    ByteView slice(std::size_t offset) const;
+    ByteView slice(std::size_t offset, std::size_t length) const;
+
+    bool startsWith(const ByteView &other) const;
+
+    ByteArray toByteArray() const;
+
+    bool operator==(const ByteView &other) const;
+    bool operator!=(const ByteView &other) const;
+    bool operator<(const ByteView &other) const;
+
+private:
+    const char *mData; //!< the first byte of the view
+    std::size_t mSize; //!< the number of bytes in the view
+};
+
+#endif // BYTE_VIEW_HPP
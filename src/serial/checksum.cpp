@@ -0,0 +1,317 @@
+/*!
+    \file checksum.cpp
+    \brief file to implement the CRC32C checksum functions
+*/
+#include "checksum.hpp"
+#include "byte_order.hpp"
+
+#include <cstring>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #include <nmmintrin.h>
+    #define SERIAL_CRC32C_SSE42 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+    #include <arm_acle.h>
+    #define SERIAL_CRC32C_ARM 1
+#endif
+
+namespace {
+//! The reflected Castagnoli polynomial
+const uint32_t Polynomial = 0x82F63B78u;
+
+/*!
+    \brief The lookup tables for slicing by 8
+
+    Table 0 is the usual byte at a time table, table k advances the CRC of a
+    byte by k more zero bytes, so eight bytes are folded in with eight lookups.
+*/
+struct SlicingTables {
+    SlicingTables() {
+        for(uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for(int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ ((crc & 1) ? Polynomial : 0);
+            }
+            table[0][i] = crc;
+        }
+        for(uint32_t i = 0; i < 256; i++) {
+            for(int k = 1; k < 8; k++) {
+                table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+            }
+        }
+    }
+
+    uint32_t table[8][256];
+};
+
+const SlicingTables& slicingTables() {
+    static const SlicingTables tables;
+    return tables;
+}
+
+uint32_t softwareUpdate(uint32_t crc, const unsigned char *p, std::size_t size) {
+    const uint32_t (&t)[8][256] = slicingTables().table;
+
+    while(size >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, p, 4);
+        std::memcpy(&high, p + 4, 4);
+        if(SERIAL_HOST_BIG_ENDIAN) {
+            low = byteSwap32(low);
+            high = byteSwap32(high);
+        }
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^
+              t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^
+              t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+        p += 8;
+        size -= 8;
+    }
+    while(size-- > 0) {
+        crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(SERIAL_CRC32C_SSE42)
+#if defined(__x86_64__)
+//! The lengths of the three interleaved streams, long and short
+const std::size_t LongStream = 8192;
+const std::size_t ShortStream = 256;
+
+/*!
+    \brief Multiplies the 32x32 bit matrix mat by vec, over GF(2)
+*/
+uint32_t matrixTimes(const uint32_t *mat, uint32_t vec) {
+    uint32_t sum = 0;
+    while(vec) {
+        if(vec & 1) {
+            sum ^= *mat;
+        }
+        vec >>= 1;
+        mat++;
+    }
+    return sum;
+}
+
+void matrixSquare(uint32_t *square, const uint32_t *mat) {
+    for(int n = 0; n < 32; n++) {
+        square[n] = matrixTimes(mat, mat[n]);
+    }
+}
+
+/*!
+    \brief The tables which advance a CRC over a run of zero bytes
+
+    The crc32 instruction has a latency of three cycles but can start one every
+    cycle, so three streams are checksummed at once and then combined, which
+    needs the CRC of the earlier streams moved past the bytes of the later.
+*/
+struct ShiftTables {
+    ShiftTables() {
+        build(longShift, LongStream);
+        build(shortShift, ShortStream);
+    }
+
+    /*!
+        \brief Builds the tables for len zero bytes by repeated squaring of
+        the operator for a single zero bit, len must be a power of two
+    */
+    static void build(uint32_t (&zeros)[4][256], std::size_t len) {
+        uint32_t even[32];
+        uint32_t odd[32];
+        odd[0] = Polynomial;
+        uint32_t row = 1;
+        for(int n = 1; n < 32; n++) {
+            odd[n] = row;
+            row <<= 1;
+        }
+        matrixSquare(even, odd);
+        matrixSquare(odd, even);
+
+        // odd now applies four zero bits, square it up to len bytes
+        const uint32_t *op = odd;
+        do {
+            matrixSquare(even, odd);
+            op = even;
+            len >>= 1;
+            if(len == 0) {
+                break;
+            }
+            matrixSquare(odd, even);
+            op = odd;
+            len >>= 1;
+        } while(len);
+
+        for(uint32_t n = 0; n < 256; n++) {
+            zeros[0][n] = matrixTimes(op, n);
+            zeros[1][n] = matrixTimes(op, n << 8);
+            zeros[2][n] = matrixTimes(op, n << 16);
+            zeros[3][n] = matrixTimes(op, n << 24);
+        }
+    }
+
+    static uint32_t shift(const uint32_t (&zeros)[4][256], uint32_t crc) {
+        return zeros[0][crc & 0xFF] ^ zeros[1][(crc >> 8) & 0xFF] ^
+               zeros[2][(crc >> 16) & 0xFF] ^ zeros[3][crc >> 24];
+    }
+
+    uint32_t longShift[4][256];
+    uint32_t shortShift[4][256];
+};
+
+const ShiftTables& shiftTables() {
+    static const ShiftTables tables;
+    return tables;
+}
+
+inline uint64_t load64(const unsigned char *p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return word;
+}
+
+/*!
+    \brief Checksums blocks of three streams of length bytes at once
+*/
+__attribute__((target("sse4.2")))
+uint64_t interleavedUpdate(uint64_t crc, const unsigned char *&p, std::size_t &size,
+                           std::size_t length, const uint32_t (&zeros)[4][256]) {
+    while(size >= 3 * length) {
+        uint64_t crc1 = 0;
+        uint64_t crc2 = 0;
+        const unsigned char *end = p + length;
+        do {
+            crc = _mm_crc32_u64(crc, load64(p));
+            crc1 = _mm_crc32_u64(crc1, load64(p + length));
+            crc2 = _mm_crc32_u64(crc2, load64(p + 2 * length));
+            p += 8;
+        } while(p < end);
+        crc = ShiftTables::shift(zeros, static_cast<uint32_t>(crc)) ^ crc1;
+        crc = ShiftTables::shift(zeros, static_cast<uint32_t>(crc)) ^ crc2;
+        p += 2 * length;
+        size -= 3 * length;
+    }
+    return crc;
+}
+#endif
+
+__attribute__((target("sse4.2")))
+uint32_t hardwareUpdate(uint32_t crc, const unsigned char *p, std::size_t size) {
+    // Align so the wide loads don't straddle cache lines
+    while(size > 0 && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+        size--;
+    }
+#if defined(__x86_64__)
+    const ShiftTables &tables = shiftTables();
+    uint64_t crc64 = crc;
+    crc64 = interleavedUpdate(crc64, p, size, LongStream, tables.longShift);
+    crc64 = interleavedUpdate(crc64, p, size, ShortStream, tables.shortShift);
+    while(size >= 8) {
+        crc64 = _mm_crc32_u64(crc64, load64(p));
+        p += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while(size >= 4) {
+        uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc = _mm_crc32_u32(crc, word);
+        p += 4;
+        size -= 4;
+    }
+    while(size-- > 0) {
+        crc = _mm_crc32_u8(crc, *p++);
+    }
+    return crc;
+}
+#elif defined(SERIAL_CRC32C_ARM)
+uint32_t hardwareUpdate(uint32_t crc, const unsigned char *p, std::size_t size) {
+    while(size >= 8) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        crc = __crc32cd(crc, word);
+        p += 8;
+        size -= 8;
+    }
+    while(size-- > 0) {
+        crc = __crc32cb(crc, *p++);
+    }
+    return crc;
+}
+#endif
+
+using UpdateFunction = uint32_t (*)(uint32_t, const unsigned char*, std::size_t);
+
+/*!
+    \brief Picks the fastest implementation the CPU supports, once
+*/
+UpdateFunction selectUpdate() {
+#if defined(SERIAL_CRC32C_SSE42)
+    if(__builtin_cpu_supports("sse4.2")) {
+        return hardwareUpdate;
+    }
+#elif defined(SERIAL_CRC32C_ARM)
+    return hardwareUpdate;
+#endif
+    slicingTables();
+    return softwareUpdate;
+}
+
+UpdateFunction update() {
+    static const UpdateFunction function = selectUpdate();
+    return function;
+}
+}
+
+/*!
+    \brief Computes the CRC32C (Castagnoli) checksum of size bytes
+
+    Uses the CRC32 instructions of SSE 4.2 or ARMv8 when the CPU has them,
+    otherwise a slicing by 8 table implementation. To checksum data in pieces,
+    pass the result for the earlier pieces as crc.
+
+    \param data the bytes to checksum
+    \param size the number of bytes
+    \param crc the checksum of the data before these bytes, 0 to start
+    \return the checksum of all of the data
+*/
+uint32_t crc32c(const char *data, std::size_t size, uint32_t crc) {
+    return ~update()(~crc, reinterpret_cast<const unsigned char*>(data), size);
+}
+
+/*!
+    \brief Computes the CRC32C checksum of the bytes of view, see crc32c()
+    \param view the bytes to checksum
+    \param crc the checksum of the data before these bytes, 0 to start
+    \return the checksum of all of the data
+*/
+uint32_t crc32c(const ByteView &view, uint32_t crc) {
+    return crc32c(view.data(), view.size(), crc);
+}
+
+/*!
+    \brief Computes the CRC32C checksum without special instructions
+
+    The result is always the same as crc32c(), which uses this when the CPU
+    can't do better.
+
+    \param data the bytes to checksum
+    \param size the number of bytes
+    \param crc the checksum of the data before these bytes, 0 to start
+    \return the checksum of all of the data
+*/
+uint32_t crc32cSoftware(const char *data, std::size_t size, uint32_t crc) {
+    return ~softwareUpdate(~crc, reinterpret_cast<const unsigned char*>(data), size);
+}
+
+/*!
+    \brief Returns true if crc32c() uses CPU instructions rather than tables
+*/
+bool crc32cHardwareAccelerated() {
+    return update() != softwareUpdate;
+}
@@ -0,0 +1,19 @@
+/*!
+    \file checksum.hpp
+    \brief File to define the CRC32C checksum functions
+*/
+
+#ifndef CHECKSUM_HPP
+#define CHECKSUM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "byte_view.hpp"
+
+uint32_t crc32c(const char *data, std::size_t size, uint32_t crc = 0);
+uint32_t crc32c(const ByteView &view, uint32_t crc = 0);
+uint32_t crc32cSoftware(const char *data, std::size_t size, uint32_t crc = 0);
+bool crc32cHardwareAccelerated();
+
+#endif // CHECKSUM_HPP
@@ -0,0 +1,550 @@
+/*!
+    \file compression.cpp
+    \brief file to implement the block compression functions and devices
+*/
+#include "compression.hpp"
+#include "byte_order.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace {
+//! Matches are at least this long, shorter ones don't pay for their offset
+const int MinMatch = 4;
+//! The last bytes of a block are always literals
+const int LastLiterals = 5;
+//! No match starts this close to the end of a block
+const int MatchFindLimit = 12;
+//! Matches reach at most this far back
+const int MaxOffset = 65535;
+//! The number of bits of the hash of four bytes
+const int HashBits = 12;
+//! Literal or match lengths of this need extra length bytes
+const int RunMask = 15;
+
+//! Set in the stored size of a block which isn't compressed
+const uint32_t StoredFlag = 0x80000000u;
+//! The stored size and the decompressed size, each a little endian uint32_t
+const int BlockHeaderSize = 8;
+//! A block can't decompress to more than this many times its stored size
+const uint32_t MaxRatio = 255;
+
+inline uint32_t read32(const char *p) {
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t hash32(uint32_t sequence) {
+    return (sequence * 2654435761u) >> (32 - HashBits);
+}
+
+inline uint32_t littleEndian32(uint32_t value) {
+    return SERIAL_HOST_BIG_ENDIAN ? byteSwap32(value) : value;
+}
+
+/*!
+    \brief Writes length - RunMask as 255 valued bytes and a final remainder
+    \return one past the last byte written
+*/
+inline char* writeLength(char *out, int length) {
+    length -= RunMask;
+    while(length >= 255) {
+        *out++ = static_cast<char>(255);
+        length -= 255;
+    }
+    *out++ = static_cast<char>(length);
+    return out;
+}
+
+/*!
+    \brief Reads the extra bytes of a length, added to length
+    \return false if the bytes run past end
+*/
+inline bool readLength(const unsigned char *&in, const unsigned char *end, int &length) {
+    unsigned int byte;
+    do {
+        if(in == end) {
+            return false;
+        }
+        byte = *in++;
+        length += static_cast<int>(byte);
+        if(length < 0) {
+            return false;
+        }
+    } while(byte == 255);
+    return true;
+}
+
+/*!
+    \brief Appends one block to a frame, compressed unless that doesn't help
+*/
+void appendBlock(ByteArray &frame, const char *data, int size, ByteArray &scratch) {
+    const int bound = compressedBound(size);
+    if(scratch.size() < bound) {
+        scratch.clear();
+        scratch.extend(bound);
+    }
+
+    int compressed = compressBlock(data, size, scratch.begin(), bound);
+    const bool stored = compressed == 0 || compressed >= size;
+    const int payload = stored ? size : compressed;
+
+    const uint32_t header[2] = {
+        littleEndian32(static_cast<uint32_t>(payload) | (stored ? StoredFlag : 0)),
+        littleEndian32(static_cast<uint32_t>(size))
+    };
+    char *out = frame.extend(BlockHeaderSize + payload);
+    std::memcpy(out, header, BlockHeaderSize);
+    std::memcpy(out + BlockHeaderSize, stored ? data : scratch.begin(), payload);
+}
+
+/*!
+    \brief Reads and checks the header of a block
+    \return false if the sizes can't be right
+*/
+bool parseBlockHeader(const char *header, uint32_t &payload, uint32_t &size, bool &stored) {
+    uint32_t words[2];
+    std::memcpy(words, header, BlockHeaderSize);
+    const uint32_t storedSize = littleEndian32(words[0]);
+    payload = storedSize & ~StoredFlag;
+    size = littleEndian32(words[1]);
+    stored = (storedSize & StoredFlag) != 0;
+
+    if(size > static_cast<uint32_t>(MaxCompressionBlockSize)) {
+        return false;
+    }
+    if(stored) {
+        return payload == size;
+    }
+    // Readers allocate the payload before decompressing it, so bound it too
+    return payload <= static_cast<uint32_t>(compressedBound(static_cast<int>(size))) &&
+           static_cast<uint64_t>(payload) * MaxRatio >= size;
+}
+}
+
+/*!
+    \brief Returns the most bytes compressBlock() may write for size bytes
+
+    Incompressible data grows slightly, by its literal length bytes.
+
+    \param size the size of the data
+    \return the capacity the destination needs
+*/
+int compressedBound(int size) {
+    return size + size / 255 + 16;
+}
+
+/*!
+    \brief Compresses a block in the LZ4 block format
+
+    Matches are found greedily through a hash table of four byte sequences,
+    which favors speed over ratio. Each sequence is a token holding the literal
+    and match lengths, the literals, and a two byte offset back to the match.
+
+    \param source the data to compress
+    \param size the size of the data
+    \param destination where to write the compressed block
+    \param capacity the size of destination
+    \return the size of the compressed block, 0 if it didn't fit in capacity
+*/
+int compressBlock(const char* source, int size, char* destination, int capacity) {
+    const char* in = source;
+    const char* anchor = source;
+    const char* const end = source + size;
+    const char* const matchFindEnd = end - MatchFindLimit;
+    const char* const matchEnd = end - LastLiterals;
+    char* out = destination;
+    char* const outEnd = destination + capacity;
+
+    // Every entry starts at the beginning, the comparison rejects stale ones
+    uint32_t table[1 << HashBits] = {0};
+
+    if(size > MatchFindLimit) {
+        in++;
+        while(in < matchFindEnd) {
+            const uint32_t sequence = read32(in);
+            const uint32_t hash = hash32(sequence);
+            const char* match = source + table[hash];
+            table[hash] = static_cast<uint32_t>(in - source);
+
+            if(match >= in || in - match > MaxOffset || read32(match) != sequence) {
+                // Step further the longer nothing matched, to skip incompressible data
+                in += 1 + ((in - anchor) >> 6);
+                continue;
+            }
+
+            // Take in any equal bytes before the match as well
+            while(in > anchor && match > source && in[-1] == match[-1]) {
+                in--;
+                match--;
+            }
+
+            int matchLength = MinMatch;
+            while(in + matchLength < matchEnd && in[matchLength] == match[matchLength]) {
+                matchLength++;
+            }
+
+            const int literals = static_cast<int>(in - anchor);
+            if(outEnd - out < 1 + literals + literals / 255 + 2 + 1 + matchLength / 255 + 1) {
+                return 0;
+            }
+
+            char* token = out++;
+            if(literals >= RunMask) {
+                *token = static_cast<char>(RunMask << 4);
+                out = writeLength(out, literals);
+            } else {
+                *token = static_cast<char>(literals << 4);
+            }
+            std::memcpy(out, anchor, static_cast<std::size_t>(literals));
+            out += literals;
+
+            const int offset = static_cast<int>(in - match);
+            *out++ = static_cast<char>(offset & 0xFF);
+            *out++ = static_cast<char>(offset >> 8);
+
+            const int extra = matchLength - MinMatch;
+            if(extra >= RunMask) {
+                *token = static_cast<char>(*token | RunMask);
+                out = writeLength(out, extra);
+            } else {
+                *token = static_cast<char>(*token | extra);
+            }
+
+            in += matchLength;
+            anchor = in;
+            if(in < matchFindEnd) {
+                table[hash32(read32(in - 2))] = static_cast<uint32_t>(in - 2 - source);
+            }
+        }
+    }
+
+    // The rest of the block is one run of literals
+    const int literals = static_cast<int>(end - anchor);
+    if(outEnd - out < 1 + literals + literals / 255 + 1) {
+        return 0;
+    }
+    if(literals >= RunMask) {
+        *out++ = static_cast<char>(RunMask << 4);
+        out = writeLength(out, literals);
+    } else {
+        *out++ = static_cast<char>(literals << 4);
+    }
+    std::memcpy(out, anchor, static_cast<std::size_t>(literals));
+    out += literals;
+
+    return static_cast<int>(out - destination);
+}
+
+/*!
+    \brief Decompresses a block written by compressBlock()
+
+    Every length and offset is checked, so corrupt input fails instead of
+    reading or writing out of bounds.
+
+    \param source the compressed block
+    \param size the size of the compressed block
+    \param destination where to write the data
+    \param capacity the size of destination
+    \return the size of the data, -1 if the block is corrupt or doesn't fit
+*/
+int decompressBlock(const char* source, int size, char* destination, int capacity) {
+    const unsigned char* in = reinterpret_cast<const unsigned char*>(source);
+    const unsigned char* const end = in + size;
+    char* out = destination;
+    char* const outEnd = destination + capacity;
+
+    while(in < end) {
+        const unsigned int token = *in++;
+
+        int literals = static_cast<int>(token >> 4);
+        if(literals == RunMask && !readLength(in, end, literals)) {
+            return -1;
+        }
+        if(literals > end - in || literals > outEnd - out) {
+            return -1;
+        }
+        std::memcpy(out, in, static_cast<std::size_t>(literals));
+        out += literals;
+        in += literals;
+
+        // The last sequence has no match
+        if(in == end) {
+            break;
+        }
+
+        if(end - in < 2) {
+            return -1;
+        }
+        const int offset = in[0] | (in[1] << 8);
+        in += 2;
+        if(offset == 0 || offset > out - destination) {
+            return -1;
+        }
+
+        int matchLength = static_cast<int>(token & RunMask);
+        if(matchLength == RunMask && !readLength(in, end, matchLength)) {
+            return -1;
+        }
+        matchLength += MinMatch;
+        if(matchLength > outEnd - out) {
+            return -1;
+        }
+
+        const char* match = out - offset;
+        if(offset >= matchLength) {
+            std::memcpy(out, match, static_cast<std::size_t>(matchLength));
+            out += matchLength;
+        } else {
+            // The match overlaps what it writes, so it repeats a pattern
+            for(int i = 0; i < matchLength; i++) {
+                *out++ = *match++;
+            }
+        }
+    }
+
+    return static_cast<int>(out - destination);
+}
+
+/*!
+    \brief Compresses data into a frame of independently compressed blocks
+
+    Each block is preceded by its stored size and its decompressed size, so
+    blocks can be skipped or decompressed on their own. A block that doesn't
+    compress is stored as it is.
+
+    \param data the data to compress
+    \param blockSize the size of the blocks the data is split into, at most
+    MaxCompressionBlockSize
+    \return the frame
+*/
+ByteArray compress(const ByteView& data, int blockSize) {
+    blockSize = std::min(std::max(blockSize, 1), MaxCompressionBlockSize);
+
+    ByteArray frame;
+    const std::size_t blocks = (data.size() + blockSize - 1) / blockSize;
+    frame.reserve(static_cast<int>(compressedBound(static_cast<int>(data.size())) +
+                                   blocks * (BlockHeaderSize + 16)));
+
+    ByteArray scratch;
+    for(std::size_t offset = 0; offset < data.size(); offset += blockSize) {
+        const int size = static_cast<int>(std::min<std::size_t>(blockSize, data.size() - offset));
+        appendBlock(frame, data.data() + offset, size, scratch);
+    }
+    return frame;
+}
+
+/*!
+    \brief Decompresses a frame written by compress() or a CompressingDevice
+    \param frame the compressed frame
+    \param data set to the decompressed data
+    \return true if the frame was decompressed, false if it is corrupt
+*/
+bool decompress(const ByteView& frame, ByteArray& data) {
+    // Find the total size first, so the output is allocated once
+    uint64_t total = 0;
+    for(std::size_t offset = 0; offset < frame.size();) {
+        uint32_t payload, size;
+        bool stored;
+        if(frame.size() - offset < static_cast<std::size_t>(BlockHeaderSize) ||
+           !parseBlockHeader(frame.data() + offset, payload, size, stored) ||
+           payload > frame.size() - offset - BlockHeaderSize) {
+            return false;
+        }
+        total += size;
+        offset += BlockHeaderSize + payload;
+    }
+    if(total > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        return false;
+    }
+
+    data.clear();
+    data.reserve(static_cast<int>(total));
+    for(std::size_t offset = 0; offset < frame.size();) {
+        uint32_t payload, size;
+        bool stored;
+        parseBlockHeader(frame.data() + offset, payload, size, stored);
+        const char* block = frame.data() + offset + BlockHeaderSize;
+
+        char* out = data.extend(static_cast<int>(size));
+        if(stored) {
+            std::memcpy(out, block, size);
+        } else if(decompressBlock(block, static_cast<int>(payload), out, static_cast<int>(size)) !=
+                  static_cast<int>(size)) {
+            data.clear();
+            return false;
+        }
+        offset += BlockHeaderSize + payload;
+    }
+    return true;
+}
+
+/*!
+    \brief Creates a device which compresses into device
+    \param device the device to write the compressed frame to
+    \param blockSize the size of the blocks the data is split into, at most
+    MaxCompressionBlockSize
+*/
+CompressingDevice::CompressingDevice(IODevice* device, int blockSize)
+: mDevice(device),
+  mBlockSize(std::min(std::max(blockSize, 1), MaxCompressionBlockSize)){
+    mBlock.reserve(mBlockSize);
+}
+
+/*!
+    \brief Writes the last partial block, without flushing the device
+*/
+CompressingDevice::~CompressingDevice() {
+    writeBlock();
+}
+
+/*!
+    \brief Fails, a CompressingDevice can only be written
+    \return -1
+*/
+int64_t CompressingDevice::read(char*, uint64_t) {
+    return -1;
+}
+
+/*!
+    \brief Collects data into blocks, and writes each one when it fills
+    \param data the bytes to write
+    \param size the number of bytes
+    \return size, or -1 if writing a block failed
+*/
+int64_t CompressingDevice::write(const char* data, uint64_t size) {
+    uint64_t written = 0;
+    while(written < size) {
+        const int count = static_cast<int>(std::min<uint64_t>(size - written,
+                                                               mBlockSize - mBlock.size()));
+        mBlock.append(data + written, count);
+        written += static_cast<uint64_t>(count);
+
+        if(mBlock.size() == mBlockSize && !writeBlock()) {
+            return -1;
+        }
+    }
+    return static_cast<int64_t>(size);
+}
+
+/*!
+    \brief Writes the partial block collected so far and flushes the device
+    \return true if everything was written, otherwise false
+*/
+bool CompressingDevice::flush() {
+    return writeBlock() && mDevice->flush();
+}
+
+/*!
+    \brief Compresses the collected block and writes it to the device
+    \return true if it was written, otherwise false
+*/
+bool CompressingDevice::writeBlock() {
+    if(mBlock.empty()) {
+        return true;
+    }
+
+    ByteArray frame;
+    frame.reserve(BlockHeaderSize + compressedBound(mBlock.size()));
+    appendBlock(frame, mBlock.begin(), mBlock.size(), mCompressed);
+    mBlock.clear();
+    return mDevice->write(frame.begin(), static_cast<uint64_t>(frame.size())) == frame.size();
+}
+
+/*!
+    \brief Creates a device which decompresses what it reads from device
+    \param device the device to read the compressed frame from
+*/
+DecompressingDevice::DecompressingDevice(IODevice* device)
+: mDevice(device),
+  mPosition(0){
+
+}
+
+/*!
+    \brief Reads decompressed data, decompressing the next block when needed
+    \param data where to store the bytes
+    \param maxSize the most bytes to read
+    \return the number of bytes read, 0 at the end, -1 if the frame is corrupt
+*/
+int64_t DecompressingDevice::read(char* data, uint64_t maxSize) {
+    if(mPosition == mBlock.size()) {
+        const int result = readBlock();
+        if(result <= 0) {
+            return result;
+        }
+    }
+
+    const int count = static_cast<int>(std::min<uint64_t>(maxSize, mBlock.size() - mPosition));
+    std::memcpy(data, mBlock.begin() + mPosition, static_cast<std::size_t>(count));
+    mPosition += count;
+    return count;
+}
+
+/*!
+    \brief Fails, a DecompressingDevice can only be read
+    \return -1
+*/
+int64_t DecompressingDevice::write(const char*, uint64_t) {
+    return -1;
+}
+
+/*!
+    \brief Reads the next block from the device and decompresses it
+
+    Empty blocks are skipped.
+
+    \return 1 if a block was read, 0 at the end of the frame, -1 if corrupt
+*/
+int DecompressingDevice::readBlock() {
+    // Reads exactly size bytes, or reports how many there were
+    auto readFully = [this](char* out, uint64_t size) -> int64_t {
+        uint64_t filled = 0;
+        while(filled < size) {
+            const int64_t result = mDevice->read(out + filled, size - filled);
+            if(result < 0) {
+                return -1;
+            } else if(result == 0) {
+                break;
+            }
+            filled += static_cast<uint64_t>(result);
+        }
+        return static_cast<int64_t>(filled);
+    };
+
+    do {
+        char header[BlockHeaderSize];
+        const int64_t headerRead = readFully(header, BlockHeaderSize);
+        if(headerRead == 0) {
+            return 0;
+        }
+
+        uint32_t payload, size;
+        bool stored;
+        if(headerRead != BlockHeaderSize || !parseBlockHeader(header, payload, size, stored)) {
+            return -1;
+        }
+
+        mBlock.clear();
+        mPosition = 0;
+        char* out = mBlock.extend(static_cast<int>(size));
+        if(stored) {
+            if(readFully(out, payload) != static_cast<int64_t>(payload)) {
+                return -1;
+            }
+            continue;
+        }
+
+        mCompressed.clear();
+        char* compressed = mCompressed.extend(static_cast<int>(payload));
+        if(readFully(compressed, payload) != static_cast<int64_t>(payload) ||
+           decompressBlock(compressed, static_cast<int>(payload), out,
+                           static_cast<int>(size)) != static_cast<int>(size)) {
+            return -1;
+        }
+    } while(mBlock.empty());
+
+    return 1;
+}
@@ -0,0 +1,90 @@
+/*!
+    \file compression.hpp
+    \brief File to define the block compression functions and devices
+*/
+
+#ifndef COMPRESSION_HPP
+#define COMPRESSION_HPP
+
+#include <cstdint>
+
+#include "byte_array.hpp"
+#include "byte_view.hpp"
+#include "io_device.hpp"
+
+/*!
+    \brief The size of the blocks data is split into if none is given
+
+    Matches can reach 64 KiB back, so larger blocks compress little better.
+*/
+const int DefaultCompressionBlockSize = 64 * 1024;
+
+/*!
+    \brief The largest size of a block, larger sizes are clamped to it
+
+    Readers reject blocks which claim to be larger, so a corrupt header can't
+    make them allocate more than this.
+*/
+const int MaxCompressionBlockSize = 64 * 1024 * 1024;
+
+int compressedBound(int size);
+int compressBlock(const char *source, int size, char *destination, int capacity);
+int decompressBlock(const char *source, int size, char *destination, int capacity);
+
+ByteArray compress(const ByteView &data, int blockSize = DefaultCompressionBlockSize);
+bool decompress(const ByteView &frame, ByteArray &data);
+
+/*!
+    \brief Device which compresses what is written and writes it to another
+
+    The data is collected into blocks, and each full block is compressed and
+    written as soon as it fills. flush() writes the last partial block. The
+    output is the same frame compress() returns, so a ByteStream set to it
+    compresses transparently:
+
+    \code
+    FileDevice file("snapshot.lz", FileDevice::Mode::WriteOnly);
+    CompressingDevice compressor(&file);
+    ByteStream stream(&compressor, ByteStream::OpenMode::WriteOnly);
+    \endcode
+*/
+class CompressingDevice : public IODevice {
+public:
+    explicit CompressingDevice(IODevice *device, int blockSize = DefaultCompressionBlockSize);
+    ~CompressingDevice() override;
+
+    int64_t read(char *data, uint64_t maxSize) override;
+    int64_t write(const char *data, uint64_t size) override;
+    bool flush() override;
+
+private:
+    bool writeBlock();
+
+    IODevice *mDevice; //!< the device the compressed frame is written to
+    int mBlockSize; //!< the size of a full block
+    ByteArray mBlock; //!< the data of the block being collected
+    ByteArray mCompressed; //!< scratch space for compressing a block
+};
+
+/*!
+    \brief Device which reads a compressed frame from another and decompresses it
+
+    Blocks are read and decompressed one at a time as the data is read.
+*/
+class DecompressingDevice : public IODevice {
+public:
+    explicit DecompressingDevice(IODevice *device);
+
+    int64_t read(char *data, uint64_t maxSize) override;
+    int64_t write(const char *data, uint64_t size) override;
+
+private:
+    int readBlock();
+
+    IODevice *mDevice; //!< the device the compressed frame is read from
+    ByteArray mBlock; //!< the decompressed data of the current block
+    ByteArray mCompressed; //!< the compressed data of the current block
+    int mPosition; //!< the next byte of mBlock to read
+};
+
+#endif // COMPRESSION_HPP
@@ -0,0 +1,120 @@
+/*!
+    \file fixed_order_byte_stream.hpp
+    \brief File to define the FixedOrderByteStream class
+*/
+
+#ifndef FIXED_ORDER_BYTE_STREAM_HPP
+#define FIXED_ORDER_BYTE_STREAM_HPP
+
+#include "byte_stream.hpp"
+
+/*!
+    \brief A ByteStream whose byte order is fixed at compile time
+
+    The arithmetic operators are inlined and know at compile time whether the
+    bytes need swapping, so in the host byte order each field is a plain
+    unaligned store or load with no per field branch on the byte order.
+    Integers are always fixed width, so the encoding is identical to a
+    ByteStream set to the same byte order and IntegerEncoding::Fixed.
+*/
+template<ByteStream::ByteOrder Order>
+class FixedOrderByteStream : public ByteStream {
+public:
+    FixedOrderByteStream();
+    FixedOrderByteStream(ByteArray *array, OpenMode mode);
+    explicit FixedOrderByteStream(const ByteView &view);
+    FixedOrderByteStream(MappedByteArray *array, OpenMode mode);
+
+    using ByteStream::operator<<;
+    using ByteStream::operator>>;
+
+    //write to the stream
+    void operator<<(uint8_t i) { put<false>(i); }
+    void operator<<(uint16_t i) { put<Swap>(i); }
+    void operator<<(uint32_t i) { put<Swap>(i); }
+    void operator<<(uint64_t i) { put<Swap>(i); }
+    void operator<<(int8_t i) { put<false>(i); }
+    void operator<<(int16_t i) { put<Swap>(i); }
+    void operator<<(int32_t i) { put<Swap>(i); }
+    void operator<<(int64_t i) { put<Swap>(i); }
+
+    void operator<<(bool b) { put<false>(b); }
+
+    void operator<<(float f) { put<Swap>(f); }
+    void operator<<(double d) { put<Swap>(d); }
+
+    // from the stream
+    void operator>>(uint8_t &i) { get<false>(i); }
+    void operator>>(uint16_t &i) { get<Swap>(i); }
+    void operator>>(uint32_t &i) { get<Swap>(i); }
+    void operator>>(uint64_t &i) { get<Swap>(i); }
+    void operator>>(int8_t &i) { get<false>(i); }
+    void operator>>(int16_t &i) { get<Swap>(i); }
+    void operator>>(int32_t &i) { get<Swap>(i); }
+    void operator>>(int64_t &i) { get<Swap>(i); }
+
+    void operator>>(bool &b) { get<false>(b); }
+
+    void operator>>(float &f) { get<Swap>(f); }
+    void operator>>(double &d) { get<Swap>(d); }
+
+private:
+    //! The byte order is part of the type, so it can't be changed
+    using ByteStream::setByteOrder;
+    //! The operators always write fixed width integers, so neither can this
+    using ByteStream::setIntegerEncoding;
+
+    static constexpr bool Swap = Order != ByteStream::hostByteOrder();
+};
+
+using BigEndianByteStream = FixedOrderByteStream<ByteStream::ByteOrder::BigEndian>;
+using LittleEndianByteStream = FixedOrderByteStream<ByteStream::ByteOrder::LittleEndian>;
+using NativeByteStream = FixedOrderByteStream<ByteStream::hostByteOrder()>;
+
+/*!
+    \brief Default constructor for the FixedOrderByteStream class
+
+    This initializes a stream without a device to read or write to
+*/
+template<ByteStream::ByteOrder Order>
+FixedOrderByteStream<Order>::FixedOrderByteStream()
+: ByteStream(){
+    ByteStream::setByteOrder(Order);
+}
+
+/*!
+    \brief Constructs a FixedOrderByteStream that operates on a ByteArray array.
+    \param array The ByteArray to operate on
+    \param mode The mode to read or write from the byte array on
+*/
+template<ByteStream::ByteOrder Order>
+FixedOrderByteStream<Order>::FixedOrderByteStream(ByteArray *array, OpenMode mode)
+: ByteStream(array, mode){
+    ByteStream::setByteOrder(Order);
+}
+
+/*!
+    \brief Constructs a read only FixedOrderByteStream over memory it does not own
+    \param view the bytes to read from
+*/
+template<ByteStream::ByteOrder Order>
+FixedOrderByteStream<Order>::FixedOrderByteStream(const ByteView &view)
+: ByteStream(view){
+    ByteStream::setByteOrder(Order);
+}
+
+/*!
+    \brief Constructs a FixedOrderByteStream over a memory mapped file
+    \param array the mapping to operate on
+    \param mode The mode to read or write from the mapping on
+*/
+template<ByteStream::ByteOrder Order>
+FixedOrderByteStream<Order>::FixedOrderByteStream(MappedByteArray *array, OpenMode mode)
+: ByteStream(array, mode){
+    ByteStream::setByteOrder(Order);
+}
+
+template<ByteStream::ByteOrder Order>
+constexpr bool FixedOrderByteStream<Order>::Swap;
+
+#endif // FIXED_ORDER_BYTE_STREAM_HPP
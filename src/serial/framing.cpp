@@ -0,0 +1,208 @@
+/*!
+    \file framing.cpp
+    \brief file to implement length delimited framing and the FrameDecoder class
+*/
+#include "framing.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+/*!
+    \brief Appends payload to out as a frame, its varint length then its bytes
+    \param out the array to append to
+    \param payload the bytes of the frame
+    \param size the number of bytes
+*/
+void appendFrame(ByteArray &out, const char *payload, std::size_t size) {
+    char header[MaxVarintLength];
+    const int headerSize = encodeVarint(size, header);
+    char* destination = out.extend(headerSize + static_cast<int>(size));
+    std::memcpy(destination, header, static_cast<std::size_t>(headerSize));
+    if(size > 0) {
+        std::memcpy(destination + headerSize, payload, size);
+    }
+}
+
+/*!
+    \brief Appends payload to out as a frame, see appendFrame()
+    \param out the array to append to
+    \param payload the bytes of the frame
+*/
+void appendFrame(ByteArray &out, const ByteView &payload) {
+    appendFrame(out, payload.data(), payload.size());
+}
+
+/*!
+    \brief Constructs a FrameDecoder
+    \param maxFrameSize the length above which a frame is treated as corrupt,
+    rather than buffered. It is capped to the largest ByteArray.
+*/
+FrameDecoder::FrameDecoder(std::size_t maxFrameSize) :
+mMaxFrameSize(std::min<std::size_t>(maxFrameSize, static_cast<std::size_t>(std::numeric_limits<int>::max()))),
+mCur(nullptr),
+mEnd(nullptr),
+mHeaderSize(0),
+mHaveLength(false),
+mFrameSize(0),
+mPendingReturned(false),
+mCorrupt(false){
+
+}
+
+/*!
+    \brief Gives the decoder the next chunk of input
+
+    Any part of the previous chunk not yet returned by next() must have been
+    buffered, that is next() must have returned NeedMoreData or Corrupt.
+
+    \param data the bytes received
+    \param size the number of bytes
+*/
+void FrameDecoder::feed(const char *data, std::size_t size) {
+    mCur = data;
+    mEnd = data + size;
+}
+
+/*!
+    \brief Gives the decoder the next chunk of input, see feed()
+    \param chunk the bytes received
+*/
+void FrameDecoder::feed(const ByteView &chunk) {
+    feed(chunk.data(), chunk.size());
+}
+
+/*!
+    \brief Returns the next complete frame
+
+    NeedMoreData means the whole chunk has been consumed, what is left of a
+    frame is buffered and the chunk may be reused. Corrupt means a length was
+    malformed or larger than maxFrameSize(), a length delimited stream can't
+    be resynchronized after that so every later call is Corrupt until reset().
+
+    \param frame set to the payload of the frame when FrameReady
+    \return the status of the decoder
+*/
+FrameDecoder::Status FrameDecoder::next(ByteView &frame) {
+    if(mCorrupt) {
+        return Status::Corrupt;
+    }
+    if(mPendingReturned) {
+        mPending.clear();
+        mPendingReturned = false;
+    }
+
+    if(!mHaveLength) {
+        const Status status = readHeader();
+        if(status != Status::FrameReady) {
+            return status;
+        }
+    }
+
+    const std::size_t available = static_cast<std::size_t>(mEnd - mCur);
+    if(mPending.empty() && available >= mFrameSize) {
+        frame = ByteView(mCur, static_cast<std::size_t>(mFrameSize));
+        mCur += mFrameSize;
+        mHaveLength = false;
+        return Status::FrameReady;
+    }
+
+    if(mPending.empty()) {
+        mPending.reserve(static_cast<int>(mFrameSize));
+    }
+    const std::size_t wanted = static_cast<std::size_t>(mFrameSize) - static_cast<std::size_t>(mPending.size());
+    const std::size_t taken = std::min(wanted, available);
+    if(taken > 0) {
+        mPending.append(mCur, static_cast<int>(taken));
+        mCur += taken;
+    }
+    if(taken < wanted) {
+        return Status::NeedMoreData;
+    }
+
+    frame = ByteView(mPending);
+    mPendingReturned = true;
+    mHaveLength = false;
+    return Status::FrameReady;
+}
+
+/*!
+    \brief Returns the number of bytes held over from earlier chunks
+*/
+std::size_t FrameDecoder::buffered() const {
+    const std::size_t pending = mPendingReturned ? 0 : static_cast<std::size_t>(mPending.size());
+    return pending + static_cast<std::size_t>(mHeaderSize);
+}
+
+/*!
+    \brief Returns the length above which frames are treated as corrupt
+*/
+std::size_t FrameDecoder::maxFrameSize() const {
+    return mMaxFrameSize;
+}
+
+/*!
+    \brief Returns true if the decoder read a bad length
+*/
+bool FrameDecoder::isCorrupt() const {
+    return mCorrupt;
+}
+
+/*!
+    \brief Drops any buffered input and the current chunk, and clears Corrupt
+*/
+void FrameDecoder::reset() {
+    mCur = mEnd = nullptr;
+    mHeaderSize = 0;
+    mHaveLength = false;
+    mFrameSize = 0;
+    mPending.clear();
+    mPendingReturned = false;
+    mCorrupt = false;
+}
+
+/*!
+    \brief Decodes the length of the next frame into mFrameSize
+
+    A length split across chunks is collected in mHeader, which is at most
+    MaxVarintLength bytes, so only those bytes are ever decoded twice.
+
+    \return FrameReady once the length is known, otherwise NeedMoreData or
+    Corrupt
+*/
+FrameDecoder::Status FrameDecoder::readHeader() {
+    if(mCur == mEnd) {
+        return Status::NeedMoreData;
+    }
+
+    uint64_t length = 0;
+    int result = 0;
+    if(mHeaderSize == 0) {
+        result = decodeVarint(mCur, mEnd, length);
+        if(result > 0) {
+            mCur += result;
+        } else if(result == 0) {
+            mHeaderSize = static_cast<int>(mEnd - mCur);
+            std::memcpy(mHeader, mCur, static_cast<std::size_t>(mHeaderSize));
+            mCur = mEnd;
+            return Status::NeedMoreData;
+        }
+    } else {
+        while(result == 0 && mCur != mEnd && mHeaderSize < MaxVarintLength) {
+            mHeader[mHeaderSize++] = *mCur++;
+            result = decodeVarint(mHeader, mHeader + mHeaderSize, length);
+        }
+        if(result == 0 && mHeaderSize < MaxVarintLength) {
+            return Status::NeedMoreData;
+        }
+        mHeaderSize = 0;
+    }
+
+    if(result < 0 || length > mMaxFrameSize) {
+        mCorrupt = true;
+        return Status::Corrupt;
+    }
+    mFrameSize = length;
+    mHaveLength = true;
+    return Status::FrameReady;
+}
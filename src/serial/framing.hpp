@@ -0,0 +1,85 @@
+/*!
+    \file framing.hpp
+    \brief File to define length delimited framing and the FrameDecoder class
+*/
+
+#ifndef FRAMING_HPP
+#define FRAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "byte_array.hpp"
+#include "byte_view.hpp"
+#include "varint.hpp"
+
+/*!
+    \brief The largest frame a FrameDecoder accepts if no limit is given
+*/
+const std::size_t DefaultMaxFrameSize = 16 * 1024 * 1024;
+
+void appendFrame(ByteArray &out, const char *payload, std::size_t size);
+void appendFrame(ByteArray &out, const ByteView &payload);
+
+/*!
+    \brief Class which splits a byte stream arriving in pieces into frames
+
+    Each frame is a LEB128 varint length followed by that many payload bytes,
+    as written by appendFrame(). Input is given to feed() in chunks of any
+    size, such as the result of each read() on a non blocking socket, and
+    next() is called until it asks for more data:
+
+    \code
+    decoder.feed(ByteView(buffer, received));
+    ByteView frame;
+    FrameDecoder::Status status;
+    while((status = decoder.next(frame)) == FrameDecoder::Status::FrameReady) {
+        ByteStream stream(frame);
+        ...
+    }
+    if(status == FrameDecoder::Status::Corrupt) {
+        // close the connection
+    }
+    \endcode
+
+    Frames which lie wholly inside a chunk are returned as views into it
+    without copying. Only the incomplete frame at the end of a chunk is copied,
+    into a buffer reserved once its length is known, and every input byte is
+    looked at once. A frame stays valid until the next call to next(), feed()
+    or reset(). The chunk must stay valid until next() returns NeedMoreData.
+*/
+class FrameDecoder {
+public:
+    enum class Status {
+        FrameReady,
+        NeedMoreData,
+        Corrupt
+    };
+
+    explicit FrameDecoder(std::size_t maxFrameSize = DefaultMaxFrameSize);
+
+    void feed(const char *data, std::size_t size);
+    void feed(const ByteView &chunk);
+    Status next(ByteView &frame);
+
+    std::size_t buffered() const;
+    std::size_t maxFrameSize() const;
+    bool isCorrupt() const;
+    void reset();
+
+private:
+    Status readHeader();
+
+    std::size_t mMaxFrameSize; //!< frames longer than this are corrupt
+    const char *mCur; //!< the next unread byte of the current chunk
+    const char *mEnd; //!< one past the last byte of the current chunk
+    char mHeader[MaxVarintLength]; //!< the bytes of a length split across chunks
+    int mHeaderSize; //!< the number of bytes in mHeader
+    bool mHaveLength; //!< true once the length of the next frame is known
+    uint64_t mFrameSize; //!< the length of the next frame when mHaveLength
+    ByteArray mPending; //!< the payload of a frame split across chunks
+    bool mPendingReturned; //!< true if mPending was returned and must be cleared
+    bool mCorrupt; //!< true once a bad length was read, until reset()
+};
+
+#endif // FRAMING_HPP
@@ -0,0 +1,147 @@
+/*!
+    \file instrumentation.cpp
+    \brief file to implement the counters of what streams and arrays do
+*/
+#include "instrumentation.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+/*!
+    \brief Constructs counters which are all 0
+*/
+StreamCounters::StreamCounters() :
+bytesRead(0),
+bytesWritten(0),
+reads(),
+writes(),
+boundsFailures(0){
+
+}
+
+/*!
+    \brief Returns how many operations of a kind were counted
+    \param operation the kind of operation
+    \param direction whether to count the reads or the writes
+    \return the number of operations
+*/
+uint64_t StreamCounters::operations(StreamOperation operation, StreamDirection direction) const {
+    const int index = static_cast<int>(operation);
+    return direction == StreamDirection::Read ? reads[index] : writes[index];
+}
+
+/*!
+    \brief Constructs counters which are all 0
+*/
+GlobalCounters::GlobalCounters() :
+arrayReallocations(0),
+arrayBytesCopied(0){
+
+}
+
+#if SERIAL_ENABLE_INSTRUMENTATION
+namespace detail {
+thread_local std::atomic<uint64_t> tCounters[GlobalCounterCount];
+thread_local bool tCountersRegistered = false;
+}
+
+namespace {
+/*!
+    \brief The counters of every live thread, and the totals of the threads
+    which have exited
+*/
+struct CounterRegistry {
+    CounterRegistry() :
+    retired(){
+    }
+
+    std::mutex mutex; //!< guards threads and retired
+    std::vector<std::atomic<uint64_t>*> threads; //!< the counters of the live threads
+    uint64_t retired[detail::GlobalCounterCount]; //!< the totals of exited threads
+};
+
+/*!
+    \brief Returns the registry, which is never destroyed since threads may
+    exit after static destructors have run
+*/
+CounterRegistry& counterRegistry() {
+    static CounterRegistry *registry = new CounterRegistry();
+    return *registry;
+}
+
+/*!
+    \brief Lists the counters of a thread in the registry for its lifetime
+
+    When the thread exits its counts are added to the retired totals. Counts
+    made by thread_local destructors running after that are lost.
+*/
+struct ThreadRegistration {
+    ThreadRegistration() {
+        CounterRegistry &registry = counterRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        registry.threads.push_back(detail::tCounters);
+    }
+
+    ~ThreadRegistration() {
+        CounterRegistry &registry = counterRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for(int i = 0; i < detail::GlobalCounterCount; ++i) {
+            registry.retired[i] += detail::tCounters[i].load(std::memory_order_relaxed);
+        }
+        registry.threads.erase(std::find(registry.threads.begin(), registry.threads.end(),
+                                         detail::tCounters));
+    }
+};
+}
+
+/*!
+    \brief Lists the counters of the calling thread, the first time it counts
+*/
+void detail::registerThreadCounters() {
+    static thread_local ThreadRegistration registration;
+    tCountersRegistered = true;
+}
+
+/*!
+    \brief Adds up the counters of every thread
+
+    Each counter is read atomically but not all at once, so counts made while
+    this runs may be partly included.
+
+    \return the counts of the whole process so far
+*/
+GlobalCounters globalCounters() {
+    uint64_t totals[detail::GlobalCounterCount];
+    {
+        CounterRegistry &registry = counterRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        std::copy(registry.retired, registry.retired + detail::GlobalCounterCount, totals);
+        for(std::atomic<uint64_t> *counters : registry.threads) {
+            for(int i = 0; i < detail::GlobalCounterCount; ++i) {
+                totals[i] += counters[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    GlobalCounters counters;
+    counters.streams.bytesRead = totals[detail::BytesReadCounter];
+    counters.streams.bytesWritten = totals[detail::BytesWrittenCounter];
+    counters.streams.boundsFailures = totals[detail::BoundsFailuresCounter];
+    for(int i = 0; i < StreamOperationCount; ++i) {
+        counters.streams.reads[i] = totals[detail::ReadOperationsCounter + i];
+        counters.streams.writes[i] = totals[detail::WriteOperationsCounter + i];
+    }
+    counters.arrayReallocations = totals[detail::ArrayReallocationsCounter];
+    counters.arrayBytesCopied = totals[detail::ArrayBytesCopiedCounter];
+    return counters;
+}
+#else
+/*!
+    \brief Adds up the counters of every thread
+    \return all 0, as the library was built without instrumentation
+*/
+GlobalCounters globalCounters() {
+    return GlobalCounters();
+}
+#endif
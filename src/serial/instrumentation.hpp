@@ -0,0 +1,129 @@
+/*!
+    \file instrumentation.hpp
+    \brief File to define the counters of what streams and arrays do
+
+    Counting is off unless SERIAL_ENABLE_INSTRUMENTATION is defined to 1, in
+    which case ByteStream and ByteArray count their bytes, operations, bounds
+    failures, reallocations and copies. When it is off the counting compiles
+    away entirely and every counter reads 0. The library and the code using it
+    must agree on the setting, the SERIAL_ENABLE_INSTRUMENTATION CMake option
+    takes care of that.
+*/
+
+#ifndef INSTRUMENTATION_HPP
+#define INSTRUMENTATION_HPP
+
+#include <atomic>
+#include <cstdint>
+
+#ifndef SERIAL_ENABLE_INSTRUMENTATION
+    #define SERIAL_ENABLE_INSTRUMENTATION 0
+#endif
+
+//! True when the library was built to count, see instrumentation.hpp
+const bool InstrumentationEnabled = SERIAL_ENABLE_INSTRUMENTATION != 0;
+
+/*!
+    \brief The kinds of operation a ByteStream counts
+
+    An operation built on others, like a string writing its length as a
+    varint, counts once as the outermost kind.
+*/
+enum class StreamOperation {
+    Integer, //!< the integer operators, in either encoding
+    FloatingPoint, //!< the float and double operators
+    Boolean, //!< the bool operators
+    String, //!< writeString(), readStringView() and the string operators
+    Varint, //!< the varint functions called directly
+    RawData, //!< writeRawData(), readRawData(), writeBytes() and skipRawData()
+    Array, //!< writeArray() and readArray()
+    Batch //!< a WriteBatch or ReadBatch
+};
+
+//! The number of kinds of StreamOperation
+const int StreamOperationCount = 8;
+
+/*!
+    \brief Which way the data of a counted operation goes
+*/
+enum class StreamDirection {
+    Read,
+    Write
+};
+
+/*!
+    \brief What one ByteStream, or every stream together, has done
+*/
+struct StreamCounters {
+    StreamCounters();
+
+    uint64_t operations(StreamOperation operation, StreamDirection direction) const;
+
+    uint64_t bytesRead; //!< the bytes read, peeked at as views or skipped
+    uint64_t bytesWritten; //!< the bytes written
+    uint64_t reads[StreamOperationCount]; //!< the read operations by StreamOperation
+    uint64_t writes[StreamOperationCount]; //!< the write operations by StreamOperation
+    uint64_t boundsFailures; //!< the times an operation ran past the end
+};
+
+/*!
+    \brief What every stream and array of the process has done
+*/
+struct GlobalCounters {
+    GlobalCounters();
+
+    StreamCounters streams; //!< the counters of every ByteStream added up
+    uint64_t arrayReallocations; //!< the times a ByteArray moved to new storage
+    uint64_t arrayBytesCopied; //!< the bytes copied by append() and copying a ByteArray
+};
+
+GlobalCounters globalCounters();
+
+namespace detail {
+/*!
+    \brief The index of each counter in the counters of a thread
+
+    The operations take StreamOperationCount counters each, from
+    ReadOperationsCounter and WriteOperationsCounter on.
+*/
+enum GlobalCounter {
+    BytesReadCounter,
+    BytesWrittenCounter,
+    BoundsFailuresCounter,
+    ArrayReallocationsCounter,
+    ArrayBytesCopiedCounter,
+    ReadOperationsCounter,
+    WriteOperationsCounter = ReadOperationsCounter + StreamOperationCount,
+    GlobalCounterCount = WriteOperationsCounter + StreamOperationCount
+};
+
+#if SERIAL_ENABLE_INSTRUMENTATION
+extern thread_local std::atomic<uint64_t> tCounters[GlobalCounterCount];
+extern thread_local bool tCountersRegistered;
+
+void registerThreadCounters();
+
+/*!
+    \brief Adds to a counter of the calling thread
+
+    Only the owning thread writes its counters, so a relaxed load and store do
+    without a locked instruction, and globalCounters() can still read them from
+    any thread.
+
+    \param counter the counter to add to
+    \param amount the amount to add
+*/
+inline void addCounter(int counter, uint64_t amount) {
+    if(!tCountersRegistered) {
+        registerThreadCounters();
+    }
+    std::atomic<uint64_t> &value = tCounters[counter];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+#else
+inline void addCounter(int, uint64_t) {
+}
+#endif
+}
+
+#endif // INSTRUMENTATION_HPP
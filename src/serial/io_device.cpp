@@ -0,0 +1,320 @@
+/*!
+    \file io_device.cpp
+    \brief file to implement the IODevice interface and the file devices
+*/
+#include "io_device.hpp"
+
+#include <cerrno>
+#include <fcntl.h>
+
+#ifdef WIN32
+    #include <io.h>
+#else
+    #include <climits>
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+#if !defined(WIN32) && !defined(IOV_MAX)
+    #define IOV_MAX 1024
+#endif
+
+#ifndef O_BINARY
+    #define O_BINARY 0
+#endif
+
+/*!
+    \brief Default destructor for the IODevice interface
+*/
+IODevice::~IODevice() = default;
+
+/*!
+    \brief Writes all of count parts, one after the other
+
+    The default writes the parts one at a time, devices which can gather them
+    in one call override it.
+
+    \param parts the bytes to write
+    \param count the number of parts
+    \return the number of bytes written, -1 on error
+*/
+int64_t IODevice::writeVectored(const ByteView* parts, std::size_t count) {
+    int64_t total = 0;
+    for(std::size_t i = 0; i < count; i++) {
+        if(write(parts[i].data(), parts[i].size()) < 0) {
+            return -1;
+        }
+        total += static_cast<int64_t>(parts[i].size());
+    }
+    return total;
+}
+
+/*!
+    \brief Pushes any data the device buffers itself towards its destination
+
+    The default does nothing, for devices which don't buffer.
+
+    \return true if the data was flushed, otherwise false
+*/
+bool IODevice::flush() {
+    return true;
+}
+
+/*!
+    \brief Creates a device which has counted nothing yet
+*/
+NullDevice::NullDevice()
+: mSize(0){
+
+}
+
+/*!
+    \brief Reads nothing, a NullDevice is always at its end
+    \return 0
+*/
+int64_t NullDevice::read(char*, uint64_t) {
+    return 0;
+}
+
+/*!
+    \brief Counts size bytes without looking at them
+    \param size the number of bytes written
+    \return size
+*/
+int64_t NullDevice::write(const char*, uint64_t size) {
+    mSize += size;
+    return static_cast<int64_t>(size);
+}
+
+/*!
+    \brief Counts the bytes of count parts without looking at them
+    \param parts the bytes written
+    \param count the number of parts
+    \return the number of bytes in the parts
+*/
+int64_t NullDevice::writeVectored(const ByteView* parts, std::size_t count) {
+    uint64_t total = 0;
+    for(std::size_t i = 0; i < count; i++) {
+        total += parts[i].size();
+    }
+    mSize += total;
+    return static_cast<int64_t>(total);
+}
+
+/*!
+    \brief Returns the number of bytes written to the device
+    \return the number of bytes counted
+*/
+uint64_t NullDevice::size() const {
+    return mSize;
+}
+
+/*!
+    \brief Sets the count back to zero
+*/
+void NullDevice::reset() {
+    mSize = 0;
+}
+
+/*!
+    \brief Creates a device for an open file descriptor
+    \param fd the file descriptor to read and write
+    \param takeOwnership true to close fd when the device is destroyed
+*/
+FileDescriptorDevice::FileDescriptorDevice(int fd, bool takeOwnership)
+: mFd(fd),
+  mOwned(takeOwnership){
+
+}
+
+/*!
+    \brief Creates a device without a file descriptor
+*/
+FileDescriptorDevice::FileDescriptorDevice()
+: FileDescriptorDevice(-1, false){
+
+}
+
+/*!
+    \brief Closes the file descriptor if the device owns it
+*/
+FileDescriptorDevice::~FileDescriptorDevice() {
+    close();
+}
+
+/*!
+    \brief Reads up to maxSize bytes, retrying if interrupted by a signal
+    \param data where to store the bytes
+    \param maxSize the most bytes to read
+    \return the number of bytes read, 0 at the end of the file, -1 on error
+*/
+int64_t FileDescriptorDevice::read(char* data, uint64_t maxSize) {
+    while(true) {
+        const int64_t result = ::read(mFd, data, maxSize);
+        if(result >= 0 || errno != EINTR) {
+            return result;
+        }
+    }
+}
+
+/*!
+    \brief Writes all size bytes, retrying short writes and signal interruptions
+    \param data the bytes to write
+    \param size the number of bytes to write
+    \return size, or -1 on error
+*/
+int64_t FileDescriptorDevice::write(const char* data, uint64_t size) {
+    uint64_t written = 0;
+    while(written < size) {
+        const int64_t result = ::write(mFd, data + written, size - written);
+        if(result < 0 && errno == EINTR) {
+            continue;
+        } else if(result <= 0) {
+            // Writing nothing would only repeat forever
+            return -1;
+        }
+        written += static_cast<uint64_t>(result);
+    }
+    return static_cast<int64_t>(written);
+}
+
+/*!
+    \brief Writes all of count parts with as few writev() calls as possible
+
+    Up to IOV_MAX parts are passed to each call, and short writes are resumed
+    where they stopped.
+
+    \param parts the bytes to write
+    \param count the number of parts
+    \return the number of bytes written, or -1 on error
+*/
+int64_t FileDescriptorDevice::writeVectored(const ByteView* parts, std::size_t count) {
+#ifdef WIN32
+    return IODevice::writeVectored(parts, count);
+#else
+    iovec vectors[IOV_MAX < 1024 ? IOV_MAX : 1024];
+    const std::size_t maxVectors = sizeof(vectors) / sizeof(vectors[0]);
+
+    int64_t total = 0;
+    std::size_t part = 0;
+    std::size_t offset = 0; // bytes of parts[part] already written
+    while(part < count) {
+        std::size_t used = 0;
+        std::size_t pending = 0;
+        for(std::size_t i = part; i < count && used < maxVectors; i++) {
+            const std::size_t skip = i == part ? offset : 0;
+            vectors[used].iov_base = const_cast<char*>(parts[i].data() + skip);
+            vectors[used].iov_len = parts[i].size() - skip;
+            pending += vectors[used].iov_len;
+            used++;
+        }
+
+        ssize_t result = ::writev(mFd, vectors, static_cast<int>(used));
+        if(result < 0 && errno == EINTR) {
+            continue;
+        } else if(result < 0 || (result == 0 && pending > 0)) {
+            // Writing nothing would only repeat forever, only empty parts may
+            return -1;
+        }
+        total += result;
+
+        // Skip over the parts that were written completely
+        std::size_t written = static_cast<std::size_t>(result);
+        while(part < count && written >= parts[part].size() - offset) {
+            written -= parts[part].size() - offset;
+            offset = 0;
+            part++;
+        }
+        offset += written;
+    }
+    return total;
+#endif
+}
+
+/*!
+    \brief Waits until the written data has reached the storage device
+    \return true if the data was synced, otherwise false
+*/
+bool FileDescriptorDevice::sync() {
+#ifdef WIN32
+    return _commit(mFd) == 0;
+#else
+    return fsync(mFd) == 0;
+#endif
+}
+
+/*!
+    \brief Returns the file descriptor of the device
+    \return the file descriptor, -1 if there is none
+*/
+int FileDescriptorDevice::fd() const {
+    return mFd;
+}
+
+/*!
+    \brief Returns true if the device has a file descriptor
+    \return true if open, otherwise false
+*/
+bool FileDescriptorDevice::isOpen() const {
+    return mFd >= 0;
+}
+
+/*!
+    \brief Closes the file descriptor if owned, and detaches from it
+*/
+void FileDescriptorDevice::close() {
+    if(mFd >= 0 && mOwned) {
+        ::close(mFd);
+    }
+    mFd = -1;
+    mOwned = false;
+}
+
+/*!
+    \brief Creates a file device which isn't open
+*/
+FileDevice::FileDevice()
+: FileDescriptorDevice(){
+
+}
+
+/*!
+    \brief Opens the file at path, see open()
+    \param path the file to open
+    \param mode how to open the file
+*/
+FileDevice::FileDevice(const std::string& path, Mode mode)
+: FileDescriptorDevice(){
+    open(path, mode);
+}
+
+/*!
+    \brief Opens the file at path, closing any file that was open
+
+    WriteOnly creates or truncates the file, Append creates it or writes after
+    its existing contents.
+
+    \param path the file to open
+    \param mode how to open the file
+    \return true if the file was opened, otherwise false
+*/
+bool FileDevice::open(const std::string& path, Mode mode) {
+    close();
+
+    int flags = O_BINARY;
+    switch(mode) {
+        case Mode::ReadOnly:
+            flags |= O_RDONLY;
+            break;
+        case Mode::WriteOnly:
+            flags |= O_WRONLY | O_CREAT | O_TRUNC;
+            break;
+        case Mode::Append:
+            flags |= O_WRONLY | O_CREAT | O_APPEND;
+            break;
+    }
+
+    mFd = ::open(path.c_str(), flags, 0644);
+    mOwned = true;
+    return mFd >= 0;
+}
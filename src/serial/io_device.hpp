@@ -0,0 +1,112 @@
+/*!
+    \file io_device.hpp
+    \brief File to define the IODevice interface and the file devices
+*/
+
+#ifndef IO_DEVICE_HPP
+#define IO_DEVICE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "byte_view.hpp"
+
+/*!
+    \brief Interface for a sequential source or sink of bytes
+
+    A ByteStream set to an IODevice buffers the data itself, so devices only
+    see large reads and writes.
+*/
+class IODevice {
+public:
+    virtual ~IODevice();
+
+    /*!
+        \brief Reads up to maxSize bytes into data
+        \param data where to store the bytes
+        \param maxSize the most bytes to read
+        \return the number of bytes read, 0 at the end of the data, -1 on error
+    */
+    virtual int64_t read(char *data, uint64_t maxSize) = 0;
+
+    /*!
+        \brief Writes all size bytes of data
+        \param data the bytes to write
+        \param size the number of bytes to write
+        \return the number of bytes written, -1 on error
+    */
+    virtual int64_t write(const char *data, uint64_t size) = 0;
+
+    virtual int64_t writeVectored(const ByteView *parts, std::size_t count);
+
+    virtual bool flush();
+};
+
+/*!
+    \brief Device which throws away what is written and only counts it
+
+    Writing a value into a ByteStream set to a NullDevice measures how large
+    its encoding is, without storing it.
+*/
+class NullDevice : public IODevice {
+public:
+    NullDevice();
+
+    int64_t read(char *data, uint64_t maxSize) override;
+    int64_t write(const char *data, uint64_t size) override;
+    int64_t writeVectored(const ByteView *parts, std::size_t count) override;
+
+    uint64_t size() const;
+    void reset();
+
+private:
+    uint64_t mSize; //!< the number of bytes written
+};
+
+/*!
+    \brief Device which reads and writes a POSIX file descriptor
+*/
+class FileDescriptorDevice : public IODevice {
+public:
+    explicit FileDescriptorDevice(int fd, bool takeOwnership = false);
+    ~FileDescriptorDevice() override;
+
+    FileDescriptorDevice(const FileDescriptorDevice &other) = delete;
+    FileDescriptorDevice& operator=(const FileDescriptorDevice &other) = delete;
+
+    int64_t read(char *data, uint64_t maxSize) override;
+    int64_t write(const char *data, uint64_t size) override;
+    int64_t writeVectored(const ByteView *parts, std::size_t count) override;
+
+    bool sync();
+
+    int fd() const;
+    bool isOpen() const;
+    void close();
+
+protected:
+    FileDescriptorDevice();
+
+    int mFd; //!< the file descriptor, -1 if there is none
+    bool mOwned; //!< true if the descriptor is closed with the device
+};
+
+/*!
+    \brief Device which opens a file by path and owns its descriptor
+*/
+class FileDevice : public FileDescriptorDevice {
+public:
+    enum class Mode {
+        ReadOnly,
+        WriteOnly,
+        Append
+    };
+
+    FileDevice();
+    FileDevice(const std::string &path, Mode mode);
+
+    bool open(const std::string &path, Mode mode);
+};
+
+#endif // IO_DEVICE_HPP
@@ -0,0 +1,721 @@
+/*!
+    \file io_queue.cpp
+    \brief file to implement the IOQueue class
+*/
+#include "io_queue.hpp"
+#include "byte_allocator.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unordered_map>
+
+#ifndef WIN32
+    #include <sys/uio.h>
+    #include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #define SERIAL_HAVE_IO_URING 1
+    #endif
+#endif
+
+#ifdef SERIAL_HAVE_IO_URING
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+#endif
+
+#ifdef SERIAL_HAVE_IO_URING
+/*!
+    \brief An io_uring set up with the raw system calls
+
+    The submission and completion rings are shared with the kernel, the tail of
+    the submission ring and the head of the completion ring are ours to move,
+    the other two are the kernel's.
+*/
+class IOQueue::Ring {
+public:
+    /*!
+        \brief Sets up a ring of entries submissions
+        \return the ring, nullptr if the kernel doesn't support io_uring or
+        doesn't allow it
+    */
+    static std::unique_ptr<Ring> create(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const int fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if(fd < 0) {
+            return std::unique_ptr<Ring>();
+        }
+
+        std::unique_ptr<Ring> ring(new Ring(fd));
+        if(!ring->map(params)) {
+            return std::unique_ptr<Ring>();
+        }
+        ring->mIovecs.resize(entries);
+        return ring;
+    }
+
+    ~Ring() {
+        if(mSqes) {
+            munmap(mSqes, mSqesSize);
+        }
+        if(mCqRing && mCqRing != mSqRing) {
+            munmap(mCqRing, mCqRingSize);
+        }
+        if(mSqRing) {
+            munmap(mSqRing, mSqRingSize);
+        }
+        ::close(mFd);
+    }
+
+    bool registerBuffers(const std::vector<iovec> &buffers) {
+        return syscall(__NR_io_uring_register, mFd, IORING_REGISTER_BUFFERS,
+                       buffers.data(), static_cast<unsigned>(buffers.size())) == 0;
+    }
+
+    /*!
+        \brief Adds the rest of a request to the submission ring
+        \param slot the slot of the request, returned with its completion
+        \param request the request
+        \param bufferIndex the registered buffer it lies in, -1 if none
+    */
+    void prepare(std::size_t slot, Request &request, int bufferIndex) {
+        const unsigned tail = *mSqTail;
+        const unsigned index = tail & *mSqMask;
+        io_uring_sqe& sqe = mSqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+
+        char* data = request.buffer.begin() + request.done;
+        const unsigned size = static_cast<unsigned>(request.length - request.done);
+        const bool write = request.operation == Operation::Write;
+        sqe.fd = request.fd;
+        sqe.off = request.offset + static_cast<uint64_t>(request.done);
+        sqe.user_data = slot;
+        if(bufferIndex >= 0) {
+            sqe.opcode = write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe.addr = reinterpret_cast<uint64_t>(data);
+            sqe.len = size;
+            sqe.buf_index = static_cast<uint16_t>(bufferIndex);
+        } else {
+            // The vectored forms work on every kernel with io_uring
+            iovec& vector = mIovecs[slot];
+            vector.iov_base = data;
+            vector.iov_len = size;
+            sqe.opcode = write ? IORING_OP_WRITEV : IORING_OP_READV;
+            sqe.addr = reinterpret_cast<uint64_t>(&vector);
+            sqe.len = 1;
+        }
+
+        mSqArray[index] = index;
+        __atomic_store_n(mSqTail, tail + 1, __ATOMIC_RELEASE);
+        mUnsubmitted++;
+    }
+
+    /*!
+        \brief Submits everything prepared, and waits for minComplete completions
+        \return the number submitted, or -errno
+    */
+    int enter(unsigned minComplete) {
+        const unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+        int result;
+        do {
+            result = static_cast<int>(syscall(__NR_io_uring_enter, mFd, mUnsubmitted,
+                                              minComplete, flags, nullptr, 0));
+        } while(result < 0 && errno == EINTR);
+        if(result < 0) {
+            return -errno;
+        }
+        mUnsubmitted -= std::min(mUnsubmitted, static_cast<unsigned>(result));
+        return result;
+    }
+
+    /*!
+        \brief Takes the next completion off the completion ring
+        \return false if there is none
+    */
+    bool nextCompletion(uint64_t &slot, int32_t &result) {
+        const unsigned head = *mCqHead;
+        if(head == __atomic_load_n(mCqTail, __ATOMIC_ACQUIRE)) {
+            return false;
+        }
+        const io_uring_cqe& cqe = mCqes[head & *mCqMask];
+        slot = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(mCqHead, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    unsigned unsubmitted() const {
+        return mUnsubmitted;
+    }
+
+private:
+    explicit Ring(int fd) :
+    mFd(fd),
+    mSqRing(nullptr),
+    mCqRing(nullptr),
+    mSqes(nullptr),
+    mUnsubmitted(0){
+    }
+
+    bool map(const io_uring_params &params) {
+        mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if(single) {
+            mSqRingSize = mCqRingSize = std::max(mSqRingSize, mCqRingSize);
+        }
+
+        void* sq = mmap(nullptr, mSqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        mFd, IORING_OFF_SQ_RING);
+        if(sq == MAP_FAILED) {
+            return false;
+        }
+        mSqRing = static_cast<char*>(sq);
+
+        if(single) {
+            mCqRing = mSqRing;
+        } else {
+            void* cq = mmap(nullptr, mCqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            mFd, IORING_OFF_CQ_RING);
+            if(cq == MAP_FAILED) {
+                return false;
+            }
+            mCqRing = static_cast<char*>(cq);
+        }
+
+        mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, mSqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          mFd, IORING_OFF_SQES);
+        if(sqes == MAP_FAILED) {
+            return false;
+        }
+        mSqes = static_cast<io_uring_sqe*>(sqes);
+
+        mSqTail = reinterpret_cast<unsigned*>(mSqRing + params.sq_off.tail);
+        mSqMask = reinterpret_cast<unsigned*>(mSqRing + params.sq_off.ring_mask);
+        mSqArray = reinterpret_cast<unsigned*>(mSqRing + params.sq_off.array);
+        mCqHead = reinterpret_cast<unsigned*>(mCqRing + params.cq_off.head);
+        mCqTail = reinterpret_cast<unsigned*>(mCqRing + params.cq_off.tail);
+        mCqMask = reinterpret_cast<unsigned*>(mCqRing + params.cq_off.ring_mask);
+        mCqes = reinterpret_cast<io_uring_cqe*>(mCqRing + params.cq_off.cqes);
+        return true;
+    }
+
+    int mFd; //!< the io_uring file descriptor
+    char *mSqRing; //!< the mapping of the submission ring
+    char *mCqRing; //!< the mapping of the completion ring, may be mSqRing
+    io_uring_sqe *mSqes; //!< the mapping of the submission entries
+    std::size_t mSqRingSize;
+    std::size_t mCqRingSize;
+    std::size_t mSqesSize;
+    unsigned *mSqTail;
+    unsigned *mSqMask;
+    unsigned *mSqArray;
+    unsigned *mCqHead;
+    unsigned *mCqTail;
+    unsigned *mCqMask;
+    io_uring_cqe *mCqes;
+    unsigned mUnsubmitted; //!< entries prepared but not passed to the kernel
+    std::vector<iovec> mIovecs; //!< the vector of each slot's vectored request
+};
+#else
+/*!
+    \brief Stands in for the io_uring where there is none, it is never created
+*/
+class IOQueue::Ring {
+public:
+    void prepare(std::size_t, Request&, int) {}
+    int enter(unsigned) { return 0; }
+    bool nextCompletion(uint64_t&, int32_t&) { return false; }
+    unsigned unsubmitted() const { return 0; }
+};
+#endif
+
+/*!
+    \brief Allocator which owns the buffers from registerBuffers()
+
+    A registered buffer goes back on the free list when its array frees it and
+    is never given back to the heap, so an address in one always means the
+    registered storage, never a newer allocation at the same address. Arrays
+    which outgrow their buffer get the rest from the heap.
+
+    Arrays may outlive the queue and free their buffers on any thread. The
+    queue releases the store when it is destroyed, and the store deletes
+    itself once no array uses it.
+*/
+class IOQueue::BufferStore : public ByteAllocator {
+public:
+    BufferStore(std::size_t count, std::size_t size) :
+    mSize(size),
+    mOutstanding(0),
+    mReleased(false){
+        for(std::size_t i = 0; i < count; i++) {
+            mBuffers.emplace_back(new char[size]);
+            mIndex[mBuffers.back().get()] = static_cast<int>(i);
+        }
+        for(std::size_t i = count; i > 0; i--) {
+            mFree.push_back(mBuffers[i - 1].get());
+        }
+    }
+
+    BufferStore(const BufferStore &other) = delete;
+    BufferStore& operator=(const BufferStore &other) = delete;
+
+    char* allocate(std::size_t &size) override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOutstanding++;
+        if(size <= mSize && !mFree.empty()) {
+            char* buffer = mFree.back();
+            mFree.pop_back();
+            size = mSize;
+            return buffer;
+        }
+        return new char[size];
+    }
+
+    void deallocate(char *data, std::size_t) override {
+        bool unused;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if(index(data) >= 0) {
+                mFree.push_back(data);
+            } else {
+                delete[] data;
+            }
+            mOutstanding--;
+            unused = mReleased && mOutstanding == 0;
+        }
+        if(unused) {
+            delete this;
+        }
+    }
+
+    /*!
+        \brief Gives up the queue's hold on the store, deleting it if no array
+        uses it
+    */
+    void release() {
+        bool unused;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mReleased = true;
+            unused = mOutstanding == 0;
+        }
+        if(unused) {
+            delete this;
+        }
+    }
+
+    /*!
+        \brief Returns the index of the registered buffer starting at data, -1
+        if there is none
+    */
+    int index(const char *data) const {
+        const std::unordered_map<const char*, int>::const_iterator found = mIndex.find(data);
+        return found == mIndex.end() ? -1 : found->second;
+    }
+
+    char* buffer(std::size_t index) const {
+        return mBuffers[index].get();
+    }
+
+    std::size_t freeBuffers() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mFree.size();
+    }
+
+private:
+    ~BufferStore() override = default;
+
+    std::size_t mSize; //!< the size of each buffer
+    std::vector<std::unique_ptr<char[]>> mBuffers; //!< the buffers, by index
+    std::unordered_map<const char*, int> mIndex; //!< buffer index by address
+    mutable std::mutex mMutex; //!< guards the members below
+    std::vector<char*> mFree; //!< the buffers no array holds
+    std::size_t mOutstanding; //!< the allocations not deallocated yet
+    bool mReleased; //!< true once the queue is destroyed
+};
+
+/*!
+    \brief Constructs a queue, using io_uring if asked for and available
+    \param depth the most requests queued or in flight at once
+    \param backend IoUring to use io_uring where possible, ThreadPool to never
+*/
+IOQueue::IOQueue(unsigned depth, IOQueue::Backend backend) :
+mDepth(std::max(depth, 1u)),
+mRequests(std::max(depth, 1u)),
+mInFlight(0),
+mStore(nullptr),
+mKernelBuffers(false),
+mRegisteredSize(0){
+#ifdef SERIAL_HAVE_IO_URING
+    if(backend == Backend::IoUring) {
+        mRing = Ring::create(mDepth);
+    }
+#else
+    (void)backend;
+#endif
+    if(!mRing) {
+        mPool.reset(new ThreadPool(std::min(mDepth, 16u)));
+    }
+
+    for(std::size_t slot = mDepth; slot > 0; slot--) {
+        mFreeSlots.push_back(slot - 1);
+    }
+}
+
+/*!
+    \brief Waits for every submitted request to complete, since they still use
+    the buffers, and drops the ones queued and not submitted
+
+    Registered buffers taken from the queue stay valid.
+*/
+IOQueue::~IOQueue() {
+    std::vector<Completion> completions;
+    while(mInFlight > 0) {
+        wait(completions, mInFlight);
+        completions.clear();
+    }
+    mPool.reset();
+    mRing.reset();
+    if(mStore) {
+        mStore->release();
+    }
+}
+
+/*!
+    \brief Returns true if this system can run an IOQueue on io_uring
+*/
+bool IOQueue::ioUringAvailable() {
+#ifdef SERIAL_HAVE_IO_URING
+    static const bool available = static_cast<bool>(Ring::create(2));
+    return available;
+#else
+    return false;
+#endif
+}
+
+/*!
+    \brief Returns the backend the queue runs on
+*/
+IOQueue::Backend IOQueue::backend() const {
+    return mRing ? Backend::IoUring : Backend::ThreadPool;
+}
+
+/*!
+    \brief Returns the most requests queued or in flight at once
+*/
+unsigned IOQueue::depth() const {
+    return mDepth;
+}
+
+/*!
+    \brief Returns the number of requests queued or submitted which haven't
+    been returned as completions yet
+*/
+std::size_t IOQueue::inFlight() const {
+    return mInFlight + mQueued.size();
+}
+
+/*!
+    \brief Allocates count buffers of size bytes for takeBuffer()
+
+    With io_uring the buffers are registered with the kernel, which maps them
+    once rather than on every transfer. Reads and writes which lie in a buffer
+    from takeBuffer() use them automatically. Can only be done once.
+
+    \param count the number of buffers
+    \param size the capacity of each buffer, larger than
+    ByteArray::InlineCapacity since smaller data moves into the array itself
+    \return false if buffers were registered already or size is too small, or
+    the kernel refused them; they can still be used then, just without the
+    saving
+*/
+bool IOQueue::registerBuffers(std::size_t count, int size) {
+    if(mRegisteredSize > 0 || size <= ByteArray::InlineCapacity) {
+        return false;
+    }
+
+    mRegisteredSize = size;
+    mStore = new BufferStore(count, static_cast<std::size_t>(size));
+#ifdef SERIAL_HAVE_IO_URING
+    std::vector<iovec> vectors(count);
+    for(std::size_t i = 0; i < count; i++) {
+        vectors[i].iov_base = mStore->buffer(i);
+        vectors[i].iov_len = static_cast<std::size_t>(size);
+    }
+    mKernelBuffers = mRing && mRing->registerBuffers(vectors);
+#endif
+    return mKernelBuffers || mRing == nullptr;
+}
+
+/*!
+    \brief Takes an empty buffer made by registerBuffers()
+    \return the buffer, or an empty array with no buffer if none are free
+*/
+ByteArray IOQueue::takeBuffer() {
+    if(!mStore || mStore->freeBuffers() == 0) {
+        return ByteArray();
+    }
+    ByteArray buffer(mStore);
+    buffer.reserve(mRegisteredSize);
+    return buffer;
+}
+
+/*!
+    \brief Gives back a buffer from takeBuffer(), usually from a completion
+
+    Destroying the buffer gives its storage back just the same. Buffers from
+    elsewhere are dropped.
+
+    \param buffer the buffer, left empty
+*/
+void IOQueue::returnBuffer(ByteArray &&buffer) {
+    buffer = ByteArray();
+}
+
+/*!
+    \brief Returns the number of buffers takeBuffer() can hand out
+*/
+std::size_t IOQueue::freeBuffers() const {
+    return mStore ? mStore->freeBuffers() : 0;
+}
+
+/*!
+    \brief Queues a write of all of buffer at offset in fd
+
+    Short writes are resumed until everything is written or there is an error.
+
+    \param fd the file descriptor to write to
+    \param offset the offset in the file
+    \param buffer the bytes to write, handed back in the completion
+    \param tag a value to identify the write by in its completion
+    \return false if depth() requests are in flight, buffer is untouched then
+*/
+bool IOQueue::queueWrite(int fd, uint64_t offset, ByteArray &&buffer, uint64_t tag) {
+    const int length = buffer.size();
+    return queue(Operation::Write, fd, offset, std::move(buffer), length, tag);
+}
+
+/*!
+    \brief Queues a read of up to size bytes at offset in fd into buffer
+
+    The buffer is replaced by what is read. A read is short only at the end of
+    the file.
+
+    \param fd the file descriptor to read from
+    \param offset the offset in the file
+    \param buffer the buffer to read into, handed back in the completion
+    \param size the most bytes to read
+    \param tag a value to identify the read by in its completion
+    \return false if depth() requests are in flight, buffer is untouched then
+*/
+bool IOQueue::queueRead(int fd, uint64_t offset, ByteArray &&buffer, int size, uint64_t tag) {
+    if(mFreeSlots.empty()) {
+        return false;
+    }
+    buffer.clear();
+    buffer.extend(std::max(size, 0));
+    return queue(Operation::Read, fd, offset, std::move(buffer), std::max(size, 0), tag);
+}
+
+/*!
+    \brief Starts every queued request
+    \return the number of requests started, or -errno if io_uring failed
+*/
+int IOQueue::submit() {
+    const int count = static_cast<int>(mQueued.size());
+    for(std::size_t slot : mQueued) {
+        if(mRing) {
+            mRing->prepare(slot, mRequests[slot], registeredIndex(mRequests[slot]));
+        } else {
+            mPool->submit([this, slot]() { perform(slot); });
+        }
+    }
+    mInFlight += mQueued.size();
+    mQueued.clear();
+
+    if(mRing && mRing->unsubmitted() > 0) {
+        const int result = mRing->enter(0);
+        if(result < 0) {
+            return result;
+        }
+    }
+    return count;
+}
+
+/*!
+    \brief Appends the requests which have completed to completions, without
+    waiting
+    \param completions the list to append to
+    \return the number of completions appended
+*/
+std::size_t IOQueue::poll(std::vector<Completion> &completions) {
+    return mRing ? reapRing(completions) : reapPool(completions, 0);
+}
+
+/*!
+    \brief Appends completed requests to completions, waiting for at least
+    minCount of them, or for every one in flight if there are fewer
+    \param completions the list to append to
+    \param minCount the number of completions to wait for
+    \return the number of completions appended
+*/
+std::size_t IOQueue::wait(std::vector<Completion> &completions, std::size_t minCount) {
+    minCount = std::min(minCount, mInFlight);
+    if(!mRing) {
+        return reapPool(completions, minCount);
+    }
+
+    std::size_t reaped = reapRing(completions);
+    while(reaped < minCount) {
+        const int result = mRing->enter(1);
+        if(result < 0 && result != -EBUSY) {
+            break;
+        }
+        reaped += reapRing(completions);
+    }
+    return reaped;
+}
+
+/*!
+    \brief Takes a free slot for a request and queues it
+*/
+bool IOQueue::queue(IOQueue::Operation operation, int fd, uint64_t offset, ByteArray &&buffer,
+                    int length, uint64_t tag) {
+    if(mFreeSlots.empty()) {
+        return false;
+    }
+
+    const std::size_t slot = mFreeSlots.back();
+    mFreeSlots.pop_back();
+    Request& request = mRequests[slot];
+    request.operation = operation;
+    request.fd = fd;
+    request.offset = offset;
+    request.tag = tag;
+    request.buffer = std::move(buffer);
+    request.length = length;
+    request.done = 0;
+    request.result = 0;
+    mQueued.push_back(slot);
+    return true;
+}
+
+/*!
+    \brief Returns the registered buffer the request's bytes lie in, -1 if none
+*/
+int IOQueue::registeredIndex(const IOQueue::Request &request) const {
+    if(!mKernelBuffers || request.length > mRegisteredSize) {
+        return -1;
+    }
+    return mStore->index(request.buffer.begin());
+}
+
+/*!
+    \brief Moves a finished request into completions and frees its slot
+*/
+void IOQueue::complete(std::size_t slot, std::vector<Completion> &completions) {
+    Request& request = mRequests[slot];
+    Completion completion;
+    completion.tag = request.tag;
+    completion.operation = request.operation;
+    completion.fd = request.fd;
+    completion.offset = request.offset;
+    completion.result = request.result;
+    completion.buffer = std::move(request.buffer);
+    if(request.operation == Operation::Read) {
+        completion.buffer.truncate(request.result > 0 ? static_cast<int>(request.result) : 0);
+    }
+    completions.push_back(std::move(completion));
+
+    mInFlight--;
+    mFreeSlots.push_back(slot);
+}
+
+/*!
+    \brief Runs a request with pread() or pwrite(), on a thread of the pool
+*/
+void IOQueue::perform(std::size_t slot) {
+    Request& request = mRequests[slot];
+    const bool write = request.operation == Operation::Write;
+    while(request.done < request.length) {
+        char* data = request.buffer.begin() + request.done;
+        const std::size_t size = static_cast<std::size_t>(request.length - request.done);
+        const off_t offset = static_cast<off_t>(request.offset + static_cast<uint64_t>(request.done));
+        const ssize_t result = write ? ::pwrite(request.fd, data, size, offset)
+                                     : ::pread(request.fd, data, size, offset);
+        if(result < 0 && errno == EINTR) {
+            continue;
+        } else if(result < 0) {
+            request.result = -errno;
+            break;
+        } else if(result == 0) {
+            break;
+        }
+        request.done += static_cast<int>(result);
+    }
+    if(request.result == 0) {
+        request.result = request.done;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished.push_back(slot);
+    }
+    mFinishedChanged.notify_one();
+}
+
+/*!
+    \brief Completes the requests on the completion ring, resubmitting the rest
+    of short reads and writes, as perform() does
+*/
+std::size_t IOQueue::reapRing(std::vector<Completion> &completions) {
+    std::size_t reaped = 0;
+    uint64_t slot;
+    int32_t result;
+    while(mRing->nextCompletion(slot, result)) {
+        Request& request = mRequests[static_cast<std::size_t>(slot)];
+        if(result > 0 && request.done + result < request.length) {
+            request.done += result;
+            mRing->prepare(static_cast<std::size_t>(slot), request, registeredIndex(request));
+            continue;
+        }
+
+        if(result < 0) {
+            request.result = result;
+        } else {
+            request.done += result;
+            request.result = request.done;
+        }
+        complete(static_cast<std::size_t>(slot), completions);
+        reaped++;
+    }
+
+    if(mRing->unsubmitted() > 0) {
+        mRing->enter(0);
+    }
+    return reaped;
+}
+
+/*!
+    \brief Completes the requests the thread pool finished, waiting for at
+    least minCount
+*/
+std::size_t IOQueue::reapPool(std::vector<Completion> &completions, std::size_t minCount) {
+    std::deque<std::size_t> finished;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mFinishedChanged.wait(lock, [this, minCount]() { return mFinished.size() >= minCount; });
+        finished.swap(mFinished);
+    }
+    for(std::size_t slot : finished) {
+        complete(slot, completions);
+    }
+    return finished.size();
+}
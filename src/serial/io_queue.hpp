@@ -0,0 +1,147 @@
+/*!
+    \file io_queue.hpp
+    \brief File to define the IOQueue class
+*/
+
+#ifndef IO_QUEUE_HPP
+#define IO_QUEUE_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "byte_array.hpp"
+
+class ThreadPool;
+
+/*!
+    \brief Queue of positioned file reads and writes which run asynchronously
+
+    Reads and writes are queued with the ByteArray they use, submitted in a
+    batch, and come back as completions holding the same ByteArray for reuse.
+    One thread can keep up to depth() of them in flight at once:
+
+    \code
+    IOQueue queue;
+    queue.registerBuffers(32, 1024 * 1024);
+    ByteArray buffer = queue.takeBuffer();
+    ... fill buffer ...
+    queue.queueWrite(fd, offset, std::move(buffer));
+    queue.submit();
+    std::vector<IOQueue::Completion> done;
+    queue.wait(done);
+    queue.returnBuffer(std::move(done[0].buffer));
+    \endcode
+
+    On Linux the queue uses io_uring when the kernel allows it, so a whole
+    batch costs a single system call, and buffers from registerBuffers() skip
+    the page pinning each transfer would otherwise do. Otherwise, or when asked
+    to, the reads and writes run as pread() and pwrite() on a pool of threads.
+    Either way the results are the same, short reads and writes are resumed.
+
+    The queue owns the storage of the registered buffers. A buffer's storage
+    goes back to the queue when its array is destroyed, returned, or grows out
+    of it, and arrays may outlive the queue.
+
+    A queue must be used from one thread at a time.
+*/
+class IOQueue {
+public:
+    enum class Backend {
+        IoUring,
+        ThreadPool
+    };
+
+    enum class Operation {
+        Read,
+        Write
+    };
+
+    /*!
+        \brief The result of a read or write
+    */
+    struct Completion {
+        uint64_t tag; //!< the tag the request was queued with
+        Operation operation; //!< whether it was a read or a write
+        int fd; //!< the file descriptor
+        uint64_t offset; //!< the offset in the file
+        ByteArray buffer; //!< the buffer, holding the bytes read for a read
+        int64_t result; //!< the number of bytes transferred, or -errno
+    };
+
+    //! The most requests in flight if no depth is given
+    static const unsigned DefaultDepth = 64;
+
+    explicit IOQueue(unsigned depth = DefaultDepth, Backend backend = Backend::IoUring);
+    ~IOQueue();
+
+    IOQueue(const IOQueue &other) = delete;
+    IOQueue& operator=(const IOQueue &other) = delete;
+
+    static bool ioUringAvailable();
+
+    Backend backend() const;
+    unsigned depth() const;
+    std::size_t inFlight() const;
+
+    bool registerBuffers(std::size_t count, int size);
+    ByteArray takeBuffer();
+    void returnBuffer(ByteArray &&buffer);
+    std::size_t freeBuffers() const;
+
+    bool queueWrite(int fd, uint64_t offset, ByteArray &&buffer, uint64_t tag = 0);
+    bool queueRead(int fd, uint64_t offset, ByteArray &&buffer, int size, uint64_t tag = 0);
+    int submit();
+
+    std::size_t poll(std::vector<Completion> &completions);
+    std::size_t wait(std::vector<Completion> &completions, std::size_t minCount = 1);
+
+private:
+    class Ring;
+    class BufferStore;
+
+    /*!
+        \brief A read or write which has been queued and not completed
+    */
+    struct Request {
+        Operation operation;
+        int fd;
+        uint64_t offset;
+        uint64_t tag;
+        ByteArray buffer;
+        int length; //!< the number of bytes to transfer
+        int done; //!< the number transferred so far, short transfers are resumed after it
+        int64_t result;
+    };
+
+    bool queue(Operation operation, int fd, uint64_t offset, ByteArray &&buffer,
+               int length, uint64_t tag);
+    int registeredIndex(const Request &request) const;
+    void complete(std::size_t slot, std::vector<Completion> &completions);
+    void perform(std::size_t slot);
+    std::size_t reapRing(std::vector<Completion> &completions);
+    std::size_t reapPool(std::vector<Completion> &completions, std::size_t minCount);
+
+    unsigned mDepth; //!< the most requests queued or in flight
+    std::unique_ptr<Ring> mRing; //!< the io_uring, nullptr for the thread pool
+    std::unique_ptr<ThreadPool> mPool; //!< the threads, nullptr for io_uring
+
+    std::vector<Request> mRequests; //!< the requests by slot
+    std::vector<std::size_t> mFreeSlots; //!< the slots not in use
+    std::vector<std::size_t> mQueued; //!< the slots queued but not submitted
+    std::size_t mInFlight; //!< the number of slots submitted and not completed
+
+    BufferStore *mStore; //!< owns the registered buffers, deletes itself once released
+    bool mKernelBuffers; //!< true if io_uring maps the buffers of mStore
+    int mRegisteredSize; //!< the size of each registered buffer
+
+    std::mutex mMutex; //!< guards mFinished for the thread pool
+    std::condition_variable mFinishedChanged; //!< signalled as requests finish
+    std::deque<std::size_t> mFinished; //!< the slots the thread pool finished
+};
+
+#endif // IO_QUEUE_HPP
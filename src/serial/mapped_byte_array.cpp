@@ -0,0 +1,314 @@
+/*!
+    \file mapped_byte_array.cpp
+    \brief file to implement the MappedByteArray class
+*/
+#include "mapped_byte_array.hpp"
+#include <algorithm>
+#include <utility>
+
+#ifndef WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/*!
+    \brief Default constructor for the MappedByteArray
+
+    Nothing is mapped until open() or create() is called
+*/
+MappedByteArray::MappedByteArray()
+: mData(nullptr),
+  mSize(0),
+  mMode(Mode::ReadOnly),
+  mOpen(false){
+
+}
+
+/*!
+    \brief Maps the file at path, see open()
+    \param path the file to map
+    \param mode whether the mapping may be written to
+*/
+MappedByteArray::MappedByteArray(const std::string& path, Mode mode)
+: MappedByteArray(){
+    open(path, mode);
+}
+
+/*!
+    \brief Move constructor, takes over the mapping of other
+    \param other the mapping to move from
+*/
+MappedByteArray::MappedByteArray(MappedByteArray&& other)
+: MappedByteArray(){
+    *this = std::move(other);
+}
+
+/*!
+    \brief Unmaps the file
+*/
+MappedByteArray::~MappedByteArray() {
+    close();
+}
+
+/*!
+    \brief Move assignment, unmaps this array and takes over the mapping of other
+    \param other the mapping to move from
+    \return a reference to this array
+*/
+MappedByteArray& MappedByteArray::operator=(MappedByteArray&& other) {
+    if(this != &other) {
+        close();
+        mData = other.mData;
+        mSize = other.mSize;
+        mMode = other.mMode;
+        mOpen = other.mOpen;
+
+        other.mData = nullptr;
+        other.mSize = 0;
+        other.mOpen = false;
+    }
+    return *this;
+}
+
+/*!
+    \brief Maps an existing file in its entirety
+
+    Any previous mapping is closed first. ReadWrite mappings are shared, so
+    writes are visible in the file.
+
+    \param path the file to map
+    \param mode whether the mapping may be written to
+    \return true if the file was mapped, otherwise false
+*/
+bool MappedByteArray::open(const std::string& path, Mode mode) {
+    close();
+
+#ifdef WIN32
+    (void)path;
+    (void)mode;
+    return false;
+#else
+    const int fd = ::open(path.c_str(), mode == Mode::ReadOnly ? O_RDONLY : O_RDWR);
+    if(fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    bool mapped = false;
+    if(fstat(fd, &info) == 0) {
+        mMode = mode;
+        mapped = map(fd, static_cast<uint64_t>(info.st_size));
+    }
+
+    // The mapping keeps its own reference to the file
+    ::close(fd);
+    return mapped;
+#endif
+}
+
+/*!
+    \brief Creates or truncates the file at path to size bytes and maps it ReadWrite
+    \param path the file to create
+    \param size the size of the file
+    \return true if the file was created and mapped, otherwise false
+*/
+bool MappedByteArray::create(const std::string& path, uint64_t size) {
+    close();
+
+#ifdef WIN32
+    (void)path;
+    (void)size;
+    return false;
+#else
+    const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0) {
+        return false;
+    }
+
+    bool mapped = false;
+    if(ftruncate(fd, static_cast<off_t>(size)) == 0) {
+        mMode = Mode::ReadWrite;
+        mapped = map(fd, size);
+    }
+
+    ::close(fd);
+    return mapped;
+#endif
+}
+
+/*!
+    \brief Unmaps the file, ReadWrite changes are written back by the kernel
+*/
+void MappedByteArray::close() {
+#ifndef WIN32
+    if(mData) {
+        munmap(mData, mSize);
+    }
+#endif
+    mData = nullptr;
+    mSize = 0;
+    mOpen = false;
+}
+
+/*!
+    \brief Returns true if a file is mapped
+    \return true if open, otherwise false
+*/
+bool MappedByteArray::isOpen() const {
+    return mOpen;
+}
+
+/*!
+    \brief Returns whether the mapping may be written to
+    \return the mode of the mapping
+*/
+MappedByteArray::Mode MappedByteArray::mode() const {
+    return mMode;
+}
+
+/*!
+    \brief Tells the kernel how the whole mapping will be accessed
+
+    Sequential lets the kernel read ahead aggressively and drop pages behind
+    the reader, Random turns read ahead off.
+
+    \param advice the expected access pattern
+    \return true if the advice was accepted, otherwise false
+*/
+bool MappedByteArray::advise(Advice advice) {
+    return advise(advice, 0, mSize);
+}
+
+/*!
+    \brief Tells the kernel how part of the mapping will be accessed
+    \param advice the expected access pattern
+    \param offset the start of the range, rounded down to a page
+    \param length the length of the range
+    \return true if the advice was accepted, otherwise false
+*/
+bool MappedByteArray::advise(Advice advice, uint64_t offset, uint64_t length) {
+#ifdef WIN32
+    (void)advice;
+    (void)offset;
+    (void)length;
+    return false;
+#else
+    if(!mData || offset >= mSize) {
+        return false;
+    }
+
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t start = offset - offset % pageSize;
+    length = std::min(length, mSize - offset) + (offset - start);
+
+    int flag = MADV_NORMAL;
+    switch(advice) {
+        case Advice::Normal:
+            flag = MADV_NORMAL;
+            break;
+        case Advice::Sequential:
+            flag = MADV_SEQUENTIAL;
+            break;
+        case Advice::Random:
+            flag = MADV_RANDOM;
+            break;
+        case Advice::WillNeed:
+            flag = MADV_WILLNEED;
+            break;
+        case Advice::DontNeed:
+            flag = MADV_DONTNEED;
+            break;
+    }
+
+    return madvise(mData + start, length, flag) == 0;
+#endif
+}
+
+/*!
+    \brief Writes the changes of a ReadWrite mapping back to the file and waits
+    \return true if the changes were written, otherwise false
+*/
+bool MappedByteArray::sync() {
+#ifdef WIN32
+    return false;
+#else
+    if(!mData) {
+        return mOpen;
+    }
+    return msync(mData, mSize, MS_SYNC) == 0;
+#endif
+}
+
+/*!
+    \brief Returns a pointer to the first byte, nullptr if nothing is mapped
+    \return the first byte of the mapping
+*/
+const char* MappedByteArray::constData() const {
+    return mData;
+}
+
+/*!
+    \brief Returns a writable pointer to the first byte
+
+    Only ReadWrite mappings may be written through this pointer.
+
+    \return the first byte of the mapping
+*/
+char* MappedByteArray::data() {
+    return mData;
+}
+
+/*!
+    \brief Returns the size of the mapping
+    \return the number of bytes mapped
+*/
+uint64_t MappedByteArray::size() const {
+    return mSize;
+}
+
+/*!
+    \brief Returns true if nothing is mapped or the file is empty
+    \return true if empty, otherwise false
+*/
+bool MappedByteArray::empty() const {
+    return mSize == 0;
+}
+
+/*!
+    \brief Returns a view of the mapping, valid until it is closed
+    \return the view of the whole mapping
+*/
+ByteView MappedByteArray::view() const {
+    return ByteView(mData, static_cast<std::size_t>(mSize));
+}
+
+/*!
+    \brief Maps size bytes of the file fd in the current mode
+    \param fd the open file
+    \param size the number of bytes to map
+    \return true if the file was mapped, otherwise false
+*/
+bool MappedByteArray::map(int fd, uint64_t size) {
+#ifdef WIN32
+    (void)fd;
+    (void)size;
+    return false;
+#else
+    // Empty files can't be mapped, but are still open
+    if(size > 0) {
+        const int protection = mMode == Mode::ReadOnly ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* address = mmap(nullptr, static_cast<std::size_t>(size), protection,
+                             MAP_SHARED, fd, 0);
+        if(address == MAP_FAILED) {
+            return false;
+        }
+        mData = static_cast<char*>(address);
+    }
+
+    mSize = size;
+    mOpen = true;
+    return true;
+#endif
+}
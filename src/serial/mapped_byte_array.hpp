@@ -0,0 +1,78 @@
+/*!
+    \file mapped_byte_array.hpp
+    \brief File to define the MappedByteArray class
+*/
+
+#ifndef MAPPED_BYTE_ARRAY_HPP
+#define MAPPED_BYTE_ARRAY_HPP
+
+#include <cstdint>
+#include <string>
+
+#include "byte_view.hpp"
+
+/*!
+    \brief Class which maps a file into memory instead of reading it
+
+    Pages are read in by the kernel the first time they are touched, so
+    opening even a very large file is immediate and it is never copied into
+    the heap. A ReadWrite mapping writes straight through to the file.
+
+    Mapping is only available on POSIX systems, open() fails on Windows.
+*/
+class MappedByteArray {
+public:
+    enum class Mode {
+        ReadOnly,
+        ReadWrite
+    };
+
+    /*!
+        \brief Hints to the kernel about how the mapping will be accessed
+    */
+    enum class Advice {
+        Normal,
+        Sequential,
+        Random,
+        WillNeed,
+        DontNeed
+    };
+
+    MappedByteArray();
+    MappedByteArray(const std::string &path, Mode mode = Mode::ReadOnly);
+    MappedByteArray(MappedByteArray &&other);
+    MappedByteArray(const MappedByteArray &other) = delete;
+
+    ~MappedByteArray();
+
+    MappedByteArray& operator=(MappedByteArray &&other);
+    MappedByteArray& operator=(const MappedByteArray &other) = delete;
+
+    bool open(const std::string &path, Mode mode = Mode::ReadOnly);
+    bool create(const std::string &path, uint64_t size);
+    void close();
+
+    bool isOpen() const;
+    Mode mode() const;
+
+    bool advise(Advice advice);
+    bool advise(Advice advice, uint64_t offset, uint64_t length);
+    bool sync();
+
+    const char* constData() const;
+    char* data();
+    uint64_t size() const;
+    bool empty() const;
+
+    ByteView view() const;
+
+private:
+    bool map(int fd, uint64_t size);
+
+    char *mData; //!< the start of the mapping, nullptr if nothing is mapped
+    uint64_t mSize; //!< the size of the mapping
+    Mode mMode;
+    bool mOpen;
+};
+
+#endif // MAPPED_BYTE_ARRAY_HPP
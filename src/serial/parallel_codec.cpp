@@ -0,0 +1,112 @@
+/*!
+    \file parallel_codec.cpp
+    \brief file to implement the index of the parallel chunked encoding
+*/
+#include "parallel_codec.hpp"
+
+#include <cstring>
+#include <limits>
+
+namespace {
+inline void storeLittleEndian(char *out, uint64_t value) {
+    if(SERIAL_HOST_BIG_ENDIAN) {
+        value = byteSwap64(value);
+    }
+    std::memcpy(out, &value, sizeof(value));
+}
+
+inline uint64_t loadLittleEndian(const char *in) {
+    uint64_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return SERIAL_HOST_BIG_ENDIAN ? byteSwap64(value) : value;
+}
+}
+
+/*!
+    \brief Concatenates encoded chunks behind a header and index, see
+    encodeParallel()
+
+    The chunks are copied into place in parallel, and freed as they are.
+
+    \param chunks the encoded chunks
+    \param counts the number of values in each chunk
+    \param pool the pool to copy on
+    \return the encoding, empty if it would be larger than a ByteArray can hold
+*/
+ByteArray joinChunks(std::vector<ByteArray> &chunks, const std::vector<uint64_t> &counts,
+                     ThreadPool &pool) {
+    const std::size_t headerSize = ChunkHeaderSize + ChunkEntrySize * chunks.size();
+    std::vector<uint64_t> offsets(chunks.size());
+    uint64_t total = headerSize;
+    for(std::size_t i = 0; i < chunks.size(); i++) {
+        offsets[i] = total;
+        total += static_cast<uint64_t>(chunks[i].size());
+    }
+    if(total > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+       chunks.size() > std::numeric_limits<uint32_t>::max()) {
+        return ByteArray();
+    }
+
+    ByteArray result;
+    char* out = result.extend(static_cast<int>(total));
+    uint32_t chunkCount = static_cast<uint32_t>(chunks.size());
+    if(SERIAL_HOST_BIG_ENDIAN) {
+        chunkCount = byteSwap32(chunkCount);
+    }
+    std::memcpy(out, &chunkCount, sizeof(chunkCount));
+    std::memset(out + sizeof(chunkCount), 0, ChunkHeaderSize - sizeof(chunkCount));
+    for(std::size_t i = 0; i < chunks.size(); i++) {
+        char* entry = out + ChunkHeaderSize + ChunkEntrySize * i;
+        storeLittleEndian(entry, offsets[i]);
+        storeLittleEndian(entry + 8, static_cast<uint64_t>(chunks[i].size()));
+        storeLittleEndian(entry + 16, counts[i]);
+    }
+
+    pool.parallelFor(chunks.size(), [&](std::size_t i) {
+        std::memcpy(out + offsets[i], chunks[i].begin(), static_cast<std::size_t>(chunks[i].size()));
+        chunks[i] = ByteArray();
+    });
+    return result;
+}
+
+/*!
+    \brief Reads the index of an encoding made by encodeParallel()
+
+    Every chunk is checked to lie within data after the index, so the offsets
+    can be used to slice data without further checks.
+
+    \param data the encoding
+    \param index set to the offset, size and count of each chunk
+    \return false if the header or index is malformed
+*/
+bool readChunkIndex(const ByteView &data, std::vector<ChunkInfo> &index) {
+    index.clear();
+    if(data.size() < ChunkHeaderSize) {
+        return false;
+    }
+
+    uint32_t chunkCount;
+    std::memcpy(&chunkCount, data.data(), sizeof(chunkCount));
+    if(SERIAL_HOST_BIG_ENDIAN) {
+        chunkCount = byteSwap32(chunkCount);
+    }
+    const uint64_t headerSize = ChunkHeaderSize + static_cast<uint64_t>(ChunkEntrySize) * chunkCount;
+    if(headerSize > data.size()) {
+        return false;
+    }
+
+    index.resize(chunkCount);
+    for(std::size_t i = 0; i < chunkCount; i++) {
+        const char* entry = data.data() + ChunkHeaderSize + ChunkEntrySize * i;
+        ChunkInfo& info = index[i];
+        info.offset = loadLittleEndian(entry);
+        info.size = loadLittleEndian(entry + 8);
+        info.count = loadLittleEndian(entry + 16);
+        if(info.offset < headerSize || info.offset > data.size() ||
+           info.size > data.size() - info.offset) {
+            index.clear();
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,215 @@
+/*!
+    \file parallel_codec.hpp
+    \brief File to define the parallel chunked encoding of collections
+*/
+
+#ifndef PARALLEL_CODEC_HPP
+#define PARALLEL_CODEC_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "byte_array.hpp"
+#include "byte_stream.hpp"
+#include "byte_view.hpp"
+#include "thread_pool.hpp"
+
+/*!
+    \brief Where a chunk lies in an encoding and how many values it holds
+*/
+struct ChunkInfo {
+    uint64_t offset; //!< the offset of the chunk from the start of the encoding
+    uint64_t size; //!< the number of bytes of the chunk
+    uint64_t count; //!< the number of values in the chunk
+};
+
+/*!
+    \brief How a collection is split and encoded by encodeParallel()
+*/
+struct ParallelOptions {
+    //! The pool to run on, nullptr for ThreadPool::shared()
+    ThreadPool *pool = nullptr;
+    //! The number of values per chunk, 0 to give every thread a few chunks
+    std::size_t chunkSize = 0;
+    //! The byte order every chunk is encoded in
+    ByteStream::ByteOrder order = ByteStream::ByteOrder::BigEndian;
+    //! The integer encoding every chunk is encoded in
+    ByteStream::IntegerEncoding encoding = ByteStream::IntegerEncoding::Fixed;
+};
+
+/*!
+    \brief The size of the fixed part of the header, the chunk count and a
+    reserved word, each a little endian uint32_t
+*/
+const std::size_t ChunkHeaderSize = 8;
+/*!
+    \brief The size of each entry of the index, the offset, size and count of
+    a chunk, each a little endian uint64_t
+*/
+const std::size_t ChunkEntrySize = 24;
+
+ByteArray joinChunks(std::vector<ByteArray> &chunks, const std::vector<uint64_t> &counts,
+                     ThreadPool &pool);
+bool readChunkIndex(const ByteView &data, std::vector<ChunkInfo> &index);
+
+namespace detail {
+/*!
+    \brief Writes values one at a time with the stream operators
+*/
+template<typename T>
+void writeChunk(ByteStream &stream, const T *values, std::size_t count, std::false_type) {
+    for(std::size_t i = 0; i < count; i++) {
+        stream << values[i];
+    }
+}
+
+/*!
+    \brief Writes arithmetic values in bulk, which encodes the same bytes
+*/
+template<typename T>
+void writeChunk(ByteStream &stream, const T *values, std::size_t count, std::true_type) {
+    if(stream.integerEncoding() == ByteStream::IntegerEncoding::Fixed) {
+        stream.writeArray(values, count);
+    } else {
+        writeChunk(stream, values, count, std::false_type());
+    }
+}
+
+template<typename T>
+void readChunk(ByteStream &stream, T *values, std::size_t count, std::false_type) {
+    for(std::size_t i = 0; i < count && stream.status() == ByteStream::Status::Ok; i++) {
+        stream >> values[i];
+    }
+}
+
+template<typename T>
+void readChunk(ByteStream &stream, T *values, std::size_t count, std::true_type) {
+    if(stream.integerEncoding() == ByteStream::IntegerEncoding::Fixed) {
+        stream.readArray(values, count);
+    } else {
+        readChunk(stream, values, count, std::false_type());
+    }
+}
+
+template<typename T>
+using BulkCopyable = std::integral_constant<bool, std::is_arithmetic<T>::value>;
+
+inline ThreadPool& poolOf(const ParallelOptions &options) {
+    return options.pool ? *options.pool : ThreadPool::shared();
+}
+}
+
+/*!
+    \brief Encodes count values in chunks on a thread pool, behind an index of
+    where each chunk starts
+
+    The layout is a header of the chunk count, an index entry per chunk, then
+    the chunks one after the other:
+
+    \code
+    [u32 chunkCount][u32 reserved][{u64 offset, u64 size, u64 count} x chunkCount][chunks]
+    \endcode
+
+    Each chunk is a plain ByteStream encoding of its values in the order and
+    integer encoding of options, so a chunk can be decoded on its own with
+    readChunkIndex() and a ByteStream over its bytes. Values are written with
+    the stream operators, which includes any type declaring SERIAL_FIELDS.
+
+    \param values the values to encode
+    \param count the number of values
+    \param options how to split and encode the values
+    \return the encoding
+*/
+template<typename T>
+ByteArray encodeParallel(const T *values, std::size_t count,
+                         const ParallelOptions &options = ParallelOptions()) {
+    ThreadPool& pool = detail::poolOf(options);
+    std::size_t chunkSize = options.chunkSize;
+    if(chunkSize == 0) {
+        const std::size_t chunks = std::max<std::size_t>(pool.threadCount(), 1) * 4;
+        chunkSize = std::max<std::size_t>((count + chunks - 1) / chunks, 1024);
+    }
+
+    const std::size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+    std::vector<ByteArray> chunks(chunkCount);
+    std::vector<uint64_t> counts(chunkCount);
+    pool.parallelFor(chunkCount, [&](std::size_t chunk) {
+        const std::size_t begin = chunk * chunkSize;
+        const std::size_t size = std::min(chunkSize, count - begin);
+        counts[chunk] = size;
+
+        ByteStream stream(&chunks[chunk], ByteStream::OpenMode::Append);
+        stream.setByteOrder(options.order);
+        stream.setIntegerEncoding(options.encoding);
+        detail::writeChunk(stream, values + begin, size, detail::BulkCopyable<T>());
+    });
+    return joinChunks(chunks, counts, pool);
+}
+
+/*!
+    \brief Encodes the elements of values, see encodeParallel(const T*, std::size_t)
+    \param values the values to encode
+    \param options how to split and encode the values
+    \return the encoding
+*/
+template<typename T>
+ByteArray encodeParallel(const std::vector<T> &values,
+                         const ParallelOptions &options = ParallelOptions()) {
+    return encodeParallel(values.data(), values.size(), options);
+}
+
+/*!
+    \brief Decodes an encoding made by encodeParallel(), a chunk per task
+
+    values is resized to the total count from the index, and each chunk is
+    decoded straight into its place. The byte order and integer encoding of
+    options must be the ones the values were encoded with, the other options
+    are ignored.
+
+    \param data the encoding
+    \param values set to the decoded values
+    \param options the pool to run on and the encoding of the chunks
+    \return false if the index is malformed or a chunk doesn't hold exactly
+    its count of values, values is then left in an unspecified state
+*/
+template<typename T>
+bool decodeParallel(const ByteView &data, std::vector<T> &values,
+                    const ParallelOptions &options = ParallelOptions()) {
+    std::vector<ChunkInfo> index;
+    if(!readChunkIndex(data, index)) {
+        return false;
+    }
+
+    std::vector<std::size_t> starts(index.size());
+    uint64_t total = 0;
+    for(std::size_t i = 0; i < index.size(); i++) {
+        starts[i] = static_cast<std::size_t>(total);
+        total += index[i].count;
+        // Every value takes a byte at least, which bounds the allocation
+        if(index[i].count > index[i].size || total > data.size()) {
+            return false;
+        }
+    }
+    values.clear();
+    values.resize(static_cast<std::size_t>(total));
+
+    std::atomic<bool> failed(false);
+    detail::poolOf(options).parallelFor(index.size(), [&](std::size_t chunk) {
+        const ChunkInfo& info = index[chunk];
+        ByteStream stream(data.slice(static_cast<std::size_t>(info.offset),
+                                     static_cast<std::size_t>(info.size)));
+        stream.setByteOrder(options.order);
+        stream.setIntegerEncoding(options.encoding);
+        detail::readChunk(stream, values.data() + starts[chunk],
+                          static_cast<std::size_t>(info.count), detail::BulkCopyable<T>());
+        if(stream.status() != ByteStream::Status::Ok || !stream.atEnd()) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    return !failed.load();
+}
+
+#endif // PARALLEL_CODEC_HPP
@@ -0,0 +1,212 @@
+/*!
+    \file segmented_byte_array.cpp
+    \brief file to implement the SegmentedByteArray class
+*/
+#include "segmented_byte_array.hpp"
+#include "io_device.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/*!
+    \brief Creates an empty array
+    \param chunkSize the size of the chunks appended bytes are copied into
+*/
+SegmentedByteArray::SegmentedByteArray(std::size_t chunkSize)
+: mChunkSize(std::max<std::size_t>(chunkSize, 1)),
+  mTail(nullptr),
+  mTailFree(0),
+  mSize(0){
+
+}
+
+/*!
+    \brief Move constructor, other is left empty
+    \param other the array to take the data of
+*/
+SegmentedByteArray::SegmentedByteArray(SegmentedByteArray&& other)
+: mSegments(std::move(other.mSegments)),
+  mChunks(std::move(other.mChunks)),
+  mArrays(std::move(other.mArrays)),
+  mChunkSize(other.mChunkSize),
+  mTail(other.mTail),
+  mTailFree(other.mTailFree),
+  mSize(other.mSize){
+    other.clear();
+}
+
+/*!
+    \brief Move assignment, other is left empty
+    \param other the array to take the data of
+    \return this array
+*/
+SegmentedByteArray& SegmentedByteArray::operator=(SegmentedByteArray&& other) {
+    if(this != &other) {
+        mSegments = std::move(other.mSegments);
+        mChunks = std::move(other.mChunks);
+        mArrays = std::move(other.mArrays);
+        mChunkSize = other.mChunkSize;
+        mTail = other.mTail;
+        mTailFree = other.mTailFree;
+        mSize = other.mSize;
+        other.clear();
+    }
+    return *this;
+}
+
+/*!
+    \brief Copies size bytes of data onto the end of the array
+
+    The bytes fill the free space of the last chunk first. Bytes already in
+    the array are never moved.
+
+    \param data the bytes to append
+    \param size the number of bytes to append
+*/
+void SegmentedByteArray::append(const char* data, std::size_t size) {
+    while(size > 0) {
+        if(mTailFree == 0) {
+            // Big appends get a chunk of their own, so they stay in one piece
+            const std::size_t chunkSize = std::max(mChunkSize, size);
+            mChunks.emplace_back(new char[chunkSize]);
+            mTail = mChunks.back().get();
+            mTailFree = chunkSize;
+        }
+
+        const std::size_t count = std::min(size, mTailFree);
+        std::memcpy(mTail, data, count);
+
+        // Grow the last segment if it ends where the copy started
+        if(!mSegments.empty() && mSegments.back().end() == mTail) {
+            const ByteView& last = mSegments.back();
+            mSegments.back() = ByteView(last.data(), last.size() + count);
+        } else {
+            mSegments.emplace_back(mTail, count);
+        }
+
+        mTail += count;
+        mTailFree -= count;
+        mSize += count;
+        data += count;
+        size -= count;
+    }
+}
+
+/*!
+    \brief Copies the bytes of view onto the end of the array
+    \param view the bytes to append
+*/
+void SegmentedByteArray::append(const ByteView& view) {
+    append(view.data(), view.size());
+}
+
+/*!
+    \brief Takes array as the next segment of the array, without copying it
+    \param array the array to splice in
+*/
+void SegmentedByteArray::splice(ByteArray&& array) {
+    if(array.empty()) {
+        return;
+    }
+
+    // Held through a pointer, so the data stays put as mArrays grows
+    mArrays.emplace_back(new ByteArray(std::move(array)));
+    const ByteArray& spliced = *mArrays.back();
+    mSegments.emplace_back(spliced);
+    mSize += static_cast<std::size_t>(spliced.size());
+}
+
+/*!
+    \brief Refers to view as the next segment of the array, without copying it
+
+    The memory view refers to must outlive the array, or be cleared from it.
+
+    \param view the bytes to splice in
+*/
+void SegmentedByteArray::splice(const ByteView& view) {
+    if(view.empty()) {
+        return;
+    }
+
+    mSegments.push_back(view);
+    mSize += view.size();
+}
+
+/*!
+    \brief Returns the number of bytes in the array
+    \return the size of the array
+*/
+std::size_t SegmentedByteArray::size() const {
+    return mSize;
+}
+
+/*!
+    \brief Returns true if the array holds no data
+    \return true if empty, otherwise false
+*/
+bool SegmentedByteArray::empty() const {
+    return mSize == 0;
+}
+
+/*!
+    \brief Removes all of the data and frees the chunks and spliced arrays
+*/
+void SegmentedByteArray::clear() {
+    mSegments.clear();
+    mChunks.clear();
+    mArrays.clear();
+    mTail = nullptr;
+    mTailFree = 0;
+    mSize = 0;
+}
+
+/*!
+    \brief Returns the number of contiguous segments the data is made of
+    \return the number of segments
+*/
+std::size_t SegmentedByteArray::segmentCount() const {
+    return mSegments.size();
+}
+
+/*!
+    \brief Returns a segment of the data
+    \param index the index of the segment, less than segmentCount()
+    \return a view of the segment
+*/
+const ByteView& SegmentedByteArray::segment(std::size_t index) const {
+    return mSegments[index];
+}
+
+/*!
+    \brief Returns all of the segments of the data, in order
+    \return the segments
+*/
+const std::vector<ByteView>& SegmentedByteArray::segments() const {
+    return mSegments;
+}
+
+/*!
+    \brief Copies the data into one contiguous ByteArray
+    \return the data
+*/
+ByteArray SegmentedByteArray::toByteArray() const {
+    ByteArray array;
+    array.reserve(static_cast<int>(mSize));
+    for(const ByteView& segment : mSegments) {
+        array.append(segment.data(), static_cast<int>(segment.size()));
+    }
+    return array;
+}
+
+/*!
+    \brief Writes all of the segments to device in as few calls as it allows
+
+    A FileDescriptorDevice writes them with writev(), without copying them
+    into one buffer first.
+
+    \param device the device to write to
+    \return the number of bytes written, -1 on error
+*/
+int64_t SegmentedByteArray::writeTo(IODevice* device) const {
+    return device->writeVectored(mSegments.data(), mSegments.size());
+}
@@ -0,0 +1,65 @@
+/*!
+    \file segmented_byte_array.hpp
+    \brief File to define the SegmentedByteArray class
+*/
+
+#ifndef SEGMENTED_BYTE_ARRAY_HPP
+#define SEGMENTED_BYTE_ARRAY_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "byte_array.hpp"
+#include "byte_view.hpp"
+
+class IODevice;
+
+/*!
+    \brief Class which builds data as a chain of segments instead of one buffer
+
+    Appended bytes are copied into fixed size chunks, and a full chunk is
+    followed by a new one rather than reallocated, so bytes never move once
+    written. Whole ByteArrays and views can be spliced in without copying
+    them. The segments are written out in one gather call by writeTo(), so
+    the data is only ever copied once, when it is appended.
+*/
+class SegmentedByteArray {
+public:
+    //! The size of the chunks appended bytes are copied into if none is given
+    static const std::size_t DefaultChunkSize = 4096;
+
+    explicit SegmentedByteArray(std::size_t chunkSize = DefaultChunkSize);
+    SegmentedByteArray(SegmentedByteArray &&other);
+    SegmentedByteArray(const SegmentedByteArray &other) = delete;
+
+    SegmentedByteArray& operator=(SegmentedByteArray &&other);
+    SegmentedByteArray& operator=(const SegmentedByteArray &other) = delete;
+
+    void append(const char *data, std::size_t size);
+    void append(const ByteView &view);
+    void splice(ByteArray &&array);
+    void splice(const ByteView &view);
+
+    std::size_t size() const;
+    bool empty() const;
+    void clear();
+
+    std::size_t segmentCount() const;
+    const ByteView& segment(std::size_t index) const;
+    const std::vector<ByteView>& segments() const;
+
+    ByteArray toByteArray() const;
+    int64_t writeTo(IODevice *device) const;
+
+private:
+    std::vector<ByteView> mSegments; //!< the data, in order
+    std::vector<std::unique_ptr<char[]>> mChunks; //!< the chunks bytes are copied into
+    std::vector<std::unique_ptr<ByteArray>> mArrays; //!< the arrays spliced in
+    std::size_t mChunkSize; //!< the size of a new chunk
+    char *mTail; //!< the next free byte of the last chunk
+    std::size_t mTailFree; //!< the number of free bytes in the last chunk
+    std::size_t mSize; //!< the number of bytes in all segments
+};
+
+#endif // SEGMENTED_BYTE_ARRAY_HPP
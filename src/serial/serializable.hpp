@@ -0,0 +1,500 @@
+/*!
+    \file serializable.hpp
+    \brief File to define SERIAL_FIELDS and the serialization of user structs
+*/
+
+#ifndef SERIALIZABLE_HPP
+#define SERIALIZABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include "byte_stream.hpp"
+#include "io_device.hpp"
+
+/*!
+    \brief Declares the fields of a struct so it can be written to a ByteStream
+
+    Place it in the struct after the fields, listing them in the order they
+    are declared:
+
+    \code
+    struct Position {
+        uint32_t id;
+        double x;
+        double y;
+
+        SERIAL_FIELDS(id, x, y)
+    };
+
+    stream << position;
+    \endcode
+
+    The fields may be arithmetic values, enums, std::strings or other structs
+    which declare SERIAL_FIELDS. They are written one after the other, each
+    exactly as the stream would write it on its own.
+*/
+#define SERIAL_FIELDS(...) \
+    using SerialFieldTypes = decltype(serialFieldList(__VA_ARGS__)); \
+    template<typename Visitor> \
+    void serialVisit(Visitor &&visit) { visit(__VA_ARGS__); } \
+    template<typename Visitor> \
+    void serialVisit(Visitor &&visit) const { visit(__VA_ARGS__); }
+
+/*!
+    \brief The types of the fields of a struct, in order
+*/
+template<typename... Fields>
+struct SerialFieldList {};
+
+//! Only used by SERIAL_FIELDS to name the types of the fields
+template<typename... Fields>
+SerialFieldList<Fields...> serialFieldList(const Fields&...);
+
+/*!
+    \brief True if T declares SERIAL_FIELDS
+*/
+template<typename T, typename = void>
+struct IsSerializable : std::false_type {};
+
+template<typename T>
+struct IsSerializable<T, decltype(void(sizeof(typename T::SerialFieldTypes)))> : std::true_type {};
+
+/*!
+    \brief How a type is laid out on the wire when the integers are fixed width
+
+    fixed is true if the encoding always has the same size, and size is that
+    size. packed is true if the encoding in the host byte order is the same
+    as the bytes of the type in memory, so it can be copied as a whole.
+*/
+template<typename T, typename = void>
+struct SerialLayout {
+    static constexpr bool fixed = false;
+    static constexpr bool packed = false;
+    static constexpr std::size_t size = 0;
+};
+
+template<typename T>
+struct SerialLayout<T, typename std::enable_if<std::is_arithmetic<T>::value ||
+                                               std::is_enum<T>::value>::type> {
+    static constexpr bool fixed = true;
+    // A copied bool could be any byte, it has to be read as byte != 0
+    static constexpr bool packed = !std::is_same<T, bool>::value;
+    static constexpr std::size_t size = sizeof(T);
+};
+
+template<typename... Fields>
+struct SerialFieldsLayout;
+
+template<>
+struct SerialFieldsLayout<> {
+    static constexpr bool fixed = true;
+    static constexpr bool packed = true;
+    static constexpr std::size_t size = 0;
+};
+
+template<typename Field, typename... Fields>
+struct SerialFieldsLayout<Field, Fields...> {
+    using First = SerialLayout<Field>;
+    using Rest = SerialFieldsLayout<Fields...>;
+
+    static constexpr bool fixed = First::fixed && Rest::fixed;
+    static constexpr bool packed = First::packed && Rest::packed;
+    static constexpr std::size_t size = First::size + Rest::size;
+};
+
+template<typename FieldList>
+struct SerialListLayout;
+
+template<typename... Fields>
+struct SerialListLayout<SerialFieldList<Fields...>> : SerialFieldsLayout<Fields...> {};
+
+template<typename T>
+struct SerialLayout<T, typename std::enable_if<IsSerializable<T>::value>::type> {
+    using Fields = SerialListLayout<typename T::SerialFieldTypes>;
+
+    static constexpr bool fixed = Fields::fixed;
+    // Padding or fields left out of the list would end up in a copy
+    static constexpr bool packed = Fields::packed && Fields::size == sizeof(T) &&
+                                   std::is_trivially_copyable<T>::value;
+    static constexpr std::size_t size = Fields::size;
+};
+
+/*!
+    \brief Visitor which checks the fields are listed in the order of the layout
+
+    A struct whose fields are all packed but listed out of order has the same
+    size as its fields, but can't be copied as a whole.
+*/
+class SerialLayoutChecker {
+public:
+    explicit SerialLayoutChecker(const void *object) :
+    mNext(static_cast<const char*>(object)),
+    mInOrder(true){
+
+    }
+
+    template<typename... Fields>
+    void operator()(const Fields&... fields) {
+        int expand[] = {0, (check(fields), 0)...};
+        (void)expand;
+    }
+
+    bool inOrder() const {
+        return mInOrder;
+    }
+
+private:
+    template<typename Field>
+    typename std::enable_if<IsSerializable<Field>::value>::type check(const Field &field) {
+        field.serialVisit(*this);
+    }
+
+    template<typename Field>
+    typename std::enable_if<!IsSerializable<Field>::value>::type check(const Field &field) {
+        mInOrder = mInOrder && reinterpret_cast<const char*>(&field) == mNext;
+        mNext += sizeof(Field);
+    }
+
+    const char *mNext; //!< where the next field should be
+    bool mInOrder; //!< false once a field was somewhere else
+};
+
+/*!
+    \brief Returns true if value can be copied into a stream as a whole
+
+    The order of the fields is only checked on the first call for each type,
+    since every object of a type has the same layout.
+
+    \param value an object of the type
+    \return true if the bytes of value are its encoding in the host order
+*/
+template<typename T>
+bool serialCopyable(const T &value) {
+    if(!SerialLayout<T>::packed) {
+        return false;
+    }
+
+    static const bool inOrder = [&value]() {
+        SerialLayoutChecker checker(&value);
+        value.serialVisit(checker);
+        return checker.inOrder();
+    }();
+    return inOrder;
+}
+
+/*!
+    \brief The fixed width integer a ByteStream operator writes for an integer
+*/
+template<std::size_t Size, bool Signed>
+struct SerialInteger;
+
+template<> struct SerialInteger<1, false> { using type = uint8_t; };
+template<> struct SerialInteger<2, false> { using type = uint16_t; };
+template<> struct SerialInteger<4, false> { using type = uint32_t; };
+template<> struct SerialInteger<8, false> { using type = uint64_t; };
+template<> struct SerialInteger<1, true> { using type = int8_t; };
+template<> struct SerialInteger<2, true> { using type = int16_t; };
+template<> struct SerialInteger<4, true> { using type = int32_t; };
+template<> struct SerialInteger<8, true> { using type = int64_t; };
+
+/*!
+    \brief The type a field is written as, so every field has an operator
+
+    Integers map to the fixed width type of their size, such as long long to
+    int64_t, and enums to their underlying type.
+*/
+template<typename T, typename = void>
+struct SerialWireType {
+    using type = T;
+};
+
+template<typename T>
+struct SerialWireType<T, typename std::enable_if<std::is_integral<T>::value &&
+                                                 !std::is_same<T, bool>::value>::type> {
+    using type = typename SerialInteger<sizeof(T), std::is_signed<T>::value>::type;
+};
+
+template<typename T>
+struct SerialWireType<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+    using type = typename SerialWireType<typename std::underlying_type<T>::type>::type;
+};
+
+template<typename T>
+typename std::enable_if<IsSerializable<T>::value>::type
+operator<<(ByteStream &stream, const T &value);
+
+template<typename T>
+typename std::enable_if<IsSerializable<T>::value>::type
+operator>>(ByteStream &stream, T &value);
+
+/*!
+    \brief Visitor which writes fields through the ByteStream operators
+*/
+class SerialFieldWriter {
+public:
+    explicit SerialFieldWriter(ByteStream &stream) : mStream(stream) {}
+
+    template<typename... Fields>
+    void operator()(const Fields&... fields) {
+        int expand[] = {0, (write(fields), 0)...};
+        (void)expand;
+    }
+
+private:
+    template<typename Field>
+    typename std::enable_if<!SerialLayout<Field>::fixed || IsSerializable<Field>::value>::type
+    write(const Field &field) {
+        // A pointer would be written through operator<<(bool), as whether it is null
+        static_assert(!std::is_pointer<Field>::value,
+                      "pointer fields can't be serialized, use std::string");
+        mStream << field;
+    }
+
+    template<typename Field>
+    typename std::enable_if<SerialLayout<Field>::fixed && !IsSerializable<Field>::value>::type
+    write(const Field &field) {
+        mStream << static_cast<typename SerialWireType<Field>::type>(field);
+    }
+
+    ByteStream &mStream; //!< the stream to write to
+};
+
+/*!
+    \brief Visitor which reads fields through the ByteStream operators
+*/
+class SerialFieldReader {
+public:
+    explicit SerialFieldReader(ByteStream &stream) : mStream(stream) {}
+
+    template<typename... Fields>
+    void operator()(Fields&... fields) {
+        int expand[] = {0, (read(fields), 0)...};
+        (void)expand;
+    }
+
+private:
+    template<typename Field>
+    typename std::enable_if<!SerialLayout<Field>::fixed || IsSerializable<Field>::value>::type
+    read(Field &field) {
+        static_assert(!std::is_pointer<Field>::value,
+                      "pointer fields can't be serialized, use std::string");
+        mStream >> field;
+    }
+
+    template<typename Field>
+    typename std::enable_if<SerialLayout<Field>::fixed && !IsSerializable<Field>::value>::type
+    read(Field &field) {
+        typename SerialWireType<Field>::type wire;
+        mStream >> wire;
+        if(mStream.status() == ByteStream::Status::Ok) {
+            field = static_cast<Field>(wire);
+        }
+    }
+
+    ByteStream &mStream; //!< the stream to read from
+};
+
+/*!
+    \brief Visitor which writes fixed size fields into a WriteBatch
+*/
+class SerialBatchWriter {
+public:
+    explicit SerialBatchWriter(ByteStream::WriteBatch &batch) : mBatch(batch) {}
+
+    template<typename... Fields>
+    void operator()(const Fields&... fields) {
+        int expand[] = {0, (write(fields), 0)...};
+        (void)expand;
+    }
+
+private:
+    template<typename Field>
+    typename std::enable_if<IsSerializable<Field>::value>::type write(const Field &field) {
+        field.serialVisit(*this);
+    }
+
+    template<typename Field>
+    typename std::enable_if<!IsSerializable<Field>::value>::type write(const Field &field) {
+        mBatch.put(static_cast<typename SerialWireType<Field>::type>(field));
+    }
+
+    ByteStream::WriteBatch &mBatch; //!< the batch to write into
+};
+
+/*!
+    \brief Visitor which reads fixed size fields from a ReadBatch
+*/
+class SerialBatchReader {
+public:
+    explicit SerialBatchReader(ByteStream::ReadBatch &batch) : mBatch(batch) {}
+
+    template<typename... Fields>
+    void operator()(Fields&... fields) {
+        int expand[] = {0, (read(fields), 0)...};
+        (void)expand;
+    }
+
+private:
+    template<typename Field>
+    typename std::enable_if<IsSerializable<Field>::value>::type read(Field &field) {
+        field.serialVisit(*this);
+    }
+
+    template<typename Field>
+    typename std::enable_if<!IsSerializable<Field>::value>::type read(Field &field) {
+        field = static_cast<Field>(mBatch.get<typename SerialWireType<Field>::type>());
+    }
+
+    ByteStream::ReadBatch &mBatch; //!< the batch to read from
+};
+
+/*!
+    \brief Writes a struct of fixed size fields, which may be copied as a whole
+    \param stream the stream to write to
+    \param value the struct to write
+*/
+template<typename T>
+void serialWrite(ByteStream &stream, const T &value, std::true_type) {
+    if(stream.order() == ByteStream::hostByteOrder() && serialCopyable(value)) {
+        stream.writeBytes(reinterpret_cast<const char*>(&value), sizeof(T));
+        return;
+    }
+
+    ByteStream::WriteBatch batch(stream, SerialLayout<T>::size);
+    if(batch) {
+        value.serialVisit(SerialBatchWriter(batch));
+    }
+}
+
+/*!
+    \brief Writes a struct field by field
+    \param stream the stream to write to
+    \param value the struct to write
+*/
+template<typename T>
+void serialWrite(ByteStream &stream, const T &value, std::false_type) {
+    value.serialVisit(SerialFieldWriter(stream));
+}
+
+/*!
+    \brief Reads a struct of fixed size fields, which may be copied as a whole
+    \param stream the stream to read from
+    \param value the struct to read into
+*/
+template<typename T>
+void serialRead(ByteStream &stream, T &value, std::true_type) {
+    if(stream.order() == ByteStream::hostByteOrder() && serialCopyable(value)) {
+        stream.readRawData(reinterpret_cast<char*>(&value), sizeof(T));
+        return;
+    }
+
+    ByteStream::ReadBatch batch(stream, SerialLayout<T>::size);
+    if(batch) {
+        value.serialVisit(SerialBatchReader(batch));
+    }
+}
+
+/*!
+    \brief Reads a struct field by field
+    \param stream the stream to read from
+    \param value the struct to read into
+*/
+template<typename T>
+void serialRead(ByteStream &stream, T &value, std::false_type) {
+    value.serialVisit(SerialFieldReader(stream));
+}
+
+/*!
+    \brief Writes the fields of value to the stream
+
+    A packed struct in a stream of the host byte order is copied with a single
+    memcpy. A struct of fixed size fields is bounds checked once and written
+    through a WriteBatch. Anything else, or any struct when the stream uses
+    varint integers, is written field by field. All three write the same
+    bytes.
+
+    \param stream the stream to write to
+    \param value the struct to write
+*/
+template<typename T>
+typename std::enable_if<IsSerializable<T>::value>::type
+operator<<(ByteStream &stream, const T &value) {
+    if(stream.integerEncoding() == ByteStream::IntegerEncoding::Fixed) {
+        serialWrite(stream, value, std::integral_constant<bool, SerialLayout<T>::fixed>());
+    } else {
+        serialWrite(stream, value, std::false_type());
+    }
+}
+
+/*!
+    \brief Reads the fields of value from the stream, see operator<<
+
+    A read which fails leaves the stream status set, and value may be
+    partially read.
+
+    \param stream the stream to read from
+    \param value the struct to read into
+*/
+template<typename T>
+typename std::enable_if<IsSerializable<T>::value>::type
+operator>>(ByteStream &stream, T &value) {
+    if(stream.integerEncoding() == ByteStream::IntegerEncoding::Fixed) {
+        serialRead(stream, value, std::integral_constant<bool, SerialLayout<T>::fixed>());
+    } else {
+        serialRead(stream, value, std::false_type());
+    }
+}
+
+/*!
+    \brief Returns the size of the encoding of any T, with fixed width integers
+
+    Only compiles for types whose encoding always has the same size:
+    arithmetic values, enums and SERIAL_FIELDS structs made of them.
+
+    \code
+    ByteArray array;
+    array.reserve(serializedSize<Sample>() * count);
+    \endcode
+
+    \return the size in bytes
+*/
+template<typename T>
+constexpr std::size_t serializedSize() {
+    static_assert(SerialLayout<T>::fixed, "T does not have a fixed encoded size");
+    return SerialLayout<T>::size;
+}
+
+/*!
+    \brief Returns the size of the encoding of value, without storing it
+
+    Types of a fixed size with fixed width integers are answered at compile
+    time. Anything else is written to a ByteStream set to a NullDevice, which
+    only counts the bytes.
+
+    \param value the value to measure
+    \param encoding the integer encoding it will be written with
+    \return the size in bytes
+*/
+template<typename T>
+uint64_t serializedSize(const T &value,
+                        ByteStream::IntegerEncoding encoding = ByteStream::IntegerEncoding::Fixed) {
+    if(SerialLayout<T>::fixed && encoding == ByteStream::IntegerEncoding::Fixed) {
+        return SerialLayout<T>::size;
+    }
+
+    // The stream only buffers what it measures, it never needs to be large
+    const std::size_t bufferSize = 256;
+
+    NullDevice device;
+    {
+        ByteStream stream(&device, ByteStream::OpenMode::WriteOnly, bufferSize);
+        stream.setIntegerEncoding(encoding);
+        stream << value;
+    }
+    return device.size();
+}
+
+#endif // SERIALIZABLE_HPP
@@ -0,0 +1,281 @@
+/*!
+    \file table.cpp
+    \brief file to implement the TableBuilder and TableView classes
+*/
+#include "table.hpp"
+
+#include <functional>
+#include <limits>
+
+/*!
+    \brief Starts a table at the end of array
+    \param array the array to append the table to
+*/
+TableBuilder::TableBuilder(ByteArray* array)
+: mArray(array),
+  mStart(array->size()),
+  mFailed(false){
+    char* header = mArray->extend(TableView::HeaderSize);
+    if(header) {
+        std::memset(header, 0, TableView::HeaderSize);
+    } else {
+        mFailed = true;
+    }
+}
+
+/*!
+    \brief Adds a field of bytes, stored with its length
+    \param id the id of the field
+    \param bytes the bytes of the field, which may be in the array
+*/
+void TableBuilder::addBytes(uint16_t id, const ByteView& bytes) {
+    const uint32_t length = tableByteOrder(static_cast<uint32_t>(bytes.size()));
+    char* field = addField(id, sizeof(length) + bytes.size(), bytes);
+    if(field) {
+        std::memcpy(field, &length, sizeof(length));
+    }
+}
+
+/*!
+    \brief Adds a string field, see addBytes()
+    \param id the id of the field
+    \param s the string
+*/
+void TableBuilder::addString(uint16_t id, const std::string& s) {
+    addBytes(id, ByteView(s.data(), s.size()));
+}
+
+/*!
+    \brief Adds a field which is a table of its own, built by another builder
+    \param id the id of the field
+    \param table the finished table, which may be in the array
+*/
+void TableBuilder::addTable(uint16_t id, const ByteView& table) {
+    addField(id, table.size(), table);
+}
+
+/*!
+    \brief Writes the offset table and the header, which completes the table
+
+    Nothing may be added afterwards. If a field couldn't be added, because
+    its id was over MaxFieldId or the array couldn't grow, the table is
+    removed from the array instead.
+
+    \return the table, which is valid until the array changes, or an empty
+    view if the table failed
+*/
+ByteView TableBuilder::finish() {
+    const std::size_t tableBytes = mOffsets.size() * sizeof(uint32_t);
+    char* table = mFailed ? nullptr : mArray->extend(static_cast<int>(tableBytes));
+    if(!table) {
+        mArray->truncate(mStart);
+        return ByteView();
+    }
+    for(std::size_t id = 0; id < mOffsets.size(); id++) {
+        const uint32_t offset = tableByteOrder(mOffsets[id]);
+        std::memcpy(table + id * sizeof(uint32_t), &offset, sizeof(offset));
+    }
+
+    const uint32_t size = static_cast<uint32_t>(mArray->size() - mStart);
+    const uint32_t rawSize = tableByteOrder(size);
+    const uint16_t fieldCount = tableByteOrder(static_cast<uint16_t>(mOffsets.size()));
+    char* header = mArray->begin() + mStart;
+    std::memcpy(header, &rawSize, sizeof(rawSize));
+    std::memcpy(header + sizeof(rawSize), &fieldCount, sizeof(fieldCount));
+
+    return ByteView(header, size);
+}
+
+/*!
+    \brief Appends size bytes for the field id and records where they are
+    \param id the id of the field
+    \param size the number of bytes in the field
+    \return where to write the field, nullptr if it can't be added
+*/
+char* TableBuilder::addField(uint16_t id, std::size_t size) {
+    if(mFailed || id > MaxFieldId ||
+       size > static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+        mFailed = true;
+        return nullptr;
+    }
+
+    if(id >= mOffsets.size()) {
+        mOffsets.resize(static_cast<std::size_t>(id) + 1, 0);
+    }
+    mOffsets[id] = static_cast<uint32_t>(mArray->size() - mStart);
+    char* field = mArray->extend(static_cast<int>(size));
+    mFailed = field == nullptr;
+    return field;
+}
+
+/*!
+    \brief Appends a field which ends with a copy of data, see addField()
+
+    data may point into the array, such as a table built earlier in it.
+
+    \param id the id of the field
+    \param size the number of bytes in the field, at least data.size()
+    \param data the bytes to copy to the end of the field
+    \return where to write the rest of the field, nullptr if it can't be added
+*/
+char* TableBuilder::addField(uint16_t id, std::size_t size, const ByteView& data) {
+    // Data from the array moves if extending reallocates, so find it again
+    const std::less<const char*> before;
+    const bool inArray = !data.empty() && !before(data.data(), mArray->begin()) &&
+                         before(data.data(), mArray->end());
+    const std::ptrdiff_t offset = inArray ? data.data() - mArray->begin() : 0;
+    char* field = addField(id, size);
+    if(field && !data.empty()) {
+        const char* source = inArray ? mArray->begin() + offset : data.data();
+        std::memcpy(field + size - data.size(), source, data.size());
+    }
+    return field;
+}
+
+/*!
+    \brief Creates a view which isn't valid and has no fields
+*/
+TableView::TableView()
+: mData(nullptr),
+  mSize(0),
+  mFieldCount(0){
+
+}
+
+/*!
+    \brief Creates a view of the table at the start of data
+
+    data may continue past the table, size() tells where the next one starts.
+    If the header doesn't describe a table which fits in data the view is
+    invalid and has no fields.
+
+    \param data the bytes starting with the table
+*/
+TableView::TableView(const ByteView& data)
+: TableView(){
+    if(data.size() < HeaderSize) {
+        return;
+    }
+
+    uint32_t size;
+    uint16_t fieldCount;
+    std::memcpy(&size, data.data(), sizeof(size));
+    std::memcpy(&fieldCount, data.data() + sizeof(size), sizeof(fieldCount));
+    size = tableByteOrder(size);
+    fieldCount = tableByteOrder(fieldCount);
+
+    if(size > data.size() || size < HeaderSize ||
+       static_cast<uint64_t>(fieldCount) * sizeof(uint32_t) > size - HeaderSize) {
+        return;
+    }
+
+    mData = data.data();
+    mSize = size;
+    mFieldCount = fieldCount;
+}
+
+/*!
+    \brief Returns true if the view refers to a well formed table
+    \return true if valid, otherwise false
+*/
+bool TableView::isValid() const {
+    return mData != nullptr;
+}
+
+/*!
+    \brief Returns the bytes of the whole table
+    \return the table
+*/
+ByteView TableView::data() const {
+    return ByteView(mData, mSize);
+}
+
+/*!
+    \brief Returns the size of the whole table
+    \return the size in bytes, 0 if invalid
+*/
+uint32_t TableView::size() const {
+    return mSize;
+}
+
+/*!
+    \brief Returns the number of field ids the table has room for
+    \return the number of entries in the offset table
+*/
+uint16_t TableView::fieldCount() const {
+    return mFieldCount;
+}
+
+/*!
+    \brief Returns true if the table has the field id
+    \param id the id of the field
+    \return true if present, otherwise false
+*/
+bool TableView::has(uint16_t id) const {
+    return offset(id, 0) != 0;
+}
+
+/*!
+    \brief Reads a field of bytes without copying it
+    \param id the id of the field
+    \return the bytes, which are empty if the table doesn't have the field
+*/
+ByteView TableView::getBytes(uint16_t id) const {
+    const uint32_t at = offset(id, sizeof(uint32_t));
+    if(at == 0) {
+        return ByteView();
+    }
+
+    uint32_t length;
+    std::memcpy(&length, mData + at, sizeof(length));
+    length = tableByteOrder(length);
+    if(length > mSize - at - sizeof(uint32_t)) {
+        return ByteView();
+    }
+    return ByteView(mData + at + sizeof(uint32_t), length);
+}
+
+/*!
+    \brief Reads a string field into a new string, see getBytes()
+    \param id the id of the field
+    \return the string
+*/
+std::string TableView::getString(uint16_t id) const {
+    const ByteView bytes = getBytes(id);
+    return std::string(bytes.begin(), bytes.end());
+}
+
+/*!
+    \brief Reads a field which is a table of its own
+    \param id the id of the field
+    \return the nested table, which is invalid if the table doesn't have it
+*/
+TableView TableView::getTable(uint16_t id) const {
+    const uint32_t at = offset(id, HeaderSize);
+    if(at == 0) {
+        return TableView();
+    }
+    return TableView(ByteView(mData + at, mSize - at));
+}
+
+/*!
+    \brief Looks up where field id starts
+    \param id the id of the field
+    \param size the number of bytes which must fit in the table from there
+    \return the offset of the field, 0 if absent or out of bounds
+*/
+uint32_t TableView::offset(uint16_t id, std::size_t size) const {
+    if(id >= mFieldCount) {
+        return 0;
+    }
+
+    const char* entry = mData + mSize - (mFieldCount - id) * sizeof(uint32_t);
+    uint32_t at;
+    std::memcpy(&at, entry, sizeof(at));
+    at = tableByteOrder(at);
+
+    if(at < HeaderSize || at > mSize || size > mSize - at) {
+        return 0;
+    }
+    return at;
+}
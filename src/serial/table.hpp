@@ -0,0 +1,162 @@
+/*!
+    \file table.hpp
+    \brief File to define the TableBuilder and TableView classes
+*/
+
+#ifndef TABLE_HPP
+#define TABLE_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "byte_array.hpp"
+#include "byte_order.hpp"
+#include "byte_view.hpp"
+
+/*!
+    \brief Converts between the host byte order and the little endian order of
+    tables, which is its own inverse
+    \param value the value to convert
+    \return the converted value
+*/
+template<typename T>
+inline T tableByteOrder(T value) {
+    return SERIAL_HOST_BIG_ENDIAN ? swapBytes(value) : value;
+}
+
+/*!
+    \brief Class which writes a record as a table of fields with an offset table
+
+    A table is laid out as
+
+    \code
+    uint32_t size          the size of the whole table
+    uint16_t fieldCount    the number of entries in the offset table
+    uint16_t reserved
+    ...                    the fields, in the order they were added
+    uint32_t offsets[fieldCount]
+    \endcode
+
+    Each offset is where the field with that id starts, from the start of the
+    table, or 0 if the table doesn't have it. Scalars are stored as they are,
+    bytes and strings as a uint32_t length followed by the bytes, and nested
+    tables as a whole table. Everything is little endian.
+
+    Fields may be added in any order and ids may be left out. Adding an id
+    twice replaces it, but its first value still takes up space. Ids go up to
+    MaxFieldId, so the field count fits its uint16_t.
+*/
+class TableBuilder {
+public:
+    //! The largest field id a table can have
+    static const uint16_t MaxFieldId = 65534;
+
+    explicit TableBuilder(ByteArray *array);
+
+    TableBuilder(const TableBuilder &other) = delete;
+    TableBuilder& operator=(const TableBuilder &other) = delete;
+
+    template<typename T>
+    void add(uint16_t id, T value);
+    void addBytes(uint16_t id, const ByteView &bytes);
+    void addString(uint16_t id, const std::string &s);
+    void addTable(uint16_t id, const ByteView &table);
+
+    ByteView finish();
+
+private:
+    char* addField(uint16_t id, std::size_t size);
+    char* addField(uint16_t id, std::size_t size, const ByteView &data);
+
+    ByteArray *mArray; //!< the array the table is appended to
+    int mStart; //!< where the table starts in mArray
+    std::vector<uint32_t> mOffsets; //!< the offset of each field id, 0 if absent
+    bool mFailed; //!< true once a field couldn't be added
+};
+
+/*!
+    \brief Class which reads single fields of a table without parsing it
+
+    Any field is found in constant time through the offset table. Fields the
+    reader doesn't know are never looked at, and fields the table doesn't have,
+    such as ones added to a schema after it was written, read as a default
+    value. Every access is bounds checked against the table, so corrupt data
+    reads as missing fields rather than out of bounds.
+*/
+class TableView {
+public:
+    //! The size of the header before the fields
+    static const uint32_t HeaderSize = 8;
+
+    TableView();
+    explicit TableView(const ByteView &data);
+
+    bool isValid() const;
+    ByteView data() const;
+    uint32_t size() const;
+    uint16_t fieldCount() const;
+
+    bool has(uint16_t id) const;
+
+    template<typename T>
+    T get(uint16_t id, T defaultValue = T()) const;
+    ByteView getBytes(uint16_t id) const;
+    std::string getString(uint16_t id) const;
+    TableView getTable(uint16_t id) const;
+
+private:
+    uint32_t offset(uint16_t id, std::size_t size) const;
+
+    const char *mData; //!< the first byte of the table, nullptr if invalid
+    uint32_t mSize; //!< the size of the table
+    uint16_t mFieldCount; //!< the number of entries in the offset table
+};
+
+/*!
+    \brief Adds a scalar field
+    \param id the id of the field
+    \param value an arithmetic or enum value
+*/
+template<typename T>
+void TableBuilder::add(uint16_t id, T value) {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "only scalars can be added, use addBytes() or addTable()");
+    using Scalar = typename std::conditional<std::is_enum<T>::value,
+                                             std::underlying_type<T>,
+                                             std::common_type<T>>::type::type;
+
+    const Scalar raw = tableByteOrder(static_cast<Scalar>(value));
+    char* field = addField(id, sizeof(raw));
+    if(field) {
+        std::memcpy(field, &raw, sizeof(raw));
+    }
+}
+
+/*!
+    \brief Reads a scalar field
+    \param id the id of the field
+    \param defaultValue returned when the table doesn't have the field
+    \return the value of the field
+*/
+template<typename T>
+T TableView::get(uint16_t id, T defaultValue) const {
+    static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                  "only scalars can be read, use getBytes() or getTable()");
+    using Scalar = typename std::conditional<std::is_enum<T>::value,
+                                             std::underlying_type<T>,
+                                             std::common_type<T>>::type::type;
+
+    const uint32_t at = offset(id, sizeof(Scalar));
+    if(at == 0) {
+        return defaultValue;
+    }
+
+    typename RawType<Scalar>::type raw;
+    std::memcpy(&raw, mData + at, sizeof(raw));
+    return static_cast<T>(tableByteOrder(raw));
+}
+
+#endif // TABLE_HPP
@@ -0,0 +1,150 @@
+/*!
+    \file thread_pool.cpp
+    \brief file to implement the ThreadPool class
+*/
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+namespace {
+/*!
+    \brief The progress of a parallelFor(), shared with the helper tasks since
+    they may start after the loop has returned
+*/
+struct ParallelLoop {
+    ParallelLoop(std::size_t count, const std::function<void(std::size_t)> &body) :
+    count(count),
+    body(body),
+    next(0),
+    done(0){
+    }
+
+    /*!
+        \brief Runs indices until none are left to claim
+    */
+    void run() {
+        std::size_t finished = 0;
+        std::size_t index;
+        while((index = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+            body(index);
+            finished++;
+        }
+        if(finished > 0 && done.fetch_add(finished, std::memory_order_acq_rel) + finished == count) {
+            std::lock_guard<std::mutex> lock(mutex);
+            finishedAll.notify_all();
+        }
+    }
+
+    const std::size_t count;
+    const std::function<void(std::size_t)> body;
+    std::atomic<std::size_t> next; //!< the next index to claim
+    std::atomic<std::size_t> done; //!< the number of indices finished
+    std::mutex mutex;
+    std::condition_variable finishedAll;
+};
+}
+
+/*!
+    \brief Starts the worker threads
+    \param threads the number of workers, 0 for one per hardware thread
+*/
+ThreadPool::ThreadPool(std::size_t threads) :
+mStopping(false){
+    if(threads == 0) {
+        threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    }
+    for(std::size_t i = 0; i < threads; i++) {
+        mThreads.push_back(std::thread(&ThreadPool::work, this));
+    }
+}
+
+/*!
+    \brief Runs the tasks still queued, then stops and joins the workers
+*/
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopping = true;
+    }
+    mWake.notify_all();
+    for(std::thread& thread : mThreads) {
+        thread.join();
+    }
+}
+
+/*!
+    \brief Returns a pool with a worker per hardware thread, shared by the
+    whole process and created on first use
+*/
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+/*!
+    \brief Returns the number of worker threads
+*/
+std::size_t ThreadPool::threadCount() const {
+    return mThreads.size();
+}
+
+/*!
+    \brief Queues task to run on a worker
+    \param task the task to run
+*/
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTasks.push_back(std::move(task));
+    }
+    mWake.notify_one();
+}
+
+/*!
+    \brief Calls body with every index from 0 to count - 1, in parallel
+    \param count the number of indices
+    \param body the loop body, called from several threads at once
+*/
+void ThreadPool::parallelFor(std::size_t count, const std::function<void(std::size_t)> &body) {
+    if(count == 0) {
+        return;
+    } else if(count == 1 || mThreads.empty()) {
+        for(std::size_t i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    std::shared_ptr<ParallelLoop> loop = std::make_shared<ParallelLoop>(count, body);
+    const std::size_t helpers = std::min(count - 1, mThreads.size());
+    for(std::size_t i = 0; i < helpers; i++) {
+        submit([loop]() { loop->run(); });
+    }
+    loop->run();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->finishedAll.wait(lock, [&loop]() {
+        return loop->done.load(std::memory_order_acquire) == loop->count;
+    });
+}
+
+/*!
+    \brief The loop of a worker thread
+*/
+void ThreadPool::work() {
+    while(true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this]() { return mStopping || !mTasks.empty(); });
+            if(mTasks.empty()) {
+                return;
+            }
+            task = std::move(mTasks.front());
+            mTasks.pop_front();
+        }
+        task();
+    }
+}
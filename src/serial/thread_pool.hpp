@@ -0,0 +1,53 @@
+/*!
+    \file thread_pool.hpp
+    \brief File to define the ThreadPool class
+*/
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+    \brief Fixed set of worker threads which run queued tasks
+
+    submit() queues a task for any worker. parallelFor() runs a loop body over
+    a range of indices on the workers and the calling thread, and returns once
+    every index is done. Indices are claimed one at a time from a shared
+    counter, so uneven work balances itself.
+
+    parallelFor() may be called from inside a task, the calling thread then
+    does the work no idle worker picks up, so it can't deadlock.
+*/
+class ThreadPool {
+public:
+    explicit ThreadPool(std::size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &other) = delete;
+    ThreadPool& operator=(const ThreadPool &other) = delete;
+
+    static ThreadPool& shared();
+
+    std::size_t threadCount() const;
+
+    void submit(std::function<void()> task);
+    void parallelFor(std::size_t count, const std::function<void(std::size_t)> &body);
+
+private:
+    void work();
+
+    std::vector<std::thread> mThreads; //!< the workers
+    std::deque<std::function<void()>> mTasks; //!< the tasks not started yet
+    std::mutex mMutex; //!< guards mTasks and mStopping
+    std::condition_variable mWake; //!< signalled when a task is queued or on stop
+    bool mStopping; //!< true once the destructor has been called
+};
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,194 @@
+/*!
+    \file varint.cpp
+    \brief file to implement the LEB128 varint encoder and decoders
+*/
+#include "varint.hpp"
+#include "byte_order.hpp"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace {
+
+const uint64_t ContinuationBits = 0x8080808080808080ull;
+
+/*!
+    \brief Loads 8 bytes as a little endian word, whatever the host order
+    \param p the first byte
+    \return the bytes with p[0] in the lowest bits
+*/
+inline uint64_t loadLittleEndian64(const char *p) {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof(word));
+    return SERIAL_HOST_BIG_ENDIAN ? byteSwap64(word) : word;
+}
+
+/*!
+    \brief Returns the index of the lowest set bit
+    \param value a non zero value
+    \return the number of trailing zero bits
+*/
+inline int countTrailingZeros(uint64_t value) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(value);
+#else
+    int count = 0;
+    while(!(value & 1)) {
+        value >>= 1;
+        count++;
+    }
+    return count;
+#endif
+}
+
+/*!
+    \brief Decodes a varint of at most 8 bytes held in a little endian word
+
+    The 7 bit groups are gathered with a fixed sequence of masks and shifts, so
+    there is no loop or branch per byte.
+
+    \param word the next 8 bytes of input
+    \param length the length of the varint, 1 to 8
+    \return the decoded value
+*/
+inline uint64_t gatherGroups(uint64_t word, int length) {
+    if(length < 8) {
+        word &= (1ull << (length * 8)) - 1;
+    }
+
+    return (word & 0x7Full) |
+           ((word & 0x7F00ull) >> 1) |
+           ((word & 0x7F0000ull) >> 2) |
+           ((word & 0x7F000000ull) >> 3) |
+           ((word & 0x7F00000000ull) >> 4) |
+           ((word & 0x7F0000000000ull) >> 5) |
+           ((word & 0x7F000000000000ull) >> 6) |
+           ((word & 0x7F00000000000000ull) >> 7);
+}
+
+} // namespace
+
+/*!
+    \brief Returns the number of bytes encodeVarint uses for value
+    \param value the value to measure
+    \return the encoded length, 1 to MaxVarintLength
+*/
+int varintLength(uint64_t value) {
+    int length = 1;
+    while(value >= 0x80) {
+        value >>= 7;
+        length++;
+    }
+    return length;
+}
+
+/*!
+    \brief Encodes value as a LEB128 varint, 7 bits per byte, low bits first
+    \param value the value to encode
+    \param out where to write, must have room for MaxVarintLength bytes
+    \return the number of bytes written
+*/
+int encodeVarint(uint64_t value, char *out) {
+    int length = 0;
+    while(value >= 0x80) {
+        out[length++] = static_cast<char>(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = static_cast<char>(value);
+    return length;
+}
+
+/*!
+    \brief Decodes one LEB128 varint
+    \param begin the first byte of the varint
+    \param end one past the last readable byte
+    \param value where to store the decoded value
+    \return the number of bytes consumed, 0 if the input ends before the varint
+    does, or -1 if the varint is longer than MaxVarintLength or overflows 64 bits
+*/
+int decodeVarint(const char *begin, const char *end, uint64_t &value) {
+    uint64_t result = 0;
+    for(int i = 0; i < MaxVarintLength; i++) {
+        if(begin + i == end) {
+            return 0;
+        }
+
+        const uint64_t byte = static_cast<uint8_t>(begin[i]);
+        if(i == MaxVarintLength - 1 && byte > 1) {
+            return -1;
+        }
+
+        result |= (byte & 0x7F) << (7 * i);
+        if(!(byte & 0x80)) {
+            value = result;
+            return i + 1;
+        }
+    }
+    return -1;
+}
+
+/*!
+    \brief Decodes up to count consecutive varints
+
+    While at least 16 bytes remain, the continuation bits of 16 bytes are
+    checked at once, and a run of single byte varints is widened in bulk.
+    Other varints of up to 8 bytes are found from the terminating byte in a
+    word of input, so only longer varints and the last few input bytes are
+    decoded a byte at a time.
+
+    \param cursor the first byte to decode, advanced past the decoded varints
+    \param end one past the last readable byte
+    \param values where to store the decoded values
+    \param count the number of values to decode
+    \return the number of values decoded, less than count if the input ends or
+    a varint is malformed; cursor then points at that varint
+*/
+std::size_t decodeVarints(const char *&cursor, const char *end, uint64_t *values,
+                          std::size_t count) {
+    const char *p = cursor;
+    std::size_t decoded = 0;
+
+    while(decoded < count && end - p >= 16) {
+#if defined(__SSE2__)
+        if(count - decoded >= 16) {
+            const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            if(_mm_movemask_epi8(block) == 0) {
+                for(int i = 0; i < 16; i++) {
+                    values[decoded + i] = static_cast<uint8_t>(p[i]);
+                }
+                decoded += 16;
+                p += 16;
+                continue;
+            }
+        }
+#endif
+        const uint64_t word = loadLittleEndian64(p);
+        const uint64_t stops = ~word & ContinuationBits;
+        if(!stops) {
+            const int length = decodeVarint(p, end, values[decoded]);
+            if(length <= 0) {
+                break;
+            }
+            p += length;
+            decoded++;
+            continue;
+        }
+
+        const int length = countTrailingZeros(stops) / 8 + 1;
+        values[decoded++] = gatherGroups(word, length);
+        p += length;
+    }
+
+    while(decoded < count) {
+        const int length = decodeVarint(p, end, values[decoded]);
+        if(length <= 0) {
+            break;
+        }
+        p += length;
+        decoded++;
+    }
+
+    cursor = p;
+    return decoded;
+}
@@ -0,0 +1,41 @@
+/*!
+    \file varint.hpp
+    \brief File to define the LEB128 varint and ZigZag encoding functions
+*/
+
+#ifndef VARINT_HPP
+#define VARINT_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+    \brief The most bytes a varint encoding of a 64 bit value can take
+*/
+const int MaxVarintLength = 10;
+
+/*!
+    \brief Maps a signed value to an unsigned one so small magnitudes stay small
+    \param value the value to map
+    \return 0, -1, 1, -2 ... mapped to 0, 1, 2, 3 ...
+*/
+inline uint64_t zigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+/*!
+    \brief Reverses zigZagEncode
+    \param value the mapped value
+    \return the original signed value
+*/
+inline int64_t zigZagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+int varintLength(uint64_t value);
+int encodeVarint(uint64_t value, char *out);
+int decodeVarint(const char *begin, const char *end, uint64_t &value);
+std::size_t decodeVarints(const char *&cursor, const char *end, uint64_t *values,
+                          std::size_t count);
+
+#endif // VARINT_HPP
@@ -0,0 +1,194 @@
+/*!
+    \file async_writer_test_suite.cpp
+    \brief File to define the implementation of the AsyncWriterTestSuite
+*/
+
+#include "async_writer_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <chrono>
+#include <cstdio>
+
+namespace {
+const char* TestFile = "async_writer_test.bin";
+
+/*!
+    \brief Device which keeps what is written, and blocks writes while closed
+*/
+class GateDevice : public IODevice {
+public:
+    GateDevice() : mOpen(true), mWrites(0), mFlushes(0) {}
+
+    int64_t read(char*, uint64_t) override {
+        return -1;
+    }
+
+    int64_t write(const char *data, uint64_t size) override {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mChanged.wait(lock, [this]() { return mOpen; });
+        mData.append(data, static_cast<int>(size));
+        mWrites++;
+        return static_cast<int64_t>(size);
+    }
+
+    bool flush() override {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFlushes++;
+        return true;
+    }
+
+    void setOpen(bool open) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mOpen = open;
+        }
+        mChanged.notify_all();
+    }
+
+    ByteArray data() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mData;
+    }
+
+    int writes() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mWrites;
+    }
+
+    int flushes() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mFlushes;
+    }
+
+private:
+    std::mutex mMutex;
+    std::condition_variable mChanged;
+    bool mOpen;
+    ByteArray mData;
+    int mWrites;
+    int mFlushes;
+};
+
+/*!
+    \brief Device whose writes always fail
+*/
+class FailingDevice : public IODevice {
+public:
+    int64_t read(char*, uint64_t) override {
+        return -1;
+    }
+
+    int64_t write(const char*, uint64_t) override {
+        return -1;
+    }
+};
+}
+
+/*!
+    \brief Default constructor for the AsyncWriter unit test class
+*/
+AsyncWriterTestSuite::AsyncWriterTestSuite() = default;
+
+/*!
+    \brief Tests writing a file through a ByteStream on the device
+*/
+void AsyncWriterTestSuite::test_stream() {
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        AsyncWriteDevice writer(&file, 3, 4096);
+        ByteStream stream(&writer, ByteStream::OpenMode::WriteOnly, 1000);
+        for(uint32_t i = 0; i < 200000; i++) {
+            stream << i;
+        }
+        CPPUNIT_ASSERT(stream.flush());
+        CPPUNIT_ASSERT(writer.close().get());
+        CPPUNIT_ASSERT(writer.isClosed() && !writer.hasFailed());
+        CPPUNIT_ASSERT(writer.write("late", 4) == -1);
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    ByteStream stream(&file, ByteStream::OpenMode::ReadOnly);
+    for(uint32_t i = 0; i < 200000; i++) {
+        uint32_t value = 0;
+        stream >> value;
+        CPPUNIT_ASSERT(value == i);
+    }
+    CPPUNIT_ASSERT(stream.atEnd());
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests that the producer runs ahead of a blocked device until every
+    buffer is in flight, then waits
+*/
+void AsyncWriterTestSuite::test_backpressure() {
+    GateDevice device;
+    device.setOpen(false);
+    AsyncWriteDevice writer(&device, 3, 100);
+
+    // One buffer blocked in the device, one queued and one being filled
+    const ByteArray chunk(100, 'c');
+    for(int i = 0; i < 3; i++) {
+        CPPUNIT_ASSERT(writer.write(chunk.begin(), 100) == 100);
+    }
+    CPPUNIT_ASSERT(writer.stallCount() == 0);
+
+    std::thread opener([&device]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        device.setOpen(true);
+    });
+    const ByteArray more(250, 'm');
+    CPPUNIT_ASSERT(writer.write(more.begin(), 250) == 250);
+    CPPUNIT_ASSERT(writer.stallCount() > 0);
+    opener.join();
+
+    CPPUNIT_ASSERT(writer.flush());
+    const ByteArray data = device.data();
+    CPPUNIT_ASSERT(data.size() == 550);
+    CPPUNIT_ASSERT(data[299] == 'c' && data[300] == 'm' && data[549] == 'm');
+}
+
+/*!
+    \brief Tests that flush futures complete once the data is on the device
+*/
+void AsyncWriterTestSuite::test_flush() {
+    GateDevice device;
+    AsyncWriteDevice writer(&device, 2, 1024);
+
+    CPPUNIT_ASSERT(writer.write("abc", 3) == 3);
+    device.setOpen(false);
+    std::future<bool> flushed = writer.flushAsync();
+    CPPUNIT_ASSERT(flushed.wait_for(std::chrono::milliseconds(20)) == std::future_status::timeout);
+
+    // The producer carries on while the flush is pending
+    CPPUNIT_ASSERT(writer.write("def", 3) == 3);
+    device.setOpen(true);
+    CPPUNIT_ASSERT(flushed.get());
+    CPPUNIT_ASSERT(device.flushes() >= 1);
+    const ByteArray flushedData = device.data();
+    CPPUNIT_ASSERT(ByteView(flushedData) == ByteView("abc", 3));
+
+    std::future<bool> closed = writer.close();
+    CPPUNIT_ASSERT(closed.get());
+    const ByteArray closedData = device.data();
+    CPPUNIT_ASSERT(ByteView(closedData) == ByteView("abcdef", 6));
+    CPPUNIT_ASSERT(!writer.flushAsync().get());
+    CPPUNIT_ASSERT(writer.close().get());
+}
+
+/*!
+    \brief Tests that a failed device write fails the futures and later writes
+*/
+void AsyncWriterTestSuite::test_failure() {
+    FailingDevice device;
+    AsyncWriteDevice writer(&device, 2, 16);
+    const ByteArray data(40, 'f');
+    writer.write(data.begin(), 40);
+    CPPUNIT_ASSERT(!writer.flushAsync().get());
+    CPPUNIT_ASSERT(writer.hasFailed());
+    CPPUNIT_ASSERT(writer.write(data.begin(), 40) == -1);
+    CPPUNIT_ASSERT(!writer.close().get());
+}
+
+MAINLESS_TEST(AsyncWriterTestSuite)
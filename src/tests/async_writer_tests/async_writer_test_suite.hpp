@@ -0,0 +1,40 @@
+/*!
+    \file async_writer_test_suite.hpp
+    \brief File to define the AsyncWriterTestSuite class
+*/
+
+#ifndef ASYNC_WRITER_TEST_SUITE_HPP
+#define ASYNC_WRITER_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "async_writer.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the AsyncWriteDevice
+    class
+*/
+class AsyncWriterTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(AsyncWriterTestSuite);
+
+    CPPUNIT_TEST(test_stream);
+    CPPUNIT_TEST(test_backpressure);
+    CPPUNIT_TEST(test_flush);
+    CPPUNIT_TEST(test_failure);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    AsyncWriterTestSuite();
+    ~AsyncWriterTestSuite() = default;
+
+private:
+    void test_stream();
+    void test_backpressure();
+    void test_flush();
+    void test_failure();
+};
+
+#endif
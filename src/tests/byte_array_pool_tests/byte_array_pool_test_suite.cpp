@@ -0,0 +1,124 @@
+/*!
+    \file byte_array_pool_test_suite.cpp
+    \brief File to define the implementation of the ByteArrayPoolTestSuite
+*/
+
+#include "byte_array_pool_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <cstring>
+#include <thread>
+
+/*!
+    \brief Default constructor for the Byte Array Pool unit test class
+*/
+ByteArrayPoolTestSuite::ByteArrayPoolTestSuite() = default;
+
+/*!
+    \brief Tests that acquired arrays are empty, reserved and use the pool
+*/
+void ByteArrayPoolTestSuite::test_acquire() {
+    ByteArrayPool pool;
+    ByteArray array = pool.acquire(100);
+
+    CPPUNIT_ASSERT(array.empty());
+    CPPUNIT_ASSERT(array.allocator() == &pool);
+    CPPUNIT_ASSERT(array.capacity() == 128);
+    CPPUNIT_ASSERT(pool.heapAllocations() == 1);
+
+    ByteArray small = pool.acquire(ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(small.capacity() == ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(pool.heapAllocations() == 1);
+
+    CPPUNIT_ASSERT(&ByteArrayPool::local() == &ByteArrayPool::local());
+}
+
+/*!
+    \brief Tests that growing an array recycles the buffers it outgrows
+*/
+void ByteArrayPoolTestSuite::test_growth() {
+    ByteArrayPool pool;
+    {
+        ByteArray array = pool.acquire();
+        for(int i = 0; i < 1000; i++) {
+            array.append(1, static_cast<char>(i));
+        }
+        CPPUNIT_ASSERT(array.size() == 1000);
+        CPPUNIT_ASSERT(array.capacity() == 1024);
+        for(int i = 0; i < 1000; i++) {
+            CPPUNIT_ASSERT(array[i] == static_cast<char>(i));
+        }
+        // Every buffer outgrown past the inline storage is kept
+        CPPUNIT_ASSERT(pool.cachedBlocks() == 3);
+
+        ByteArray large = pool.acquire(2 * ByteArrayPool::MaxBlockSize);
+        CPPUNIT_ASSERT(large.capacity() == static_cast<int>(2 * ByteArrayPool::MaxBlockSize));
+    }
+    // The large buffer is not cached
+    CPPUNIT_ASSERT(pool.cachedBlocks() == 4);
+
+    pool.trim();
+    CPPUNIT_ASSERT(pool.cachedBlocks() == 0);
+}
+
+/*!
+    \brief Tests that a steady workload stops allocating from the heap
+*/
+void ByteArrayPoolTestSuite::test_steadyState() {
+    ByteArrayPool pool;
+    uint64_t warmedUp = 0;
+    for(int message = 0; message < 100; message++) {
+        ByteArray array = pool.acquire(256);
+        ByteStream stream(&array, ByteStream::OpenMode::Append);
+        for(uint32_t i = 0; i < 64; i++) {
+            stream << i;
+        }
+        CPPUNIT_ASSERT(array.size() == 256);
+
+        if(message == 0) {
+            warmedUp = pool.heapAllocations();
+        }
+    }
+    CPPUNIT_ASSERT(pool.heapAllocations() == warmedUp);
+}
+
+/*!
+    \brief Tests moving, copying and releasing pooled arrays
+*/
+void ByteArrayPoolTestSuite::test_moveAndRelease() {
+    ByteArrayPool pool;
+    ByteArray array = pool.acquire(100);
+    array.append("pooled");
+
+    ByteArray copy(array);
+    CPPUNIT_ASSERT(copy.allocator() == nullptr);
+
+    ByteArray moved(std::move(array));
+    CPPUNIT_ASSERT(moved.allocator() == &pool);
+    CPPUNIT_ASSERT(array.empty());
+
+    moved = copy;
+    CPPUNIT_ASSERT(moved.allocator() == &pool);
+
+    std::unique_ptr<char[]> released = moved.release();
+    CPPUNIT_ASSERT(std::memcmp(released.get(), "pooled", 6) == 0);
+    CPPUNIT_ASSERT(moved.empty() && moved.capacity() == ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(pool.cachedBlocks() == 1);
+}
+
+/*!
+    \brief Tests that buffers freed on another thread are not cached
+*/
+void ByteArrayPoolTestSuite::test_otherThread() {
+    ByteArrayPool pool;
+    ByteArray array = pool.acquire(128);
+
+    std::thread([&array]() {
+        ByteArray destroyed(std::move(array));
+    }).join();
+
+    CPPUNIT_ASSERT(pool.cachedBlocks() == 0);
+}
+
+MAINLESS_TEST(ByteArrayPoolTestSuite)
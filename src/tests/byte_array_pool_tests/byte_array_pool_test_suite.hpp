@@ -0,0 +1,41 @@
+/*!
+    \file byte_array_pool_test_suite.hpp
+    \brief File to define the ByteArrayPoolTestSuite class
+*/
+
+#ifndef BYTE_ARRAY_POOL_TEST_SUITE_HPP
+#define BYTE_ARRAY_POOL_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "byte_array_pool.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the ByteArrayPool class
+*/
+class ByteArrayPoolTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ByteArrayPoolTestSuite);
+
+    CPPUNIT_TEST(test_acquire);
+    CPPUNIT_TEST(test_growth);
+    CPPUNIT_TEST(test_steadyState);
+    CPPUNIT_TEST(test_moveAndRelease);
+    CPPUNIT_TEST(test_otherThread);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    ByteArrayPoolTestSuite();
+    ~ByteArrayPoolTestSuite() = default;
+
+private:
+    void test_acquire();
+    void test_growth();
+    void test_steadyState();
+    void test_moveAndRelease();
+    void test_otherThread();
+};
+
+#endif
@@ -0,0 +1,172 @@
+/*!
+    \file byte_array_queue_test_suite.cpp
+    \brief File to define the implementation of the ByteArrayQueueTestSuite
+*/
+
+#include "byte_array_queue_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <thread>
+#include <vector>
+
+namespace {
+const uint32_t ItemsPerProducer = 100000;
+
+/*!
+    \brief Returns an array holding the producer and sequence number, padded
+    to the heap for some of them
+*/
+ByteArray item(uint32_t producer, uint32_t sequence) {
+    ByteArray array;
+    ByteStream stream(&array, ByteStream::OpenMode::Append);
+    stream << producer;
+    stream << sequence;
+    if(sequence % 64 == 0) {
+        stream.writeBytes(ByteArray(200, 'h').begin(), 200);
+    }
+    return array;
+}
+
+void readItem(const ByteArray &array, uint32_t &producer, uint32_t &sequence) {
+    ByteStream stream{ByteView(array)};
+    stream >> producer;
+    stream >> sequence;
+}
+
+/*!
+    \brief Pops until every producer has delivered ItemsPerProducer arrays,
+    checking each producer's arrays come in order
+*/
+template<typename Queue>
+void consume(Queue &queue, uint32_t producers) {
+    std::vector<uint32_t> next(producers, 0);
+    uint64_t remaining = static_cast<uint64_t>(producers) * ItemsPerProducer;
+    ByteArray batch[32];
+    while(remaining > 0) {
+        const std::size_t count = queue.popBatch(batch, 32);
+        if(count == 0) {
+            std::this_thread::yield();
+        }
+        for(std::size_t i = 0; i < count; i++) {
+            uint32_t producer = 0;
+            uint32_t sequence = 0;
+            readItem(batch[i], producer, sequence);
+            CPPUNIT_ASSERT(producer < producers && sequence == next[producer]);
+            next[producer]++;
+        }
+        remaining -= count;
+    }
+    CPPUNIT_ASSERT(queue.empty());
+}
+
+template<typename Queue>
+void produce(Queue &queue, uint32_t producer) {
+    for(uint32_t i = 0; i < ItemsPerProducer; i++) {
+        ByteArray array = item(producer, i);
+        while(!queue.tryPush(std::move(array))) {
+            std::this_thread::yield();
+        }
+    }
+}
+}
+
+/*!
+    \brief Default constructor for the ByteArrayQueue unit test class
+*/
+ByteArrayQueueTestSuite::ByteArrayQueueTestSuite() = default;
+
+/*!
+    \brief Tests the single producer queue on one thread
+*/
+void ByteArrayQueueTestSuite::test_spsc() {
+    SpscByteArrayQueue queue(5);
+    CPPUNIT_ASSERT(queue.capacity() == 8);
+    CPPUNIT_ASSERT(queue.empty());
+
+    // Buffers on the heap change hands without a copy
+    ByteArray large(1000, 'L');
+    const char* data = large.begin();
+    CPPUNIT_ASSERT(queue.tryPush(std::move(large)));
+    CPPUNIT_ASSERT(large.empty());
+    ByteArray popped;
+    CPPUNIT_ASSERT(queue.tryPop(popped));
+    CPPUNIT_ASSERT(popped.begin() == data && popped.size() == 1000);
+    CPPUNIT_ASSERT(!queue.tryPop(popped));
+
+    for(uint32_t i = 0; i < 8; i++) {
+        CPPUNIT_ASSERT(queue.tryPush(item(0, i)));
+    }
+    ByteArray full("full");
+    CPPUNIT_ASSERT(!queue.tryPush(std::move(full)));
+    CPPUNIT_ASSERT(full.size() == 4);
+    CPPUNIT_ASSERT(queue.size() == 8);
+
+    ByteArray batch[5];
+    CPPUNIT_ASSERT(queue.popBatch(batch, 5) == 5);
+    CPPUNIT_ASSERT(queue.popBatch(batch, 5) == 3);
+    uint32_t producer = 0;
+    uint32_t sequence = 0;
+    readItem(batch[2], producer, sequence);
+    CPPUNIT_ASSERT(sequence == 7);
+    CPPUNIT_ASSERT(queue.popBatch(batch, 5) == 0);
+}
+
+/*!
+    \brief Tests the single producer queue between two threads
+*/
+void ByteArrayQueueTestSuite::test_spscThreads() {
+    SpscByteArrayQueue queue(64);
+    std::thread producer([&queue]() { produce(queue, 0); });
+    consume(queue, 1);
+    producer.join();
+}
+
+/*!
+    \brief Tests the multi producer queue on one thread
+*/
+void ByteArrayQueueTestSuite::test_mpsc() {
+    MpscByteArrayQueue queue(4);
+    ByteArray large(1000, 'L');
+    const char* data = large.begin();
+    CPPUNIT_ASSERT(queue.tryPush(std::move(large)));
+    ByteArray popped;
+    CPPUNIT_ASSERT(queue.tryPop(popped));
+    CPPUNIT_ASSERT(popped.begin() == data);
+
+    // Wrap around the ring a few times
+    for(uint32_t lap = 0; lap < 3; lap++) {
+        for(uint32_t i = 0; i < 4; i++) {
+            CPPUNIT_ASSERT(queue.tryPush(item(lap, i)));
+        }
+        ByteArray full("full");
+        CPPUNIT_ASSERT(!queue.tryPush(std::move(full)));
+        CPPUNIT_ASSERT(full.size() == 4 && queue.size() == 4);
+
+        ByteArray batch[8];
+        CPPUNIT_ASSERT(queue.popBatch(batch, 8) == 4);
+        uint32_t producer = 0;
+        uint32_t sequence = 0;
+        readItem(batch[3], producer, sequence);
+        CPPUNIT_ASSERT(producer == lap && sequence == 3);
+        CPPUNIT_ASSERT(queue.empty());
+    }
+}
+
+/*!
+    \brief Tests the multi producer queue with several producer threads
+*/
+void ByteArrayQueueTestSuite::test_mpscThreads() {
+    const uint32_t producers = 4;
+    MpscByteArrayQueue queue(128);
+    std::vector<std::thread> threads;
+    for(uint32_t i = 0; i < producers; i++) {
+        threads.push_back(std::thread([&queue, i]() { produce(queue, i); }));
+    }
+    consume(queue, producers);
+    for(std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+MAINLESS_TEST(ByteArrayQueueTestSuite)
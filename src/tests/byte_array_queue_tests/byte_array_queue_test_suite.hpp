@@ -0,0 +1,40 @@
+/*!
+    \file byte_array_queue_test_suite.hpp
+    \brief File to define the ByteArrayQueueTestSuite class
+*/
+
+#ifndef BYTE_ARRAY_QUEUE_TEST_SUITE_HPP
+#define BYTE_ARRAY_QUEUE_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "byte_array_queue.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the SpscByteArrayQueue
+    and MpscByteArrayQueue classes
+*/
+class ByteArrayQueueTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ByteArrayQueueTestSuite);
+
+    CPPUNIT_TEST(test_spsc);
+    CPPUNIT_TEST(test_spscThreads);
+    CPPUNIT_TEST(test_mpsc);
+    CPPUNIT_TEST(test_mpscThreads);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    ByteArrayQueueTestSuite();
+    ~ByteArrayQueueTestSuite() = default;
+
+private:
+    void test_spsc();
+    void test_spscThreads();
+    void test_mpsc();
+    void test_mpscThreads();
+};
+
+#endif
@@ -6,6 +6,9 @@
 #include "byte_array_test_suite.hpp"
 #include "common.hpp"
 
+#include <algorithm>
+#include <limits>
+
 /*!
     \brief Default constructor for the Byte Array unit test class
 */
@@ -120,6 +123,17 @@ void ByteArrayTestSuite::test_append() {
     arrayFour.append("\0", 1);
 
     checkArray(arrayFour);
+
+    // Appending part of the array to itself, while it reallocates
+    ByteArray self(ByteArray::InlineCapacity, 'a');
+    self[0] = 'b';
+    for(int i = 0; i < 4; i++) {
+        self.append(self.constData(), self.size());
+    }
+    CPPUNIT_ASSERT(self.size() == ByteArray::InlineCapacity * 16);
+    CPPUNIT_ASSERT(self.at(ByteArray::InlineCapacity * 15) == 'b');
+    self.append(self.constData() + 1, 50);
+    CPPUNIT_ASSERT(self.back() == 'a' && self.size() == ByteArray::InlineCapacity * 16 + 50);
 }
 
 void ByteArrayTestSuite::test_at()
@@ -162,4 +176,142 @@ void ByteArrayTestSuite::test_operators()
 
 }
 
+/*!
+    \brief Unit test to test reserve, capacity, shrink_to_fit, clear and
+    growing past the largest size
+*/
+void ByteArrayTestSuite::test_capacity() {
+    ByteArray array;
+    array.reserve(64);
+
+    CPPUNIT_ASSERT(array.empty());
+    CPPUNIT_ASSERT(array.capacity() >= 64);
+
+    array.append(64, 'a');
+    const char* storage = array.constData();
+    CPPUNIT_ASSERT(array.size() == 64);
+
+    array.clear();
+    CPPUNIT_ASSERT(array.empty());
+    CPPUNIT_ASSERT(array.capacity() >= 64);
+
+    array.append(64, 'b');
+    CPPUNIT_ASSERT(array.constData() == storage);
+
+    array.append(1, 'c');
+    CPPUNIT_ASSERT(array.capacity() >= 128);
+
+    array.shrink_to_fit();
+    CPPUNIT_ASSERT(array.size() == 65);
+    CPPUNIT_ASSERT(array.back() == 'c');
+
+    const int capacity = array.capacity();
+    array.truncate(10);
+    CPPUNIT_ASSERT(array.size() == 10 && array.back() == 'b');
+    CPPUNIT_ASSERT(array.capacity() == capacity);
+    array.truncate(20);
+    CPPUNIT_ASSERT(array.size() == 10);
+
+    // Growing past INT_MAX bytes fails and leaves the array alone
+    CPPUNIT_ASSERT(array.extend(std::numeric_limits<int>::max()) == nullptr);
+    array.append(std::numeric_limits<int>::max(), 'd');
+    array.append(-1, 'd');
+    CPPUNIT_ASSERT(array.size() == 10 && array.back() == 'b');
+    CPPUNIT_ASSERT(array.capacity() == capacity);
+}
+
+/*!
+    \brief Unit test to test that moving an array doesn't copy its storage
+*/
+void ByteArrayTestSuite::test_move() {
+    const int size = ByteArray::InlineCapacity + 4;
+    ByteArray array(size, '1');
+    const char* storage = array.constData();
+
+    ByteArray moved(std::move(array));
+    CPPUNIT_ASSERT(moved.constData() == storage);
+    CPPUNIT_ASSERT(moved.size() == size);
+    CPPUNIT_ASSERT(array.empty());
+    CPPUNIT_ASSERT(moved.in_avail() == size);
+    CPPUNIT_ASSERT(array.in_avail() == 0);
+
+    ByteArray assigned;
+    assigned = std::move(moved);
+    CPPUNIT_ASSERT(assigned.constData() == storage);
+    CPPUNIT_ASSERT(moved.empty());
+
+    std::vector<ByteArray> arrays;
+    arrays.push_back(std::move(assigned));
+    arrays.reserve(16);
+    CPPUNIT_ASSERT(arrays[0].constData() == storage);
+    CPPUNIT_ASSERT(arrays[0].sgetc() == '1');
+}
+
+/*!
+    \brief Unit test to test adopting and releasing storage without copies
+*/
+void ByteArrayTestSuite::test_adoptRelease() {
+    std::unique_ptr<char[]> buffer(new char[3]);
+    std::copy_n("abc", 3, buffer.get());
+    const char* storage = buffer.get();
+
+    ByteArray array(std::move(buffer), 3);
+    CPPUNIT_ASSERT(array.constData() == storage);
+    CPPUNIT_ASSERT(array.size() == 3);
+    CPPUNIT_ASSERT(array.at(2) == 'c');
+
+    std::unique_ptr<char[]> released = array.release();
+    CPPUNIT_ASSERT(released.get() == storage);
+    CPPUNIT_ASSERT(array.empty());
+
+    std::vector<char> vector(4, 'v');
+    const char* vectorStorage = vector.data();
+    ByteArray fromVector(std::move(vector));
+    CPPUNIT_ASSERT(fromVector.constData() == vectorStorage);
+    CPPUNIT_ASSERT(fromVector.size() == 4);
+
+    fromVector.append(1, 'w');
+    CPPUNIT_ASSERT(fromVector.size() == 5);
+    CPPUNIT_ASSERT(fromVector.back() == 'w');
+    CPPUNIT_ASSERT(fromVector.front() == 'v');
+}
+
+/*!
+    \brief Unit test to test that small data stays inside the array
+*/
+void ByteArrayTestSuite::test_inline() {
+    ByteArray array;
+    CPPUNIT_ASSERT(array.capacity() == ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(array.constData() == nullptr);
+
+    array.append(ByteArray::InlineCapacity, 'a');
+    const char* inlineStorage = array.constData();
+    CPPUNIT_ASSERT(array.capacity() == ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(inlineStorage >= reinterpret_cast<const char*>(&array) &&
+                   inlineStorage < reinterpret_cast<const char*>(&array + 1));
+
+    array.append(1, 'b');
+    CPPUNIT_ASSERT(array.capacity() > ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(array.constData() != inlineStorage);
+    CPPUNIT_ASSERT(array.size() == ByteArray::InlineCapacity + 1);
+    CPPUNIT_ASSERT(array.front() == 'a' && array.back() == 'b');
+    CPPUNIT_ASSERT(array.in_avail() == array.size());
+
+    array.clear();
+    array.append("abc");
+    array.shrink_to_fit();
+    CPPUNIT_ASSERT(array.constData() == inlineStorage);
+    CPPUNIT_ASSERT(array.capacity() == ByteArray::InlineCapacity);
+    CPPUNIT_ASSERT(array.sgetc() == 'a' && array.in_avail() == 3);
+
+    ByteArray moved(std::move(array));
+    CPPUNIT_ASSERT(moved.constData() != inlineStorage);
+    CPPUNIT_ASSERT(moved.size() == 3 && moved.at(2) == 'c');
+    CPPUNIT_ASSERT(moved.sgetc() == 'a');
+    CPPUNIT_ASSERT(array.empty() && array.in_avail() == 0);
+
+    std::unique_ptr<char[]> released = moved.release();
+    CPPUNIT_ASSERT(std::equal(released.get(), released.get() + 3, "abc"));
+}
+
 MAINLESS_TEST(ByteArrayTestSuite)
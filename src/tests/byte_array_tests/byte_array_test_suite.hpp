@@ -30,6 +30,10 @@ class ByteArrayTestSuite : public CppUnit::TestFixture {
     CPPUNIT_TEST(test_empty);
     CPPUNIT_TEST(test_size);
     CPPUNIT_TEST(test_operators);
+    CPPUNIT_TEST(test_capacity);
+    CPPUNIT_TEST(test_move);
+    CPPUNIT_TEST(test_adoptRelease);
+    CPPUNIT_TEST(test_inline);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -50,6 +54,10 @@ private:
     void test_empty();
     void test_size();
     void test_operators();
+    void test_capacity();
+    void test_move();
+    void test_adoptRelease();
+    void test_inline();
 };
 
 #endif
@@ -1,4 +1,436 @@
-#include "common.hpp"
+/*!
+    \file byte_stream_test_suite.cpp
+    \brief File to define the implementation of the ByteStreamTestSuite
+*/
+
 #include "byte_stream_test_suite.hpp"
+#include "common.hpp"
+#include "fixed_order_byte_stream.hpp"
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace {
+/*!
+    \brief True if T has an accessible setIntegerEncoding()
+*/
+template<typename T, typename = void>
+struct CanSetIntegerEncoding : std::false_type {};
+
+template<typename T>
+struct CanSetIntegerEncoding<T, decltype(std::declval<T&>().setIntegerEncoding(
+                                    ByteStream::IntegerEncoding::Varint))> : std::true_type {};
+
+/*!
+    \brief Returns the byte a bool is stored as
+*/
+unsigned char boolByte(bool b) {
+    unsigned char byte;
+    std::memcpy(&byte, &b, sizeof(byte));
+    return byte;
+}
+}
+
+/*!
+    \brief Default constructor for the Byte Stream unit test class
+*/
+ByteStreamTestSuite::ByteStreamTestSuite() = default;
+
+/*!
+    \brief Tests that values written into a fixed size array can be read back
+*/
+void ByteStreamTestSuite::test_readWrite() {
+    ByteArray array(15, 0);
+    ByteStream writer(&array, ByteStream::OpenMode::WriteOnly);
+
+    writer << static_cast<uint8_t>(7);
+    writer << static_cast<int16_t>(-2);
+    writer << static_cast<uint32_t>(123456);
+    writer << 2.5;
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(writer.atEnd());
+
+    writer << static_cast<uint8_t>(1);
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::ReadWritePastEnd);
+
+    ByteStream reader(&array, ByteStream::OpenMode::ReadOnly);
+    uint8_t u8 = 0;
+    int16_t i16 = 0;
+    uint32_t u32 = 0;
+    double d = 0;
+    reader >> u8;
+    reader >> i16;
+    reader >> u32;
+    reader >> d;
+
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(u8 == 7);
+    CPPUNIT_ASSERT(i16 == -2);
+    CPPUNIT_ASSERT(u32 == 123456);
+    CPPUNIT_ASSERT(d == 2.5);
+}
+
+/*!
+    \brief Tests that a stream in Append mode grows the array it writes into
+*/
+void ByteStreamTestSuite::test_appendMode() {
+    ByteArray array("ab", 2);
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+
+    for(uint32_t i = 0; i < 1000; i++) {
+        writer << i;
+    }
+    CPPUNIT_ASSERT(writer.writeRawData("cd", 2) == 2);
+
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(array.size() == 2 + 1000 * 4 + 2);
+    CPPUNIT_ASSERT(array.at(0) == 'a' && array.at(1) == 'b');
+    CPPUNIT_ASSERT(array.back() == 'd');
+
+    ByteStream reader(&array, ByteStream::OpenMode::ReadOnly);
+    CPPUNIT_ASSERT(reader.skipRawData(2) == 2);
+    for(uint32_t i = 0; i < 1000; i++) {
+        uint32_t value = 0;
+        reader >> value;
+        CPPUNIT_ASSERT(value == i);
+    }
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+}
+
+/*!
+    \brief Tests that streams keep working when their array is appended to
+    outside them, and reallocates
+*/
+void ByteStreamTestSuite::test_arrayGrownOutside() {
+    ByteArray array;
+    ByteStream reader(&array, ByteStream::OpenMode::ReadOnly);
+    ByteStream first(&array, ByteStream::OpenMode::Append);
+    ByteStream second(&array, ByteStream::OpenMode::Append);
+
+    first << static_cast<uint32_t>(1);
+    second << static_cast<uint32_t>(2);
+    first << static_cast<uint32_t>(3);
+    CPPUNIT_ASSERT(array.size() == 12);
+
+    // Enough to move the array out of its inline storage and reallocate
+    const std::string text(4096, 'x');
+    array.append(text.data(), static_cast<int>(text.size()));
+    first << static_cast<uint32_t>(4);
+    CPPUNIT_ASSERT(first.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(second.status() == ByteStream::Status::Ok);
+
+    for(uint32_t i = 1; i <= 3; i++) {
+        uint32_t value = 0;
+        reader >> value;
+        CPPUNIT_ASSERT(value == i);
+    }
+    CPPUNIT_ASSERT(reader.skipRawData(4096) == 4096);
+    uint32_t last = 0;
+    reader >> last;
+    CPPUNIT_ASSERT(last == 4);
+    CPPUNIT_ASSERT(reader.atEnd());
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+
+    // A reader past the end of a cleared array stops at the end
+    array.clear();
+    reader >> last;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(last == 4);
+}
+
+/*!
+    \brief Tests reading from memory the stream does not own
+*/
+void ByteStreamTestSuite::test_viewDevice() {
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer << static_cast<uint16_t>(513);
+    writer << static_cast<int64_t>(-5);
+
+    // Copy into a plain buffer, as if it came from a socket
+    std::vector<char> packet(array.begin(), array.end());
+    ByteStream reader(ByteView(packet.data(), packet.size()));
+    CPPUNIT_ASSERT(reader.device() == nullptr);
+    CPPUNIT_ASSERT(reader.mode() == ByteStream::OpenMode::ReadOnly);
+
+    uint16_t u16 = 0;
+    int64_t i64 = 0;
+    reader >> u16;
+    reader >> i64;
+    CPPUNIT_ASSERT(u16 == 513);
+    CPPUNIT_ASSERT(i64 == -5);
+    CPPUNIT_ASSERT(reader.atEnd());
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+
+    CPPUNIT_ASSERT(reader.writeRawData("x", 1) == -1);
+    reader >> u16;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadWritePastEnd);
+}
+
+/*!
+    \brief Tests that values are encoded in the byte order of the stream
+*/
+void ByteStreamTestSuite::test_byteOrder() {
+    ByteArray big;
+    ByteStream bigWriter(&big, ByteStream::OpenMode::Append);
+    CPPUNIT_ASSERT(bigWriter.order() == ByteStream::ByteOrder::BigEndian);
+    bigWriter << static_cast<uint32_t>(0x01020304);
+    bigWriter << static_cast<int16_t>(0x0506);
+    bigWriter << 1.0f;
+    CPPUNIT_ASSERT(ByteView(big) == ByteView("\x01\x02\x03\x04\x05\x06\x3f\x80\x00\x00", 10));
+
+    ByteArray little;
+    ByteStream littleWriter(&little, ByteStream::OpenMode::Append);
+    littleWriter.setByteOrder(ByteStream::ByteOrder::LittleEndian);
+    littleWriter << static_cast<uint32_t>(0x01020304);
+    littleWriter << static_cast<int16_t>(0x0506);
+    littleWriter << 1.0f;
+    CPPUNIT_ASSERT(ByteView(little) == ByteView("\x04\x03\x02\x01\x06\x05\x00\x00\x80\x3f", 10));
+
+    ByteStream reader{ByteView(big)};
+    uint32_t u32 = 0;
+    int16_t i16 = 0;
+    float f = 0;
+    reader >> u32;
+    reader >> i16;
+    reader >> f;
+    CPPUNIT_ASSERT(u32 == 0x01020304);
+    CPPUNIT_ASSERT(i16 == 0x0506);
+    CPPUNIT_ASSERT(f == 1.0f);
+}
+
+/*!
+    \brief Tests that streams with a fixed byte order encode like ByteStream
+*/
+void ByteStreamTestSuite::test_fixedByteOrder() {
+    ByteArray expected;
+    ByteStream writer(&expected, ByteStream::OpenMode::Append);
+    writer.setByteOrder(ByteStream::ByteOrder::LittleEndian);
+    writer << static_cast<uint64_t>(0x0102030405060708);
+    writer << -2.5;
+
+    ByteArray array;
+    LittleEndianByteStream littleWriter(&array, ByteStream::OpenMode::Append);
+    littleWriter << static_cast<uint64_t>(0x0102030405060708);
+    littleWriter << -2.5;
+    CPPUNIT_ASSERT(ByteView(array) == ByteView(expected));
+
+    BigEndianByteStream bigReader{ByteView(array)};
+    uint64_t swapped = 0;
+    bigReader >> swapped;
+    CPPUNIT_ASSERT(swapped == 0x0807060504030201);
+
+    LittleEndianByteStream littleReader{ByteView(array)};
+    uint64_t u64 = 0;
+    double d = 0;
+    littleReader >> u64;
+    littleReader >> d;
+    CPPUNIT_ASSERT(u64 == 0x0102030405060708);
+    CPPUNIT_ASSERT(d == -2.5);
+
+    littleReader >> d;
+    CPPUNIT_ASSERT(littleReader.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(d == -2.5);
+
+    // Fixed order streams only encode integers fixed width
+    static_assert(CanSetIntegerEncoding<ByteStream>::value, "ByteStream sets its encoding");
+    static_assert(!CanSetIntegerEncoding<LittleEndianByteStream>::value,
+                  "a fixed order stream can't change its integer encoding");
+    CPPUNIT_ASSERT(littleWriter.integerEncoding() == ByteStream::IntegerEncoding::Fixed);
+    littleWriter << static_cast<uint32_t>(1);
+    CPPUNIT_ASSERT(array.size() == 20);
+}
+
+/*!
+    \brief Tests that bulk arrays encode exactly like writing each element
+*/
+void ByteStreamTestSuite::test_arrays() {
+    std::vector<uint16_t> shorts;
+    std::vector<uint32_t> ints;
+    std::vector<double> doubles;
+    for(int i = 0; i < 1001; i++) {
+        shorts.push_back(static_cast<uint16_t>(i * 257));
+        ints.push_back(static_cast<uint32_t>(i) * 16843009u);
+        doubles.push_back(i * 0.25 - 100);
+    }
+
+    for(auto order : {ByteStream::ByteOrder::BigEndian, ByteStream::ByteOrder::LittleEndian}) {
+        ByteArray expected;
+        ByteStream elementWriter(&expected, ByteStream::OpenMode::Append);
+        elementWriter.setByteOrder(order);
+        for(auto value : shorts) {
+            elementWriter << value;
+        }
+        for(auto value : ints) {
+            elementWriter << value;
+        }
+        for(auto value : doubles) {
+            elementWriter << value;
+        }
+
+        ByteArray array;
+        ByteStream writer(&array, ByteStream::OpenMode::Append);
+        writer.setByteOrder(order);
+        writer.writeArray(shorts);
+        writer.writeArray(ints.data(), ints.size());
+        writer.writeArray(doubles);
+        CPPUNIT_ASSERT(ByteView(array) == ByteView(expected));
+
+        ByteStream reader{ByteView(array)};
+        reader.setByteOrder(order);
+        std::vector<uint16_t> readShorts;
+        std::vector<uint32_t> readInts;
+        std::vector<double> readDoubles;
+        reader.readArray(readShorts, shorts.size());
+        reader.readArray(readInts, ints.size());
+        reader.readArray(readDoubles, doubles.size());
+        CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+        CPPUNIT_ASSERT(readShorts == shorts);
+        CPPUNIT_ASSERT(readInts == ints);
+        CPPUNIT_ASSERT(readDoubles == doubles);
+    }
+
+    ByteArray small(6, 0);
+    ByteStream writer(&small, ByteStream::OpenMode::WriteOnly);
+    writer.writeArray(ints.data(), 2);
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(small.at(0) == 0);
+}
+
+/*!
+    \brief Tests batched writes and reads, and that they fail as a whole
+*/
+void ByteStreamTestSuite::test_batches() {
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    for(uint32_t i = 0; i < 100; i++) {
+        ByteStream::WriteBatch batch(writer, 15);
+        CPPUNIT_ASSERT(batch);
+        batch.put(i);
+        batch.put(static_cast<uint16_t>(i * 3));
+        batch.put(static_cast<uint8_t>(i));
+        batch.putBytes("abcd", 4);
+        batch.put(static_cast<float>(i) / 2);
+        CPPUNIT_ASSERT(batch.remaining() == 0);
+    }
+    CPPUNIT_ASSERT(array.size() == 1500);
+    CPPUNIT_ASSERT(array.at(3) == 0 && array.at(4) == 0 && array.at(5) == 0 && array.at(18) == 1);
+
+    ByteStream reader{ByteView(array)};
+    for(uint32_t i = 0; i < 100; i++) {
+        ByteStream::ReadBatch batch(reader, 15);
+        CPPUNIT_ASSERT(batch);
+        CPPUNIT_ASSERT(batch.get<uint32_t>() == i);
+        CPPUNIT_ASSERT(batch.get<uint16_t>() == i * 3);
+        uint8_t byte = 0;
+        batch.get(byte);
+        CPPUNIT_ASSERT(byte == i);
+        CPPUNIT_ASSERT(batch.getBytes(4) == ByteView("abcd", 4));
+        CPPUNIT_ASSERT(batch.get<float>() == static_cast<float>(i) / 2);
+    }
+    CPPUNIT_ASSERT(reader.atEnd());
+
+    {
+        ByteStream::ReadBatch batch(reader, 1);
+        CPPUNIT_ASSERT(!batch);
+        CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadWritePastEnd);
+    }
+
+    ByteArray small(6, 0);
+    ByteStream fixed(&small, ByteStream::OpenMode::WriteOnly);
+    {
+        ByteStream::WriteBatch batch(fixed, 8);
+        CPPUNIT_ASSERT(!batch);
+    }
+    CPPUNIT_ASSERT(fixed.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(small.at(0) == 0);
+}
+
+/*!
+    \brief Tests that strings round trip, and are decoded without copies
+*/
+void ByteStreamTestSuite::test_strings() {
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    const char* key = "key";
+    writer << key;
+    writer << std::string("a path/with spaces");
+    writer << "literal";
+    writer << ByteView("", 0);
+    writer << std::string(300, 's');
+    CPPUNIT_ASSERT(array.at(0) == 3);
+    CPPUNIT_ASSERT(array.size() == 1 + 3 + 1 + 18 + 1 + 7 + 1 + 2 + 300);
+
+    ByteStream reader{ByteView(array)};
+    ByteView view;
+    reader >> view;
+    CPPUNIT_ASSERT(view == ByteView("key", 3));
+    CPPUNIT_ASSERT(view.data() == array.constData() + 1);
+
+    std::string text;
+    reader >> text;
+    CPPUNIT_ASSERT(text == "a path/with spaces");
+
+    const char* owned = nullptr;
+    reader >> owned;
+    CPPUNIT_ASSERT(std::string(owned) == "literal");
+    delete[] owned;
+
+    reader.readStringView(view);
+    CPPUNIT_ASSERT(view.empty());
+    reader.readString(text);
+    CPPUNIT_ASSERT(text == std::string(300, 's'));
+    CPPUNIT_ASSERT(reader.atEnd());
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+
+    // A length longer than the data fails without touching the output
+    ByteStream truncated{ByteView(array).slice(0, 3)};
+    text = "unchanged";
+    truncated >> text;
+    CPPUNIT_ASSERT(truncated.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(text == "unchanged");
+
+    // So does a length over the limit, as corrupt data
+    ByteStream limited{ByteView(array)};
+    limited.setMaxStringLength(100);
+    CPPUNIT_ASSERT(limited.maxStringLength() == 100);
+    CPPUNIT_ASSERT(reader.maxStringLength() == ByteStream::DefaultMaxStringLength);
+    limited >> text;
+    CPPUNIT_ASSERT(limited.skipRawData(1 + 18 + 1 + 7 + 1) == 28);
+    limited >> text;
+    CPPUNIT_ASSERT(limited.status() == ByteStream::Status::ReadCorruptData);
+    CPPUNIT_ASSERT(text == "key");
+}
+
+/*!
+    \brief Tests that every way of reading a bool reads any byte other than 0
+    as true
+*/
+void ByteStreamTestSuite::test_bools() {
+    const char bytes[] = {2, 0, 0x7F, 3, 0, 5};
+
+    ByteStream reader{ByteView(bytes, sizeof(bytes))};
+    bool first = false;
+    bool second = true;
+    reader >> first;
+    reader >> second;
+    CPPUNIT_ASSERT(first && boolByte(first) == 1);
+    CPPUNIT_ASSERT(!second);
+    {
+        ByteStream::ReadBatch batch(reader, 1);
+        const bool batched = batch.get<bool>();
+        CPPUNIT_ASSERT(batched && boolByte(batched) == 1);
+    }
+    bool values[3];
+    reader.readArray(values, 3);
+    CPPUNIT_ASSERT(boolByte(values[0]) == 1 && !values[1] && boolByte(values[2]) == 1);
+
+    BigEndianByteStream fixed{ByteView(bytes, sizeof(bytes))};
+    fixed >> first;
+    CPPUNIT_ASSERT(first && boolByte(first) == 1);
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+}
 
 MAINLESS_TEST(ByteStreamTestSuite)
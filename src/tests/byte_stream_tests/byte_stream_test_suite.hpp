@@ -1,12 +1,51 @@
+/*!
+    \file byte_stream_test_suite.hpp
+    \brief File to define the ByteStreamTestSuite class
+*/
+
 #ifndef BYTE_STREAM_TEST_SUITE_HPP
 #define BYTE_STREAM_TEST_SUITE_HPP
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "byte_stream.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the ByteStream class
+*/
 class ByteStreamTestSuite : public CppUnit::TestFixture {
     CPPUNIT_TEST_SUITE(ByteStreamTestSuite);
 
+    CPPUNIT_TEST(test_readWrite);
+    CPPUNIT_TEST(test_appendMode);
+    CPPUNIT_TEST(test_arrayGrownOutside);
+    CPPUNIT_TEST(test_viewDevice);
+    CPPUNIT_TEST(test_byteOrder);
+    CPPUNIT_TEST(test_fixedByteOrder);
+    CPPUNIT_TEST(test_arrays);
+    CPPUNIT_TEST(test_batches);
+    CPPUNIT_TEST(test_strings);
+    CPPUNIT_TEST(test_bools);
+
     CPPUNIT_TEST_SUITE_END();
+
+public:
+    ByteStreamTestSuite();
+    ~ByteStreamTestSuite() = default;
+
+private:
+    void test_readWrite();
+    void test_appendMode();
+    void test_arrayGrownOutside();
+    void test_viewDevice();
+    void test_byteOrder();
+    void test_fixedByteOrder();
+    void test_arrays();
+    void test_batches();
+    void test_strings();
+    void test_bools();
 };
 
 #endif
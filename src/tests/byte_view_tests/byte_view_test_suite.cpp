@@ -0,0 +1,71 @@
+/*!
+    \file byte_view_test_suite.cpp
+    \brief File to define the implementation of the ByteViewTestSuite
+*/
+
+#include "byte_view_test_suite.hpp"
+#include "byte_array.hpp"
+#include "common.hpp"
+
+/*!
+    \brief Default constructor for the Byte View unit test class
+*/
+ByteViewTestSuite::ByteViewTestSuite() = default;
+
+/*!
+    \brief Tests that a default constructed view is empty
+*/
+void ByteViewTestSuite::test_defaultConstructor() {
+    ByteView view;
+
+    CPPUNIT_ASSERT(view.empty());
+    CPPUNIT_ASSERT(view.size() == 0);
+    CPPUNIT_ASSERT(view.begin() == view.end());
+}
+
+/*!
+    \brief Tests that a view of an array refers to the storage of the array
+*/
+void ByteViewTestSuite::test_arrayConstructor() {
+    ByteArray array("1234", 4);
+    ByteView view(array);
+
+    CPPUNIT_ASSERT(view.data() == array.constData());
+    CPPUNIT_ASSERT(view.size() == 4);
+    CPPUNIT_ASSERT(view[3] == '4');
+
+    ByteArray copy = view.toByteArray();
+    CPPUNIT_ASSERT(copy.size() == 4);
+    CPPUNIT_ASSERT(copy.constData() != array.constData());
+}
+
+/*!
+    \brief Tests that slices refer to the right bytes and are clamped
+*/
+void ByteViewTestSuite::test_slice() {
+    const char* data = "abcdef";
+    ByteView view(data, 6);
+
+    CPPUNIT_ASSERT(view.slice(2).data() == data + 2);
+    CPPUNIT_ASSERT(view.slice(2).size() == 4);
+    CPPUNIT_ASSERT(view.slice(1, 2) == ByteView("bc", 2));
+    CPPUNIT_ASSERT(view.slice(4, 10).size() == 2);
+    CPPUNIT_ASSERT(view.slice(10).empty());
+    CPPUNIT_ASSERT(view.startsWith(ByteView("abc", 3)));
+    CPPUNIT_ASSERT(!view.startsWith(ByteView("abd", 3)));
+}
+
+/*!
+    \brief Tests equality and ordering of views
+*/
+void ByteViewTestSuite::test_compare() {
+    CPPUNIT_ASSERT(ByteView("abc", 3) == ByteView("abc", 3));
+    CPPUNIT_ASSERT(ByteView("abc", 3) != ByteView("abd", 3));
+    CPPUNIT_ASSERT(ByteView("abc", 3) < ByteView("abd", 3));
+    CPPUNIT_ASSERT(ByteView("ab", 2) < ByteView("abc", 3));
+    CPPUNIT_ASSERT(ByteView("a\x01", 2) < ByteView("a\xff", 2));
+    CPPUNIT_ASSERT(!(ByteView() < ByteView()));
+    CPPUNIT_ASSERT(ByteView() == ByteView("", 0));
+}
+
+MAINLESS_TEST(ByteViewTestSuite)
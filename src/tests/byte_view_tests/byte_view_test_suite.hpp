@@ -0,0 +1,39 @@
+/*!
+    \file byte_view_test_suite.hpp
+    \brief File to define the ByteViewTestSuite class
+*/
+
+#ifndef BYTE_VIEW_TEST_SUITE_HPP
+#define BYTE_VIEW_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "byte_view.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the ByteView class
+*/
+class ByteViewTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ByteViewTestSuite);
+
+    CPPUNIT_TEST(test_defaultConstructor);
+    CPPUNIT_TEST(test_arrayConstructor);
+    CPPUNIT_TEST(test_slice);
+    CPPUNIT_TEST(test_compare);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    ByteViewTestSuite();
+    ~ByteViewTestSuite() = default;
+
+private:
+    void test_defaultConstructor();
+    void test_arrayConstructor();
+    void test_slice();
+    void test_compare();
+};
+
+#endif
@@ -0,0 +1,199 @@
+/*!
+    \file checksum_test_suite.cpp
+    \brief File to define the implementation of the ChecksumTestSuite
+*/
+
+#include "checksum_test_suite.hpp"
+#include "byte_array.hpp"
+#include "byte_stream.hpp"
+#include "io_device.hpp"
+#include "common.hpp"
+
+#include <cstdio>
+#include <string>
+
+namespace {
+const char* TestFile = "checksum_test.bin";
+
+/*!
+    \brief Writes a few values of every kind, in a checksum section
+*/
+void writeRecord(ByteStream &stream, uint32_t i) {
+    stream.beginChecksum();
+    stream << i;
+    stream << std::string(i % 50, 'r');
+    stream << static_cast<double>(i) / 3;
+    stream.writeChecksum();
+}
+
+/*!
+    \brief Reads a record written by writeRecord()
+*/
+bool readRecord(ByteStream &stream, uint32_t i) {
+    uint32_t value = 0;
+    std::string text;
+    double real = 0;
+    stream.beginChecksum();
+    stream >> value;
+    stream >> text;
+    stream >> real;
+    return stream.verifyChecksum() && value == i && text.size() == i % 50;
+}
+}
+
+/*!
+    \brief Default constructor for the Checksum unit test class
+*/
+ChecksumTestSuite::ChecksumTestSuite() = default;
+
+/*!
+    \brief Tests against the known values of CRC32C
+*/
+void ChecksumTestSuite::test_crc32c() {
+    CPPUNIT_ASSERT(crc32c(ByteView()) == 0);
+    CPPUNIT_ASSERT(crc32c("123456789", 9) == 0xE3069283u);
+    const ByteArray zeros(32, '\0');
+    const ByteArray ones(32, '\xFF');
+    CPPUNIT_ASSERT(crc32c(ByteView(zeros)) == 0x8A9136AAu);
+    CPPUNIT_ASSERT(crc32c(ByteView(ones)) == 0x62A8AB43u);
+
+    // Checksumming in pieces gives the same result as all at once
+    const char* text = "The quick brown fox jumps over the lazy dog";
+    const std::size_t size = std::strlen(text);
+    const uint32_t whole = crc32c(text, size);
+    for(std::size_t split = 0; split <= size; split++) {
+        CPPUNIT_ASSERT(crc32c(text + split, size - split, crc32c(text, split)) == whole);
+    }
+}
+
+/*!
+    \brief Tests that the hardware and software implementations agree
+*/
+void ChecksumTestSuite::test_implementations() {
+    ByteArray data;
+    uint32_t seed = 1;
+    for(int i = 0; i < 100000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data.append(1, static_cast<char>(seed >> 16));
+    }
+
+    // Every alignment and every tail length
+    for(int offset = 0; offset < 9; offset++) {
+        for(int size = 0; size < 80; size++) {
+            const char* start = data.begin() + offset;
+            CPPUNIT_ASSERT(crc32c(start, size) == crc32cSoftware(start, size));
+        }
+    }
+    CPPUNIT_ASSERT(crc32c(ByteView(data)) == crc32cSoftware(data.begin(), data.size()));
+    for(int size = 700; size < data.size(); size = size * 3 + 5) {
+        CPPUNIT_ASSERT(crc32c(data.begin() + 3, size, 0x1234) ==
+                       crc32cSoftware(data.begin() + 3, size, 0x1234));
+    }
+}
+
+/*!
+    \brief Tests checksum trailers on streams over arrays
+*/
+void ChecksumTestSuite::test_arrayTrailers() {
+    ByteArray array;
+    {
+        ByteStream stream(&array, ByteStream::OpenMode::Append);
+        stream << static_cast<uint32_t>(0xABCD);
+        stream.beginChecksum();
+        stream << std::string("payload");
+        stream.writeChecksum();
+        CPPUNIT_ASSERT(stream.status() == ByteStream::Status::Ok);
+    }
+    CPPUNIT_ASSERT(array.size() == 4 + 8 + 4);
+
+    // The trailer is the little endian checksum of the covered bytes
+    const uint32_t expected = crc32c(array.begin() + 4, 8);
+    CPPUNIT_ASSERT(static_cast<uint8_t>(array[12]) == (expected & 0xFF));
+    CPPUNIT_ASSERT(static_cast<uint8_t>(array[15]) == (expected >> 24));
+
+    ByteStream reader{ByteView(array)};
+    uint32_t header = 0;
+    std::string payload;
+    reader >> header;
+    reader.beginChecksum();
+    reader >> payload;
+    CPPUNIT_ASSERT(reader.verifyChecksum());
+    CPPUNIT_ASSERT(payload == "payload" && reader.atEnd());
+
+    // A flipped bit anywhere in the section is caught
+    for(int i = 4; i < array.size(); i++) {
+        ByteArray corrupt(array);
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0x10);
+        ByteStream stream{ByteView(corrupt)};
+        stream >> header;
+        stream.beginChecksum();
+        stream.skipRawData(8);
+        CPPUNIT_ASSERT(!stream.verifyChecksum());
+        CPPUNIT_ASSERT(stream.status() == ByteStream::Status::ReadCorruptData);
+    }
+
+    // A missing trailer is a read past the end
+    ByteStream truncated(ByteView(array).slice(0, 14));
+    truncated.skipRawData(4);
+    truncated.beginChecksum();
+    truncated.skipRawData(8);
+    CPPUNIT_ASSERT(!truncated.verifyChecksum());
+    CPPUNIT_ASSERT(truncated.status() == ByteStream::Status::ReadWritePastEnd);
+}
+
+/*!
+    \brief Tests checksum trailers on buffered streams, across refills, flushes
+    and writes which bypass the buffer
+*/
+void ChecksumTestSuite::test_deviceTrailers() {
+    const std::string large(5000, 'L');
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        ByteStream writer(&file, ByteStream::OpenMode::WriteOnly, 64);
+        for(uint32_t i = 0; i < 300; i++) {
+            writeRecord(writer, i);
+        }
+        writer.beginChecksum();
+        writer << large;
+        writer << static_cast<uint8_t>(7);
+        writer.writeChecksum();
+        CPPUNIT_ASSERT(writer.flush());
+    }
+
+    ByteArray contents;
+    {
+        FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+        ByteStream reader(&file, ByteStream::OpenMode::ReadOnly, 48);
+        for(uint32_t i = 0; i < 300; i++) {
+            CPPUNIT_ASSERT(readRecord(reader, i));
+        }
+        std::string text;
+        uint8_t last = 0;
+        reader.beginChecksum();
+        reader >> text;
+        reader >> last;
+        CPPUNIT_ASSERT(reader.verifyChecksum());
+        CPPUNIT_ASSERT(text == large && last == 7 && reader.atEnd());
+    }
+
+    // The same bytes read from memory verify too, and a corrupt record fails
+    {
+        FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+        char buffer[4096];
+        int64_t read;
+        while((read = file.read(buffer, sizeof(buffer))) > 0) {
+            contents.append(buffer, static_cast<int>(read));
+        }
+    }
+    contents[1000] = static_cast<char>(contents[1000] ^ 1);
+    ByteStream reader{ByteView(contents)};
+    bool failed = false;
+    for(uint32_t i = 0; i < 300 && !failed; i++) {
+        failed = !readRecord(reader, i);
+    }
+    CPPUNIT_ASSERT(failed && reader.status() == ByteStream::Status::ReadCorruptData);
+
+    std::remove(TestFile);
+}
+
+MAINLESS_TEST(ChecksumTestSuite)
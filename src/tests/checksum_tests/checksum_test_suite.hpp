@@ -0,0 +1,40 @@
+/*!
+    \file checksum_test_suite.hpp
+    \brief File to define the ChecksumTestSuite class
+*/
+
+#ifndef CHECKSUM_TEST_SUITE_HPP
+#define CHECKSUM_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "checksum.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the CRC32C functions
+    and the checksum trailers of ByteStream
+*/
+class ChecksumTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ChecksumTestSuite);
+
+    CPPUNIT_TEST(test_crc32c);
+    CPPUNIT_TEST(test_implementations);
+    CPPUNIT_TEST(test_arrayTrailers);
+    CPPUNIT_TEST(test_deviceTrailers);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    ChecksumTestSuite();
+    ~ChecksumTestSuite() = default;
+
+private:
+    void test_crc32c();
+    void test_implementations();
+    void test_arrayTrailers();
+    void test_deviceTrailers();
+};
+
+#endif
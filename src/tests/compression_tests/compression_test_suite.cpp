@@ -0,0 +1,209 @@
+/*!
+    \file compression_test_suite.cpp
+    \brief File to define the implementation of the CompressionTestSuite
+*/
+
+#include "compression_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+
+namespace {
+const char* TestFile = "compression_test.lz";
+
+/*!
+    \brief Returns data which compresses well, like a snapshot of records
+*/
+ByteArray records(int count) {
+    ByteArray array;
+    ByteStream stream(&array, ByteStream::OpenMode::Append);
+    for(int i = 0; i < count; i++) {
+        stream << static_cast<uint32_t>(i);
+        stream << std::string("status=ok;region=eu-west");
+        stream << static_cast<double>(i % 7);
+    }
+    return array;
+}
+
+/*!
+    \brief Returns data which doesn't compress
+*/
+ByteArray noise(int size) {
+    std::mt19937 generator(42);
+    ByteArray array;
+    for(int i = 0; i < size; i++) {
+        array.append(1, static_cast<char>(generator()));
+    }
+    return array;
+}
+
+/*!
+    \brief Device which reads from memory and remembers the largest read asked
+    for, which a reader allocates for
+*/
+class MemoryReader : public IODevice {
+public:
+    explicit MemoryReader(const ByteView &data) : mData(data), mLargestRead(0) {}
+
+    int64_t read(char *data, uint64_t maxSize) override {
+        mLargestRead = std::max(mLargestRead, maxSize);
+        const std::size_t count = static_cast<std::size_t>(std::min<uint64_t>(maxSize, mData.size()));
+        std::memcpy(data, mData.data(), count);
+        mData = mData.slice(count);
+        return static_cast<int64_t>(count);
+    }
+
+    int64_t write(const char*, uint64_t) override {
+        return -1;
+    }
+
+    uint64_t largestRead() const {
+        return mLargestRead;
+    }
+
+private:
+    ByteView mData; //!< the bytes not read yet
+    uint64_t mLargestRead; //!< the largest maxSize passed to read()
+};
+
+/*!
+    \brief Compresses and decompresses one block, returning the compressed size
+*/
+int roundTrip(const ByteArray& data) {
+    ByteArray compressed(compressedBound(data.size()), '\0');
+    const int size = compressBlock(data.begin(), data.size(), compressed.begin(), compressed.size());
+    CPPUNIT_ASSERT(size > 0 && size <= compressedBound(data.size()));
+
+    ByteArray decompressed(data.size(), '\0');
+    CPPUNIT_ASSERT(decompressBlock(compressed.begin(), size, decompressed.begin(),
+                                   decompressed.size()) == data.size());
+    CPPUNIT_ASSERT(ByteView(decompressed) == ByteView(data));
+    return size;
+}
+}
+
+/*!
+    \brief Default constructor for the Compression unit test class
+*/
+CompressionTestSuite::CompressionTestSuite() = default;
+
+/*!
+    \brief Tests single blocks of all kinds of data
+*/
+void CompressionTestSuite::test_blocks() {
+    CPPUNIT_ASSERT(roundTrip(ByteArray()) == 1);
+    roundTrip(ByteArray("short"));
+    roundTrip(ByteArray("aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaa"));
+
+    const ByteArray snapshot = records(2000);
+    CPPUNIT_ASSERT(roundTrip(snapshot) * 4 < snapshot.size());
+
+    // A run longer than a length byte, and overlapping matches
+    CPPUNIT_ASSERT(roundTrip(ByteArray(100000, 'z')) < 500);
+    roundTrip(noise(70000));
+
+    // Too small a destination fails rather than overflowing
+    ByteArray small(8, '\0');
+    CPPUNIT_ASSERT(compressBlock(snapshot.begin(), snapshot.size(), small.begin(), small.size()) == 0);
+}
+
+/*!
+    \brief Tests frames of several blocks, that blocks are independent, and
+    that the block size is limited
+*/
+void CompressionTestSuite::test_frames() {
+    const ByteArray snapshot = records(20000);
+    const ByteArray compressed = compress(ByteView(snapshot));
+    CPPUNIT_ASSERT(compressed.size() * 4 < snapshot.size());
+
+    ByteArray decompressed;
+    CPPUNIT_ASSERT(decompress(ByteView(compressed), decompressed));
+    CPPUNIT_ASSERT(ByteView(decompressed) == ByteView(snapshot));
+
+    // Incompressible blocks are stored as they are
+    const ByteArray random = noise(10000);
+    const ByteArray stored = compress(ByteView(random), 4096);
+    CPPUNIT_ASSERT(stored.size() == random.size() + 3 * 8);
+    CPPUNIT_ASSERT(decompress(ByteView(stored), decompressed));
+    CPPUNIT_ASSERT(ByteView(decompressed) == ByteView(random));
+
+    CPPUNIT_ASSERT(compress(ByteView()).empty());
+    CPPUNIT_ASSERT(decompress(ByteView(), decompressed) && decompressed.empty());
+
+    // Blocks larger than readers accept are split at the largest size
+    const ByteArray large(MaxCompressionBlockSize + 100, 'z');
+    const ByteArray clamped = compress(ByteView(large), std::numeric_limits<int>::max());
+    CPPUNIT_ASSERT(decompress(ByteView(clamped), decompressed));
+    CPPUNIT_ASSERT(ByteView(decompressed) == ByteView(large));
+}
+
+/*!
+    \brief Tests that corrupt frames fail instead of misbehaving
+*/
+void CompressionTestSuite::test_corrupt() {
+    const ByteArray snapshot = records(1000);
+    const ByteArray compressed = compress(ByteView(snapshot));
+    ByteArray decompressed;
+
+    CPPUNIT_ASSERT(!decompress(ByteView(compressed).slice(0, compressed.size() - 1), decompressed));
+    CPPUNIT_ASSERT(!decompress(ByteView(compressed).slice(0, 5), decompressed));
+
+    // Flip bytes all through the frame, none may crash
+    for(int i = 0; i < compressed.size(); i += 7) {
+        ByteArray corrupt(compressed);
+        corrupt[i] = static_cast<char>(corrupt[i] ^ 0x5A);
+        decompress(ByteView(corrupt), decompressed);
+    }
+
+    const char badOffset[] = {0x10, 'a', 0x09, 0x00};
+    char out[64];
+    CPPUNIT_ASSERT(decompressBlock(badOffset, 4, out, sizeof(out)) == -1);
+
+    // A compressed payload far larger than its block is rejected before the
+    // device allocates for it
+    const char hugePayload[] = {'\xFF', '\xFF', '\xFF', 0x7F, 1, 0, 0, 0, 'x'};
+    CPPUNIT_ASSERT(!decompress(ByteView(hugePayload, sizeof(hugePayload)), decompressed));
+    MemoryReader source{ByteView(hugePayload, sizeof(hugePayload))};
+    DecompressingDevice decompressor(&source);
+    CPPUNIT_ASSERT(decompressor.read(out, sizeof(out)) == -1);
+    CPPUNIT_ASSERT(source.largestRead() <= 8);
+}
+
+/*!
+    \brief Tests compressing and decompressing through ByteStreams
+*/
+void CompressionTestSuite::test_devices() {
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        CompressingDevice compressor(&file, 8192);
+        ByteStream writer(&compressor, ByteStream::OpenMode::WriteOnly, 1000);
+        for(uint32_t i = 0; i < 50000; i++) {
+            writer << i % 100;
+            writer << std::string("tag");
+        }
+        CPPUNIT_ASSERT(writer.flush());
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    DecompressingDevice decompressor(&file);
+    ByteStream reader(&decompressor, ByteStream::OpenMode::ReadOnly, 777);
+    for(uint32_t i = 0; i < 50000; i++) {
+        uint32_t value = 0;
+        std::string tag;
+        reader >> value;
+        reader >> tag;
+        CPPUNIT_ASSERT(value == i % 100 && tag == "tag");
+    }
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(reader.atEnd());
+
+    std::remove(TestFile);
+}
+
+MAINLESS_TEST(CompressionTestSuite)
@@ -0,0 +1,40 @@
+/*!
+    \file compression_test_suite.hpp
+    \brief File to define the CompressionTestSuite class
+*/
+
+#ifndef COMPRESSION_TEST_SUITE_HPP
+#define COMPRESSION_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "compression.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the block compression
+    functions and devices
+*/
+class CompressionTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(CompressionTestSuite);
+
+    CPPUNIT_TEST(test_blocks);
+    CPPUNIT_TEST(test_frames);
+    CPPUNIT_TEST(test_corrupt);
+    CPPUNIT_TEST(test_devices);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    CompressionTestSuite();
+    ~CompressionTestSuite() = default;
+
+private:
+    void test_blocks();
+    void test_frames();
+    void test_corrupt();
+    void test_devices();
+};
+
+#endif
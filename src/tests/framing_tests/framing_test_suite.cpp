@@ -0,0 +1,177 @@
+/*!
+    \file framing_test_suite.cpp
+    \brief File to define the implementation of the FramingTestSuite
+*/
+
+#include "framing_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <string>
+#include <vector>
+
+namespace {
+/*!
+    \brief Returns frames of many sizes, including empty ones and ones with
+    multi byte lengths
+*/
+std::vector<std::string> payloads() {
+    std::vector<std::string> result;
+    for(int i = 0; i < 40; i++) {
+        result.push_back(std::string(static_cast<std::size_t>(i * i * 7 % 500), static_cast<char>('a' + i % 26)));
+    }
+    result.push_back(std::string());
+    result.push_back(std::string(20000, 'x'));
+    return result;
+}
+
+ByteArray encode(const std::vector<std::string> &frames) {
+    ByteArray stream;
+    for(const std::string& frame : frames) {
+        appendFrame(stream, frame.data(), frame.size());
+    }
+    return stream;
+}
+
+/*!
+    \brief Feeds stream to a decoder in chunks of the given sizes, in a
+    reused buffer, and returns the frames decoded
+*/
+std::vector<std::string> decode(FrameDecoder &decoder, const ByteArray &stream,
+                                const std::vector<std::size_t> &sizes) {
+    std::vector<std::string> frames;
+    std::vector<char> buffer;
+    std::size_t offset = 0;
+    std::size_t i = 0;
+    while(offset < static_cast<std::size_t>(stream.size())) {
+        const std::size_t size = std::min(sizes[i++ % sizes.size()], stream.size() - offset);
+        buffer.assign(stream.begin() + offset, stream.begin() + offset + size);
+        offset += size;
+
+        decoder.feed(buffer.data(), buffer.size());
+        ByteView frame;
+        FrameDecoder::Status status;
+        while((status = decoder.next(frame)) == FrameDecoder::Status::FrameReady) {
+            frames.push_back(std::string(frame.data(), frame.size()));
+        }
+        CPPUNIT_ASSERT(status == FrameDecoder::Status::NeedMoreData);
+        // The buffer is overwritten before the next chunk
+        std::fill(buffer.begin(), buffer.end(), '#');
+    }
+    return frames;
+}
+}
+
+/*!
+    \brief Default constructor for the Framing unit test class
+*/
+FramingTestSuite::FramingTestSuite() = default;
+
+/*!
+    \brief Tests that frames inside a chunk are returned without copying
+*/
+void FramingTestSuite::test_wholeChunks() {
+    ByteArray stream;
+    ByteArray payload;
+    {
+        ByteStream writer(&payload, ByteStream::OpenMode::Append);
+        writer << static_cast<uint32_t>(77);
+        writer << std::string("hello");
+    }
+    const ByteArray padding(300, 'p');
+    appendFrame(stream, ByteView(payload));
+    appendFrame(stream, ByteView());
+    appendFrame(stream, ByteView(padding));
+    CPPUNIT_ASSERT(stream.size() == 1 + payload.size() + 1 + 2 + 300);
+
+    FrameDecoder decoder;
+    ByteView frame;
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::NeedMoreData);
+    decoder.feed(ByteView(stream));
+
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::FrameReady);
+    CPPUNIT_ASSERT(frame.data() == stream.begin() + 1);
+    ByteStream reader(frame);
+    uint32_t number = 0;
+    std::string text;
+    reader >> number;
+    reader >> text;
+    CPPUNIT_ASSERT(number == 77 && text == "hello" && reader.atEnd());
+
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::FrameReady);
+    CPPUNIT_ASSERT(frame.empty());
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::FrameReady);
+    CPPUNIT_ASSERT(frame == ByteView(padding));
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::NeedMoreData);
+    CPPUNIT_ASSERT(decoder.buffered() == 0);
+}
+
+/*!
+    \brief Tests frames and lengths split across chunks of every size
+*/
+void FramingTestSuite::test_splitChunks() {
+    const std::vector<std::string> frames = payloads();
+    const ByteArray stream = encode(frames);
+
+    const std::vector<std::vector<std::size_t>> patterns = {
+        {1}, {2}, {3}, {7, 1, 1}, {64}, {1000}, {4096, 3}, {100000}
+    };
+    for(const std::vector<std::size_t>& sizes : patterns) {
+        FrameDecoder decoder;
+        CPPUNIT_ASSERT(decode(decoder, stream, sizes) == frames);
+        CPPUNIT_ASSERT(decoder.buffered() == 0);
+    }
+
+    // A partial length and then a partial payload are held until the rest
+    const ByteArray payload(20000, 'x');
+    ByteArray large;
+    appendFrame(large, ByteView(payload));
+    FrameDecoder decoder;
+    ByteView frame;
+    decoder.feed(large.begin(), 2);
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::NeedMoreData);
+    CPPUNIT_ASSERT(decoder.buffered() == 2);
+    decoder.feed(large.begin() + 2, 4);
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::NeedMoreData);
+    CPPUNIT_ASSERT(decoder.buffered() == 3);
+    decoder.feed(large.begin() + 6, large.size() - 6);
+    CPPUNIT_ASSERT(decoder.next(frame) == FrameDecoder::Status::FrameReady);
+    CPPUNIT_ASSERT(frame == ByteView(payload));
+}
+
+/*!
+    \brief Tests that bad lengths are reported and stick until reset()
+*/
+void FramingTestSuite::test_corrupt() {
+    const ByteArray tooLong(200, 'b');
+    ByteArray stream;
+    appendFrame(stream, ByteView(tooLong));
+
+    FrameDecoder limited(100);
+    ByteView frame;
+    limited.feed(ByteView(stream));
+    CPPUNIT_ASSERT(limited.next(frame) == FrameDecoder::Status::Corrupt);
+    CPPUNIT_ASSERT(limited.isCorrupt());
+    limited.feed(ByteView(stream));
+    CPPUNIT_ASSERT(limited.next(frame) == FrameDecoder::Status::Corrupt);
+
+    limited.reset();
+    const ByteArray fits(100, 's');
+    ByteArray small;
+    appendFrame(small, ByteView(fits));
+    limited.feed(ByteView(small));
+    CPPUNIT_ASSERT(limited.next(frame) == FrameDecoder::Status::FrameReady);
+    CPPUNIT_ASSERT(frame.size() == 100);
+
+    // An overlong varint, fed a byte at a time
+    FrameDecoder decoder;
+    const ByteArray overlong(11, '\x80');
+    for(int i = 0; i < overlong.size(); i++) {
+        decoder.feed(overlong.begin() + i, 1);
+        const FrameDecoder::Status status = decoder.next(frame);
+        CPPUNIT_ASSERT(status == (i < MaxVarintLength - 1 ? FrameDecoder::Status::NeedMoreData
+                                                          : FrameDecoder::Status::Corrupt));
+    }
+}
+
+MAINLESS_TEST(FramingTestSuite)
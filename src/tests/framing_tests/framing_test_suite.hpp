@@ -0,0 +1,38 @@
+/*!
+    \file framing_test_suite.hpp
+    \brief File to define the FramingTestSuite class
+*/
+
+#ifndef FRAMING_TEST_SUITE_HPP
+#define FRAMING_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "framing.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for appendFrame() and the
+    FrameDecoder class
+*/
+class FramingTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(FramingTestSuite);
+
+    CPPUNIT_TEST(test_wholeChunks);
+    CPPUNIT_TEST(test_splitChunks);
+    CPPUNIT_TEST(test_corrupt);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    FramingTestSuite();
+    ~FramingTestSuite() = default;
+
+private:
+    void test_wholeChunks();
+    void test_splitChunks();
+    void test_corrupt();
+};
+
+#endif
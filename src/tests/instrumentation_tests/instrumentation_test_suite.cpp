@@ -0,0 +1,243 @@
+/*!
+    \file instrumentation_test_suite.cpp
+    \brief File to define the implementation of the InstrumentationTestSuite
+*/
+
+#include "instrumentation_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/*!
+    \brief Returns what a counter should read, 0 without instrumentation
+*/
+uint64_t counted(uint64_t expected) {
+    return InstrumentationEnabled ? expected : 0;
+}
+
+uint64_t writes(const StreamCounters &counters, StreamOperation operation) {
+    return counters.operations(operation, StreamDirection::Write);
+}
+
+uint64_t reads(const StreamCounters &counters, StreamOperation operation) {
+    return counters.operations(operation, StreamDirection::Read);
+}
+
+/*!
+    \brief Writes 1000 uint32_t values to a stream of its own
+*/
+void writeValues() {
+    ByteArray array;
+    ByteStream stream(&array, ByteStream::OpenMode::Append);
+    for(uint32_t i = 0; i < 1000; i++) {
+        stream << i;
+    }
+}
+}
+
+InstrumentationTestSuite::InstrumentationTestSuite() = default;
+
+/*!
+    \brief Tests that a stream counts its bytes and each kind of operation
+    once, and that the global counters add up the same
+*/
+void InstrumentationTestSuite::test_streamCounters() {
+    const GlobalCounters before = globalCounters();
+
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer << static_cast<uint8_t>(1);
+    writer << static_cast<int32_t>(-5);
+    writer << true;
+    writer << 2.5;
+    writer << std::string("hello");
+    writer.writeVarint(300);
+    writer.writeRawData("abc", 3);
+    writer.writeArray(std::vector<uint16_t>{1, 2, 3});
+    {
+        ByteStream::WriteBatch batch(writer, 4);
+        batch.put(static_cast<uint32_t>(7));
+    }
+    writer.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    writer << static_cast<uint32_t>(5);
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::Ok);
+
+    const StreamCounters written = writer.counters();
+    CPPUNIT_ASSERT(array.size() == 36);
+    CPPUNIT_ASSERT(written.bytesWritten == counted(36));
+    CPPUNIT_ASSERT(written.bytesRead == 0);
+    // The integers written as varints count as integers, and the string's length isn't a Varint
+    CPPUNIT_ASSERT(writes(written, StreamOperation::Integer) == counted(3));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::Boolean) == counted(1));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::FloatingPoint) == counted(1));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::String) == counted(1));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::Varint) == counted(1));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::RawData) == counted(1));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::Array) == counted(1));
+    CPPUNIT_ASSERT(writes(written, StreamOperation::Batch) == counted(1));
+    CPPUNIT_ASSERT(reads(written, StreamOperation::Integer) == 0);
+
+    ByteStream reader(ByteView(array.begin(), static_cast<std::size_t>(array.size())));
+    uint8_t u8 = 0;
+    int32_t i32 = 0;
+    bool b = false;
+    double d = 0;
+    std::string s;
+    uint64_t varint = 0;
+    char raw[3];
+    std::vector<uint16_t> values;
+    uint32_t u32 = 0;
+    reader >> u8;
+    reader >> i32;
+    reader >> b;
+    reader >> d;
+    reader >> s;
+    reader.readVarint(varint);
+    reader.readRawData(raw, 3);
+    reader.readArray(values, 3);
+    {
+        ByteStream::ReadBatch batch(reader, 4);
+        CPPUNIT_ASSERT(batch.get<uint32_t>() == 7);
+    }
+    reader.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    reader >> u32;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(s == "hello" && varint == 300 && u32 == 5);
+
+    const StreamCounters read = reader.counters();
+    CPPUNIT_ASSERT(read.bytesRead == counted(36));
+    CPPUNIT_ASSERT(read.bytesWritten == 0);
+    CPPUNIT_ASSERT(reads(read, StreamOperation::Integer) == counted(3));
+    CPPUNIT_ASSERT(reads(read, StreamOperation::String) == counted(1));
+    CPPUNIT_ASSERT(reads(read, StreamOperation::Varint) == counted(1));
+    CPPUNIT_ASSERT(reads(read, StreamOperation::Batch) == counted(1));
+    CPPUNIT_ASSERT(read.boundsFailures == 0);
+
+    const GlobalCounters after = globalCounters();
+    CPPUNIT_ASSERT(after.streams.bytesWritten - before.streams.bytesWritten == counted(36));
+    CPPUNIT_ASSERT(after.streams.bytesRead - before.streams.bytesRead == counted(36));
+    for(int i = 0; i < StreamOperationCount; i++) {
+        CPPUNIT_ASSERT(after.streams.writes[i] - before.streams.writes[i] == written.writes[i]);
+        CPPUNIT_ASSERT(after.streams.reads[i] - before.streams.reads[i] == read.reads[i]);
+    }
+
+    // Resetting a stream leaves the global counters alone
+    writer.resetCounters();
+    CPPUNIT_ASSERT(writer.counters().bytesWritten == 0);
+    CPPUNIT_ASSERT(globalCounters().streams.bytesWritten == after.streams.bytesWritten);
+}
+
+/*!
+    \brief Tests that running past the end counts once per failure, not once
+    per operation on the failed stream
+*/
+void InstrumentationTestSuite::test_boundsFailures() {
+    const GlobalCounters before = globalCounters();
+
+    const ByteArray small(2, 'x');
+    ByteStream reader(ByteView(small.begin(), 2));
+    uint32_t value = 0;
+    reader >> value;
+    reader >> value;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(reader.counters().boundsFailures == counted(1));
+
+    reader.resetStatus();
+    CPPUNIT_ASSERT(reader.skipRawData(10) == 0);
+    CPPUNIT_ASSERT(reader.counters().boundsFailures == counted(2));
+    CPPUNIT_ASSERT(reader.counters().bytesRead == 0);
+
+    ByteArray fixed(2, '\0');
+    ByteStream writer(&fixed, ByteStream::OpenMode::WriteOnly);
+    writer << value;
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(writer.counters().boundsFailures == counted(1));
+    CPPUNIT_ASSERT(writer.counters().bytesWritten == 0);
+
+    // A corrupt varint isn't a bounds failure
+    const ByteArray corrupt(11, '\x80');
+    ByteStream varints(ByteView(corrupt.begin(), 11));
+    uint64_t varint;
+    varints.readVarint(varint);
+    CPPUNIT_ASSERT(varints.status() == ByteStream::Status::ReadCorruptData);
+    CPPUNIT_ASSERT(varints.counters().boundsFailures == 0);
+
+    CPPUNIT_ASSERT(globalCounters().streams.boundsFailures - before.streams.boundsFailures == counted(3));
+}
+
+/*!
+    \brief Tests that copying and appending to arrays counts the bytes copied
+    and the reallocations, and that moving counts neither
+*/
+void InstrumentationTestSuite::test_arrayCounters() {
+    const ByteArray source(1000, 'a');
+    const GlobalCounters before = globalCounters();
+
+    ByteArray copy(source);
+    GlobalCounters after = globalCounters();
+    CPPUNIT_ASSERT(after.arrayBytesCopied - before.arrayBytesCopied == counted(1000));
+    CPPUNIT_ASSERT(after.arrayReallocations - before.arrayReallocations == counted(1));
+
+    copy.append(source.begin(), 10);
+    after = globalCounters();
+    CPPUNIT_ASSERT(after.arrayBytesCopied - before.arrayBytesCopied == counted(1010));
+
+    const GlobalCounters beforeMove = globalCounters();
+    ByteArray moved(std::move(copy));
+    after = globalCounters();
+    CPPUNIT_ASSERT(after.arrayBytesCopied == beforeMove.arrayBytesCopied);
+    CPPUNIT_ASSERT(after.arrayReallocations == beforeMove.arrayReallocations);
+
+    // Small arrays never leave their inline storage
+    const GlobalCounters beforeSmall = globalCounters();
+    ByteArray small;
+    small.append("abc", 3);
+    after = globalCounters();
+    CPPUNIT_ASSERT(after.arrayBytesCopied - beforeSmall.arrayBytesCopied == counted(3));
+    CPPUNIT_ASSERT(after.arrayReallocations == beforeSmall.arrayReallocations);
+}
+
+/*!
+    \brief Tests that the global counters include threads while they run and
+    after they exit
+*/
+void InstrumentationTestSuite::test_threads() {
+    const GlobalCounters before = globalCounters();
+
+    std::atomic<bool> written(false);
+    std::atomic<bool> checked(false);
+    std::thread live([&written, &checked]() {
+        writeValues();
+        written = true;
+        while(!checked) {
+            std::this_thread::yield();
+        }
+    });
+    while(!written) {
+        std::this_thread::yield();
+    }
+    GlobalCounters during = globalCounters();
+    CPPUNIT_ASSERT(during.streams.bytesWritten - before.streams.bytesWritten == counted(4000));
+    checked = true;
+    live.join();
+
+    std::vector<std::thread> threads;
+    for(int i = 0; i < 4; i++) {
+        threads.emplace_back(writeValues);
+    }
+    for(std::thread &thread : threads) {
+        thread.join();
+    }
+
+    const GlobalCounters after = globalCounters();
+    CPPUNIT_ASSERT(after.streams.bytesWritten - before.streams.bytesWritten == counted(20000));
+    CPPUNIT_ASSERT(writes(after.streams, StreamOperation::Integer) -
+                   writes(before.streams, StreamOperation::Integer) == counted(5000));
+}
+
+MAINLESS_TEST(InstrumentationTestSuite)
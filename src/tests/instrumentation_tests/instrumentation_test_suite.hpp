@@ -0,0 +1,40 @@
+/*!
+    \file instrumentation_test_suite.hpp
+    \brief File to define the InstrumentationTestSuite class
+*/
+
+#ifndef INSTRUMENTATION_TEST_SUITE_HPP
+#define INSTRUMENTATION_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "instrumentation.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the stream and global
+    counters. They pass with instrumentation on or off, expecting 0 when off.
+*/
+class InstrumentationTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(InstrumentationTestSuite);
+
+    CPPUNIT_TEST(test_streamCounters);
+    CPPUNIT_TEST(test_boundsFailures);
+    CPPUNIT_TEST(test_arrayCounters);
+    CPPUNIT_TEST(test_threads);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    InstrumentationTestSuite();
+    ~InstrumentationTestSuite() = default;
+
+private:
+    void test_streamCounters();
+    void test_boundsFailures();
+    void test_arrayCounters();
+    void test_threads();
+};
+
+#endif
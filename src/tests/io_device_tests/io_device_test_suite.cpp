@@ -0,0 +1,196 @@
+/*!
+    \file io_device_test_suite.cpp
+    \brief File to define the implementation of the IODeviceTestSuite
+*/
+
+#include "io_device_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <cstdio>
+#include <vector>
+
+namespace {
+const char* TestFile = "io_device_test.bin";
+}
+
+/*!
+    \brief Default constructor for the IO Device unit test class
+*/
+IODeviceTestSuite::IODeviceTestSuite() = default;
+
+/*!
+    \brief Tests writing, appending and reading a file directly
+*/
+void IODeviceTestSuite::test_fileDevice() {
+    FileDevice missing;
+    CPPUNIT_ASSERT(!missing.open("this_file_does_not_exist.bin", FileDevice::Mode::ReadOnly));
+    CPPUNIT_ASSERT(!missing.isOpen());
+
+    {
+        FileDevice writer(TestFile, FileDevice::Mode::WriteOnly);
+        CPPUNIT_ASSERT(writer.isOpen());
+        CPPUNIT_ASSERT(writer.write("abc", 3) == 3);
+    }
+    {
+        FileDevice appender(TestFile, FileDevice::Mode::Append);
+        CPPUNIT_ASSERT(appender.write("def", 3) == 3);
+        CPPUNIT_ASSERT(appender.sync());
+    }
+
+    FileDevice reader(TestFile, FileDevice::Mode::ReadOnly);
+    char contents[8] = {0};
+    CPPUNIT_ASSERT(reader.read(contents, sizeof(contents)) == 6);
+    CPPUNIT_ASSERT(ByteView(contents, 6) == ByteView("abcdef", 6));
+    CPPUNIT_ASSERT(reader.read(contents, sizeof(contents)) == 0);
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests values crossing the buffer boundary in both directions
+*/
+void IODeviceTestSuite::test_bufferedStream() {
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        ByteStream writer(&file, ByteStream::OpenMode::WriteOnly, 7);
+        for(uint32_t i = 0; i < 1000; i++) {
+            writer << i;
+            writer << static_cast<uint8_t>(i);
+            writer.writeVarint(i * 300);
+        }
+        writer.writeRawData("done", 4);
+        CPPUNIT_ASSERT(writer.flush());
+        CPPUNIT_ASSERT(writer.status() == ByteStream::Status::Ok);
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    ByteStream reader(&file, ByteStream::OpenMode::ReadOnly, 5);
+    CPPUNIT_ASSERT(reader.ioDevice() == &file);
+    for(uint32_t i = 0; i < 1000; i++) {
+        uint32_t value = 0;
+        uint8_t byte = 0;
+        uint64_t varint = 0;
+        reader >> value;
+        reader >> byte;
+        reader.readVarint(varint);
+        CPPUNIT_ASSERT(value == i && byte == static_cast<uint8_t>(i) && varint == i * 300);
+    }
+    char text[4];
+    CPPUNIT_ASSERT(reader.readRawData(text, 4) == 4);
+    CPPUNIT_ASSERT(ByteView(text, 4) == ByteView("done", 4));
+
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(reader.atEnd());
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests arrays and raw data larger than the buffer
+*/
+void IODeviceTestSuite::test_largeTransfers() {
+    std::vector<uint32_t> values(10000);
+    std::vector<uint64_t> varints(10000);
+    for(uint32_t i = 0; i < values.size(); i++) {
+        values[i] = i * 2654435761u;
+        varints[i] = i % 3 == 0 ? i : static_cast<uint64_t>(i) << 40;
+    }
+    ByteArray raw(100000, 'x');
+
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        ByteStream writer(&file, ByteStream::OpenMode::WriteOnly, 4096);
+        writer.writeArray(values);
+        writer.writeVarints(varints.data(), varints.size());
+        writer.writeRawData(raw.constData(), raw.size());
+        CPPUNIT_ASSERT(writer.status() == ByteStream::Status::Ok);
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    ByteStream reader(&file, ByteStream::OpenMode::ReadOnly, 4096);
+    std::vector<uint32_t> readValues(values.size());
+    std::vector<uint64_t> readVarints(varints.size());
+    ByteArray readRaw(raw.size(), '\0');
+    reader.readArray(readValues, values.size());
+    reader.readVarints(readVarints.data(), readVarints.size());
+    CPPUNIT_ASSERT(reader.readRawData(readRaw.data(), readRaw.size()) == raw.size());
+
+    CPPUNIT_ASSERT(readValues == values);
+    CPPUNIT_ASSERT(readVarints == varints);
+    CPPUNIT_ASSERT(ByteView(readRaw) == ByteView(raw));
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(reader.atEnd());
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests that reading more than the device holds fails, and that a
+    corrupt string length does too
+*/
+void IODeviceTestSuite::test_readPastEnd() {
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        ByteStream writer(&file, ByteStream::OpenMode::WriteOnly);
+        writer << static_cast<uint16_t>(0x0102);
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    ByteStream reader(&file, ByteStream::OpenMode::ReadOnly);
+    uint32_t value = 0;
+    reader >> value;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadWritePastEnd);
+
+    // A corrupt string length fails before the buffer grows to hold it
+    {
+        FileDevice corrupt(TestFile, FileDevice::Mode::WriteOnly);
+        ByteStream writer(&corrupt, ByteStream::OpenMode::WriteOnly);
+        writer.writeVarint(0xFFFFFFFF);
+    }
+    FileDevice corrupt(TestFile, FileDevice::Mode::ReadOnly);
+    ByteStream strings(&corrupt, ByteStream::OpenMode::ReadOnly);
+    std::string text;
+    strings >> text;
+    CPPUNIT_ASSERT(strings.status() == ByteStream::Status::ReadCorruptData);
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests that a ReadWrite stream on a device only writes, and never
+    reads the bytes waiting in its buffer
+*/
+void IODeviceTestSuite::test_readWriteStream() {
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        ByteStream stream(&file, ByteStream::OpenMode::ReadWrite, 16);
+        CPPUNIT_ASSERT(stream.mode() == ByteStream::OpenMode::WriteOnly);
+        CPPUNIT_ASSERT(stream.atEnd());
+
+        stream << static_cast<uint32_t>(0x01020304);
+        char raw[4];
+        CPPUNIT_ASSERT(stream.skipRawData(4) == 0);
+        CPPUNIT_ASSERT(stream.status() == ByteStream::Status::ReadWritePastEnd);
+
+        stream.resetStatus();
+        CPPUNIT_ASSERT(stream.readRawData(raw, 4) == -1);
+        {
+            ByteStream::ReadBatch batch(stream, 4);
+            CPPUNIT_ASSERT(!batch);
+        }
+        CPPUNIT_ASSERT(stream.status() == ByteStream::Status::ReadWritePastEnd);
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    ByteStream reader(&file, ByteStream::OpenMode::ReadOnly);
+    uint32_t value = 0;
+    reader >> value;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(value == 0x01020304);
+    CPPUNIT_ASSERT(reader.atEnd());
+
+    std::remove(TestFile);
+}
+
+MAINLESS_TEST(IODeviceTestSuite)
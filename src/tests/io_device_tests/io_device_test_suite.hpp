@@ -0,0 +1,42 @@
+/*!
+    \file io_device_test_suite.hpp
+    \brief File to define the IODeviceTestSuite class
+*/
+
+#ifndef IO_DEVICE_TEST_SUITE_HPP
+#define IO_DEVICE_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "io_device.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the IODevice classes and
+    ByteStreams set to them
+*/
+class IODeviceTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(IODeviceTestSuite);
+
+    CPPUNIT_TEST(test_fileDevice);
+    CPPUNIT_TEST(test_bufferedStream);
+    CPPUNIT_TEST(test_largeTransfers);
+    CPPUNIT_TEST(test_readPastEnd);
+    CPPUNIT_TEST(test_readWriteStream);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    IODeviceTestSuite();
+    ~IODeviceTestSuite() = default;
+
+private:
+    void test_fileDevice();
+    void test_bufferedStream();
+    void test_largeTransfers();
+    void test_readPastEnd();
+    void test_readWriteStream();
+};
+
+#endif
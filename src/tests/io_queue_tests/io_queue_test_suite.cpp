@@ -0,0 +1,217 @@
+/*!
+    \file io_queue_test_suite.cpp
+    \brief File to define the implementation of the IOQueueTestSuite
+*/
+
+#include "io_queue_test_suite.hpp"
+#include "io_device.hpp"
+#include "common.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <string>
+
+namespace {
+const char* TestFile = "io_queue_test.bin";
+
+/*!
+    \brief Returns the backends to test, io_uring only where it is available
+*/
+std::vector<IOQueue::Backend> backends() {
+    std::vector<IOQueue::Backend> result(1, IOQueue::Backend::ThreadPool);
+    if(IOQueue::ioUringAvailable()) {
+        result.push_back(IOQueue::Backend::IoUring);
+    }
+    return result;
+}
+
+/*!
+    \brief Returns a block of size bytes which depend on its number
+*/
+ByteArray block(int number, int size) {
+    ByteArray array;
+    for(int i = 0; i < size; i++) {
+        array.append(1, static_cast<char>(number * 31 + i));
+    }
+    return array;
+}
+
+/*!
+    \brief Waits for every request in flight, checking each succeeded
+*/
+std::vector<IOQueue::Completion> drain(IOQueue &queue) {
+    std::vector<IOQueue::Completion> completions;
+    while(queue.inFlight() > 0) {
+        queue.wait(completions, queue.inFlight());
+    }
+    return completions;
+}
+}
+
+/*!
+    \brief Default constructor for the IOQueue unit test class
+*/
+IOQueueTestSuite::IOQueueTestSuite() = default;
+
+/*!
+    \brief Tests writing blocks out of order in batches and reading them back
+*/
+void IOQueueTestSuite::test_writeRead() {
+    const int blockSize = 3000;
+    const int blocks = 100;
+    for(IOQueue::Backend backend : backends()) {
+        IOQueue queue(16, backend);
+        CPPUNIT_ASSERT(queue.backend() == backend);
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+
+        // Batches of 16, written back to front
+        for(int first = 0; first < blocks; first += 16) {
+            for(int i = std::min(first + 16, blocks) - 1; i >= first; i--) {
+                CPPUNIT_ASSERT(queue.queueWrite(file.fd(), static_cast<uint64_t>(i) * blockSize,
+                                                block(i, blockSize), static_cast<uint64_t>(i)));
+            }
+            CPPUNIT_ASSERT(queue.submit() == std::min(16, blocks - first));
+            for(const IOQueue::Completion& completion : drain(queue)) {
+                CPPUNIT_ASSERT(completion.operation == IOQueue::Operation::Write);
+                CPPUNIT_ASSERT(completion.result == blockSize);
+                const ByteArray expected = block(static_cast<int>(completion.tag), blockSize);
+                CPPUNIT_ASSERT(ByteView(completion.buffer) == ByteView(expected));
+            }
+        }
+
+        FileDevice input(TestFile, FileDevice::Mode::ReadOnly);
+        for(int i = 0; i < 16; i++) {
+            CPPUNIT_ASSERT(queue.queueRead(input.fd(), static_cast<uint64_t>(i) * 6 * blockSize,
+                                           ByteArray(), blockSize, static_cast<uint64_t>(i * 6)));
+        }
+        queue.submit();
+        std::vector<IOQueue::Completion> completions = drain(queue);
+        CPPUNIT_ASSERT(completions.size() == 16);
+        for(const IOQueue::Completion& completion : completions) {
+            CPPUNIT_ASSERT(completion.operation == IOQueue::Operation::Read);
+            const ByteArray expected = block(static_cast<int>(completion.tag), blockSize);
+            CPPUNIT_ASSERT(ByteView(completion.buffer) == ByteView(expected));
+        }
+
+        // A read past the end is short, with the bytes that were there
+        CPPUNIT_ASSERT(queue.queueRead(input.fd(), (blocks - 1) * blockSize + 1000, ByteArray(), 5000));
+        queue.submit();
+        completions = drain(queue);
+        CPPUNIT_ASSERT(completions[0].result == 2000 && completions[0].buffer.size() == 2000);
+        std::remove(TestFile);
+    }
+}
+
+/*!
+    \brief Tests reusing buffers from registerBuffers() through completions
+*/
+void IOQueueTestSuite::test_registeredBuffers() {
+    for(IOQueue::Backend backend : backends()) {
+        IOQueue queue(8, backend);
+        CPPUNIT_ASSERT(!queue.registerBuffers(4, ByteArray::InlineCapacity));
+        queue.registerBuffers(4, 4096);
+        CPPUNIT_ASSERT(!queue.registerBuffers(4, 4096));
+        CPPUNIT_ASSERT(queue.freeBuffers() == 4);
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+
+        // Keep every buffer busy, recycling each as its write completes
+        uint64_t offset = 0;
+        int written = 0;
+        std::vector<IOQueue::Completion> completions;
+        while(written < 40) {
+            while(queue.freeBuffers() > 0 && written + static_cast<int>(queue.inFlight()) < 40) {
+                ByteArray buffer = queue.takeBuffer();
+                const ByteArray data = block(static_cast<int>(offset / 4096), 4096);
+                buffer.append(data);
+                CPPUNIT_ASSERT(queue.queueWrite(file.fd(), offset, std::move(buffer)));
+                offset += 4096;
+            }
+            queue.submit();
+            completions.clear();
+            written += static_cast<int>(queue.wait(completions));
+            for(IOQueue::Completion& completion : completions) {
+                CPPUNIT_ASSERT(completion.result == 4096);
+                queue.returnBuffer(std::move(completion.buffer));
+            }
+        }
+        CPPUNIT_ASSERT(queue.freeBuffers() == 4);
+
+        FileDevice input(TestFile, FileDevice::Mode::ReadOnly);
+        const char* storage = nullptr;
+        for(int i = 0; i < 40; i += 7) {
+            ByteArray buffer = queue.takeBuffer();
+            storage = buffer.begin();
+            CPPUNIT_ASSERT(queue.queueRead(input.fd(), static_cast<uint64_t>(i) * 4096,
+                                           std::move(buffer), 4096));
+            queue.submit();
+            completions = drain(queue);
+            CPPUNIT_ASSERT(completions[0].buffer.begin() == storage);
+            const ByteArray expected = block(i, 4096);
+            CPPUNIT_ASSERT(ByteView(completions[0].buffer) == ByteView(expected));
+            queue.returnBuffer(std::move(completions[0].buffer));
+        }
+
+        // Buffers from elsewhere are dropped, and a buffer which grows gives
+        // its registered storage back
+        queue.returnBuffer(ByteArray("small"));
+        CPPUNIT_ASSERT(queue.freeBuffers() == 4);
+        ByteArray grown = queue.takeBuffer();
+        CPPUNIT_ASSERT(queue.freeBuffers() == 3);
+        grown.extend(8192);
+        CPPUNIT_ASSERT(queue.freeBuffers() == 4);
+        queue.returnBuffer(std::move(grown));
+        CPPUNIT_ASSERT(grown.empty() && queue.freeBuffers() == 4);
+
+        // The storage of a dropped buffer goes back to the queue, so no other
+        // array can be allocated at its address
+        ByteArray dropped = queue.takeBuffer();
+        storage = dropped.begin();
+        dropped = ByteArray();
+        CPPUNIT_ASSERT(queue.freeBuffers() == 4);
+        ByteArray other;
+        other.reserve(4096);
+        CPPUNIT_ASSERT(other.begin() != storage);
+        std::remove(TestFile);
+    }
+
+    // Buffers stay valid after the queue is destroyed
+    for(IOQueue::Backend backend : backends()) {
+        ByteArray kept;
+        {
+            IOQueue queue(2, backend);
+            queue.registerBuffers(1, 4096);
+            kept = queue.takeBuffer();
+        }
+        const ByteArray data = block(3, 4096);
+        kept.append(data);
+        CPPUNIT_ASSERT(ByteView(kept) == ByteView(data));
+    }
+}
+
+/*!
+    \brief Tests the depth limit and failed requests
+*/
+void IOQueueTestSuite::test_limits() {
+    for(IOQueue::Backend backend : backends()) {
+        IOQueue queue(2, backend);
+        CPPUNIT_ASSERT(queue.queueWrite(-1, 0, ByteArray("one")));
+        CPPUNIT_ASSERT(queue.queueWrite(-1, 0, ByteArray("two")));
+        ByteArray third("three");
+        CPPUNIT_ASSERT(!queue.queueWrite(-1, 0, std::move(third)));
+        CPPUNIT_ASSERT(third.size() == 5);
+        ByteArray fourth("four");
+        CPPUNIT_ASSERT(!queue.queueRead(-1, 0, std::move(fourth), 100));
+        CPPUNIT_ASSERT(ByteView(fourth) == ByteView("four", 4));
+        CPPUNIT_ASSERT(queue.inFlight() == 2);
+
+        queue.submit();
+        std::vector<IOQueue::Completion> completions = drain(queue);
+        CPPUNIT_ASSERT(completions.size() == 2);
+        CPPUNIT_ASSERT(completions[0].result == -EBADF && completions[1].result == -EBADF);
+
+        std::vector<IOQueue::Completion> none;
+        CPPUNIT_ASSERT(queue.poll(none) == 0 && queue.wait(none) == 0);
+    }
+}
+
+MAINLESS_TEST(IOQueueTestSuite)
@@ -0,0 +1,38 @@
+/*!
+    \file io_queue_test_suite.hpp
+    \brief File to define the IOQueueTestSuite class
+*/
+
+#ifndef IO_QUEUE_TEST_SUITE_HPP
+#define IO_QUEUE_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "io_queue.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the IOQueue class, on
+    io_uring where the system has it and always on the thread pool
+*/
+class IOQueueTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(IOQueueTestSuite);
+
+    CPPUNIT_TEST(test_writeRead);
+    CPPUNIT_TEST(test_registeredBuffers);
+    CPPUNIT_TEST(test_limits);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    IOQueueTestSuite();
+    ~IOQueueTestSuite() = default;
+
+private:
+    void test_writeRead();
+    void test_registeredBuffers();
+    void test_limits();
+};
+
+#endif
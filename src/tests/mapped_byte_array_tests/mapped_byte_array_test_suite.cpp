@@ -0,0 +1,99 @@
+/*!
+    \file mapped_byte_array_test_suite.cpp
+    \brief File to define the implementation of the MappedByteArrayTestSuite
+*/
+
+#include "mapped_byte_array_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+namespace {
+const char* TestFile = "mapped_byte_array_test.bin";
+}
+
+/*!
+    \brief Default constructor for the Mapped Byte Array unit test class
+*/
+MappedByteArrayTestSuite::MappedByteArrayTestSuite() = default;
+
+/*!
+    \brief Tests that a default constructed mapping is closed and empty
+*/
+void MappedByteArrayTestSuite::test_defaultConstructor() {
+    MappedByteArray array;
+
+    CPPUNIT_ASSERT(!array.isOpen());
+    CPPUNIT_ASSERT(array.empty());
+    CPPUNIT_ASSERT(array.constData() == nullptr);
+}
+
+/*!
+    \brief Tests decoding a file written by a ByteStream through a read only map
+*/
+void MappedByteArrayTestSuite::test_readOnly() {
+    ByteArray encoded;
+    ByteStream writer(&encoded, ByteStream::OpenMode::Append);
+    for(uint32_t i = 0; i < 4096; i++) {
+        writer << i;
+    }
+    std::ofstream(TestFile, std::ios::binary).write(encoded.constData(), encoded.size());
+
+    MappedByteArray array(TestFile);
+    CPPUNIT_ASSERT(array.isOpen());
+    CPPUNIT_ASSERT(array.size() == static_cast<uint64_t>(encoded.size()));
+    CPPUNIT_ASSERT(array.advise(MappedByteArray::Advice::Sequential));
+    CPPUNIT_ASSERT(array.view() == ByteView(encoded));
+
+    ByteStream reader(&array, ByteStream::OpenMode::ReadWrite);
+    CPPUNIT_ASSERT(reader.mode() == ByteStream::OpenMode::ReadOnly);
+    for(uint32_t i = 0; i < 4096; i++) {
+        uint32_t value = 0;
+        reader >> value;
+        CPPUNIT_ASSERT(value == i);
+    }
+    CPPUNIT_ASSERT(reader.atEnd());
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+
+    MappedByteArray moved(std::move(array));
+    CPPUNIT_ASSERT(moved.isOpen() && !array.isOpen());
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests writing into a file through a read write map
+*/
+void MappedByteArrayTestSuite::test_readWrite() {
+    MappedByteArray array;
+    CPPUNIT_ASSERT(array.create(TestFile, 8));
+    CPPUNIT_ASSERT(array.mode() == MappedByteArray::Mode::ReadWrite);
+
+    ByteStream writer(&array, ByteStream::OpenMode::WriteOnly);
+    writer << static_cast<uint64_t>(0x0102030405060708);
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::Ok);
+    writer << static_cast<uint8_t>(1);
+    CPPUNIT_ASSERT(writer.status() == ByteStream::Status::ReadWritePastEnd);
+    CPPUNIT_ASSERT(array.sync());
+    array.close();
+
+    char contents[8] = {0};
+    std::ifstream(TestFile, std::ios::binary).read(contents, 8);
+    CPPUNIT_ASSERT(ByteView(contents, 8) == ByteView("\x01\x02\x03\x04\x05\x06\x07\x08", 8));
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests that mapping a missing file fails
+*/
+void MappedByteArrayTestSuite::test_missingFile() {
+    MappedByteArray array;
+
+    CPPUNIT_ASSERT(!array.open("this_file_does_not_exist.bin"));
+    CPPUNIT_ASSERT(!array.isOpen());
+}
+
+MAINLESS_TEST(MappedByteArrayTestSuite)
@@ -0,0 +1,39 @@
+/*!
+    \file mapped_byte_array_test_suite.hpp
+    \brief File to define the MappedByteArrayTestSuite class
+*/
+
+#ifndef MAPPED_BYTE_ARRAY_TEST_SUITE_HPP
+#define MAPPED_BYTE_ARRAY_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "mapped_byte_array.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the MappedByteArray class
+*/
+class MappedByteArrayTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(MappedByteArrayTestSuite);
+
+    CPPUNIT_TEST(test_defaultConstructor);
+    CPPUNIT_TEST(test_readOnly);
+    CPPUNIT_TEST(test_readWrite);
+    CPPUNIT_TEST(test_missingFile);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    MappedByteArrayTestSuite();
+    ~MappedByteArrayTestSuite() = default;
+
+private:
+    void test_defaultConstructor();
+    void test_readOnly();
+    void test_readWrite();
+    void test_missingFile();
+};
+
+#endif
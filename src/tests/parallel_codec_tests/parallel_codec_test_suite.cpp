@@ -0,0 +1,184 @@
+/*!
+    \file parallel_codec_test_suite.cpp
+    \brief File to define the implementation of the ParallelCodecTestSuite
+*/
+
+#include "parallel_codec_test_suite.hpp"
+#include "serializable.hpp"
+#include "common.hpp"
+
+#include <atomic>
+#include <string>
+
+namespace {
+struct Point {
+    int32_t x;
+    int32_t y;
+    std::string label;
+
+    SERIAL_FIELDS(x, y, label)
+};
+
+std::vector<Point> points(std::size_t count) {
+    std::vector<Point> result(count);
+    for(std::size_t i = 0; i < count; i++) {
+        result[i].x = static_cast<int32_t>(i);
+        result[i].y = -static_cast<int32_t>(i * 3);
+        result[i].label = std::string(i % 13, 'p');
+    }
+    return result;
+}
+}
+
+/*!
+    \brief Default constructor for the ParallelCodec unit test class
+*/
+ParallelCodecTestSuite::ParallelCodecTestSuite() = default;
+
+/*!
+    \brief Tests that every index runs once, also from nested loops
+*/
+void ParallelCodecTestSuite::test_threadPool() {
+    ThreadPool pool(4);
+    CPPUNIT_ASSERT(pool.threadCount() == 4);
+
+    std::vector<std::atomic<int>> runs(1000);
+    pool.parallelFor(runs.size(), [&runs](std::size_t i) { runs[i]++; });
+    for(std::atomic<int>& run : runs) {
+        CPPUNIT_ASSERT(run.load() == 1);
+    }
+
+    // Every worker blocks in an inner loop, which must still finish
+    std::atomic<int> inner(0);
+    pool.parallelFor(8, [&pool, &inner](std::size_t) {
+        pool.parallelFor(100, [&inner](std::size_t) { inner++; });
+    });
+    CPPUNIT_ASSERT(inner.load() == 800);
+
+    std::atomic<int> submitted(0);
+    {
+        ThreadPool local(2);
+        for(int i = 0; i < 50; i++) {
+            local.submit([&submitted]() { submitted++; });
+        }
+    }
+    CPPUNIT_ASSERT(submitted.load() == 50);
+}
+
+/*!
+    \brief Tests arithmetic collections in both integer encodings
+*/
+void ParallelCodecTestSuite::test_arithmetic() {
+    ThreadPool pool(4);
+    std::vector<int64_t> values(100000);
+    for(std::size_t i = 0; i < values.size(); i++) {
+        values[i] = static_cast<int64_t>(i * i) - 5000;
+    }
+
+    ParallelOptions options;
+    options.pool = &pool;
+    const ByteArray fixed = encodeParallel(values, options);
+    std::vector<ChunkInfo> index;
+    CPPUNIT_ASSERT(readChunkIndex(ByteView(fixed), index));
+    CPPUNIT_ASSERT(index.size() == 16);
+    CPPUNIT_ASSERT(fixed.size() == static_cast<int>(ChunkHeaderSize + 16 * ChunkEntrySize + values.size() * 8));
+
+    std::vector<int64_t> decoded;
+    CPPUNIT_ASSERT(decodeParallel(ByteView(fixed), decoded, options));
+    CPPUNIT_ASSERT(decoded == values);
+
+    options.encoding = ByteStream::IntegerEncoding::Varint;
+    options.chunkSize = 999;
+    const ByteArray varint = encodeParallel(values, options);
+    CPPUNIT_ASSERT(varint.size() < fixed.size());
+    CPPUNIT_ASSERT(decodeParallel(ByteView(varint), decoded, options));
+    CPPUNIT_ASSERT(decoded == values);
+
+    // Decoding with the wrong encoding is caught by the chunk sizes
+    options.encoding = ByteStream::IntegerEncoding::Fixed;
+    CPPUNIT_ASSERT(!decodeParallel(ByteView(varint), decoded, options));
+
+    const ByteArray empty = encodeParallel(std::vector<double>(), options);
+    CPPUNIT_ASSERT(empty.size() == static_cast<int>(ChunkHeaderSize));
+    std::vector<double> none(3);
+    CPPUNIT_ASSERT(decodeParallel(ByteView(empty), none, options) && none.empty());
+}
+
+/*!
+    \brief Tests collections of structs and strings on the shared pool
+*/
+void ParallelCodecTestSuite::test_records() {
+    const std::vector<Point> values = points(20000);
+    ParallelOptions options;
+    options.chunkSize = 1500;
+    options.order = ByteStream::ByteOrder::LittleEndian;
+    const ByteArray encoded = encodeParallel(values, options);
+
+    std::vector<Point> decoded;
+    CPPUNIT_ASSERT(decodeParallel(ByteView(encoded), decoded, options));
+    CPPUNIT_ASSERT(decoded.size() == values.size());
+    for(std::size_t i = 0; i < values.size(); i++) {
+        CPPUNIT_ASSERT(decoded[i].x == values[i].x && decoded[i].y == values[i].y &&
+                       decoded[i].label == values[i].label);
+    }
+
+    std::vector<std::string> strings(5000, "text");
+    const ByteArray encodedStrings = encodeParallel(strings);
+    std::vector<std::string> decodedStrings;
+    CPPUNIT_ASSERT(decodeParallel(ByteView(encodedStrings), decodedStrings));
+    CPPUNIT_ASSERT(decodedStrings == strings);
+}
+
+/*!
+    \brief Tests decoding a chunk on its own from the index
+*/
+void ParallelCodecTestSuite::test_index() {
+    const std::vector<Point> values = points(10000);
+    ParallelOptions options;
+    options.chunkSize = 1000;
+    const ByteArray encoded = encodeParallel(values, options);
+
+    std::vector<ChunkInfo> index;
+    CPPUNIT_ASSERT(readChunkIndex(ByteView(encoded), index));
+    CPPUNIT_ASSERT(index.size() == 10);
+    CPPUNIT_ASSERT(index[7].count == 1000);
+
+    ByteStream stream(ByteView(encoded).slice(index[7].offset, index[7].size));
+    Point point;
+    stream >> point;
+    CPPUNIT_ASSERT(point.x == 7000 && point.label == values[7000].label);
+}
+
+/*!
+    \brief Tests that malformed indices are rejected
+*/
+void ParallelCodecTestSuite::test_corrupt() {
+    std::vector<uint32_t> values(5000, 9);
+    ParallelOptions options;
+    options.chunkSize = 1000;
+    const ByteArray encoded = encodeParallel(values, options);
+    std::vector<uint32_t> decoded;
+    std::vector<ChunkInfo> index;
+
+    CPPUNIT_ASSERT(!readChunkIndex(ByteView(encoded).slice(0, 4), index));
+    CPPUNIT_ASSERT(!readChunkIndex(ByteView(encoded).slice(0, ChunkHeaderSize + 10), index));
+
+    // A chunk running past the end
+    ByteArray pastEnd(encoded);
+    pastEnd[ChunkHeaderSize + 4 * ChunkEntrySize + 8 + 3] = 0x7F;
+    CPPUNIT_ASSERT(!readChunkIndex(ByteView(pastEnd), index));
+    CPPUNIT_ASSERT(!decodeParallel(ByteView(pastEnd), decoded));
+
+    // A count larger than the chunk could hold
+    ByteArray tooMany(encoded);
+    tooMany[ChunkHeaderSize + 16 + 5] = 0x7F;
+    CPPUNIT_ASSERT(readChunkIndex(ByteView(tooMany), index));
+    CPPUNIT_ASSERT(!decodeParallel(ByteView(tooMany), decoded));
+
+    // A count the chunk doesn't match
+    ByteArray wrongCount(encoded);
+    wrongCount[ChunkHeaderSize + 16] = static_cast<char>(wrongCount[ChunkHeaderSize + 16] - 1);
+    CPPUNIT_ASSERT(!decodeParallel(ByteView(wrongCount), decoded));
+}
+
+MAINLESS_TEST(ParallelCodecTestSuite)
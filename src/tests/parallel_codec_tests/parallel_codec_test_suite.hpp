@@ -0,0 +1,42 @@
+/*!
+    \file parallel_codec_test_suite.hpp
+    \brief File to define the ParallelCodecTestSuite class
+*/
+
+#ifndef PARALLEL_CODEC_TEST_SUITE_HPP
+#define PARALLEL_CODEC_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "parallel_codec.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the ThreadPool class and
+    the parallel chunked encoding
+*/
+class ParallelCodecTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(ParallelCodecTestSuite);
+
+    CPPUNIT_TEST(test_threadPool);
+    CPPUNIT_TEST(test_arithmetic);
+    CPPUNIT_TEST(test_records);
+    CPPUNIT_TEST(test_index);
+    CPPUNIT_TEST(test_corrupt);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    ParallelCodecTestSuite();
+    ~ParallelCodecTestSuite() = default;
+
+private:
+    void test_threadPool();
+    void test_arithmetic();
+    void test_records();
+    void test_index();
+    void test_corrupt();
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*!
+    \file segmented_byte_array_test_suite.cpp
+    \brief File to define the implementation of the SegmentedByteArrayTestSuite
+*/
+
+#include "segmented_byte_array_test_suite.hpp"
+#include "io_device.hpp"
+#include "common.hpp"
+
+#include <cstdio>
+
+namespace {
+const char* TestFile = "segmented_byte_array_test.bin";
+}
+
+/*!
+    \brief Default constructor for the Segmented Byte Array unit test class
+*/
+SegmentedByteArrayTestSuite::SegmentedByteArrayTestSuite() = default;
+
+/*!
+    \brief Tests that appends fill chunks and never move earlier bytes
+*/
+void SegmentedByteArrayTestSuite::test_append() {
+    SegmentedByteArray array(8);
+    CPPUNIT_ASSERT(array.empty());
+
+    array.append("abcdef", 6);
+    const char* first = array.segment(0).data();
+    CPPUNIT_ASSERT(array.segmentCount() == 1);
+
+    array.append(ByteView("ghijkl", 6));
+    CPPUNIT_ASSERT(array.segment(0).data() == first);
+    CPPUNIT_ASSERT(array.segmentCount() == 2);
+    CPPUNIT_ASSERT(array.segment(0) == ByteView("abcdefgh", 8));
+    CPPUNIT_ASSERT(array.segment(1) == ByteView("ijkl", 4));
+
+    ByteArray large(20, 'x');
+    array.append(large.constData(), large.size());
+    // The rest of the chunk is filled, then the remainder gets a chunk of its own
+    CPPUNIT_ASSERT(array.segmentCount() == 3);
+    CPPUNIT_ASSERT(array.segment(1).size() == 8);
+    CPPUNIT_ASSERT(array.segment(2).size() == 16);
+    CPPUNIT_ASSERT(array.size() == 32);
+
+    const ByteArray flat = array.toByteArray();
+    CPPUNIT_ASSERT(ByteView(flat).slice(0, 12) == ByteView("abcdefghijkl", 12));
+}
+
+/*!
+    \brief Tests that spliced data is referred to instead of copied
+*/
+void SegmentedByteArrayTestSuite::test_splice() {
+    SegmentedByteArray array;
+    array.append("head", 4);
+
+    ByteArray body(ByteArray::InlineCapacity * 2, 'b');
+    const char* bodyStorage = body.constData();
+    array.splice(std::move(body));
+    CPPUNIT_ASSERT(array.segment(1).data() == bodyStorage);
+
+    ByteArray small("small");
+    array.splice(std::move(small));
+    const char tail[] = "tail";
+    array.splice(ByteView(tail, 4));
+    CPPUNIT_ASSERT(array.segment(3).data() == tail);
+
+    // Appends after a splice start a new segment in the same chunk
+    array.append("!", 1);
+    CPPUNIT_ASSERT(array.segmentCount() == 5);
+    CPPUNIT_ASSERT(array.segment(4).data() == array.segment(0).end());
+
+    ByteArray flat = array.toByteArray();
+    CPPUNIT_ASSERT(flat.size() == 4 + ByteArray::InlineCapacity * 2 + 5 + 4 + 1);
+    ByteView view(flat);
+    CPPUNIT_ASSERT(view.startsWith(ByteView("headbb", 6)));
+    CPPUNIT_ASSERT(view.slice(view.size() - 10) == ByteView("smalltail!", 10));
+}
+
+/*!
+    \brief Tests writing all of the segments to a file in one go
+*/
+void SegmentedByteArrayTestSuite::test_writeTo() {
+    SegmentedByteArray array(16);
+    ByteArray expected;
+    // More segments than a single writev() call accepts
+    for(int i = 0; i < 3000; i++) {
+        const char value = static_cast<char>(i);
+        ByteArray part(1, value);
+        array.splice(std::move(part));
+        array.append(&value, 1);
+        expected.append(2, value);
+    }
+    CPPUNIT_ASSERT(array.segmentCount() == 6000);
+
+    {
+        FileDevice file(TestFile, FileDevice::Mode::WriteOnly);
+        CPPUNIT_ASSERT(array.writeTo(&file) == static_cast<int64_t>(array.size()));
+    }
+
+    FileDevice file(TestFile, FileDevice::Mode::ReadOnly);
+    ByteArray contents(expected.size() + 1, '\0');
+    CPPUNIT_ASSERT(file.read(contents.data(), contents.size()) == expected.size());
+    CPPUNIT_ASSERT(ByteView(contents).slice(0, expected.size()) == ByteView(expected));
+
+    std::remove(TestFile);
+}
+
+/*!
+    \brief Tests that clearing the array frees everything in it
+*/
+void SegmentedByteArrayTestSuite::test_clear() {
+    SegmentedByteArray array;
+    array.append("abc", 3);
+    array.splice(ByteArray("def"));
+
+    SegmentedByteArray moved(std::move(array));
+    CPPUNIT_ASSERT(moved.size() == 6);
+    CPPUNIT_ASSERT(moved.toByteArray().size() == 6);
+
+    moved.clear();
+    CPPUNIT_ASSERT(moved.empty());
+    CPPUNIT_ASSERT(moved.segmentCount() == 0);
+
+    moved.append("x", 1);
+    CPPUNIT_ASSERT(moved.segment(0) == ByteView("x", 1));
+}
+
+/*!
+    \brief Tests that both arrays of a move can be appended to afterwards
+*/
+void SegmentedByteArrayTestSuite::test_move() {
+    SegmentedByteArray array(16);
+    array.append("abc", 3);
+
+    SegmentedByteArray moved(std::move(array));
+    CPPUNIT_ASSERT(array.empty() && array.segmentCount() == 0);
+    array.append("xyz", 3);
+    moved.append("def", 3);
+    CPPUNIT_ASSERT(array.segmentCount() == 1 && array.segment(0) == ByteView("xyz", 3));
+    CPPUNIT_ASSERT(moved.segmentCount() == 1 && moved.segment(0) == ByteView("abcdef", 6));
+
+    SegmentedByteArray assigned;
+    assigned.append("old", 3);
+    assigned = std::move(moved);
+    CPPUNIT_ASSERT(moved.empty() && moved.segmentCount() == 0);
+    moved.append("ghi", 3);
+    assigned.append("jkl", 3);
+    CPPUNIT_ASSERT(moved.segment(0) == ByteView("ghi", 3));
+    CPPUNIT_ASSERT(assigned.size() == 9);
+    CPPUNIT_ASSERT(assigned.segment(0) == ByteView("abcdefjkl", 9));
+}
+
+MAINLESS_TEST(SegmentedByteArrayTestSuite)
@@ -0,0 +1,42 @@
+/*!
+    \file segmented_byte_array_test_suite.hpp
+    \brief File to define the SegmentedByteArrayTestSuite class
+*/
+
+#ifndef SEGMENTED_BYTE_ARRAY_TEST_SUITE_HPP
+#define SEGMENTED_BYTE_ARRAY_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "segmented_byte_array.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the SegmentedByteArray
+    class
+*/
+class SegmentedByteArrayTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(SegmentedByteArrayTestSuite);
+
+    CPPUNIT_TEST(test_append);
+    CPPUNIT_TEST(test_splice);
+    CPPUNIT_TEST(test_writeTo);
+    CPPUNIT_TEST(test_clear);
+    CPPUNIT_TEST(test_move);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    SegmentedByteArrayTestSuite();
+    ~SegmentedByteArrayTestSuite() = default;
+
+private:
+    void test_append();
+    void test_splice();
+    void test_writeTo();
+    void test_clear();
+    void test_move();
+};
+
+#endif
@@ -0,0 +1,266 @@
+/*!
+    \file serializable_test_suite.cpp
+    \brief File to define the implementation of the SerializableTestSuite
+*/
+
+#include "serializable_test_suite.hpp"
+#include "common.hpp"
+
+#include <cstring>
+
+namespace {
+enum class Kind : uint16_t {
+    Point = 1,
+    Line = 2
+};
+
+//! Packed, so it is copied as a whole in the host byte order
+struct Header {
+    uint32_t id;
+    Kind kind;
+    int16_t delta;
+
+    SERIAL_FIELDS(id, kind, delta)
+};
+
+//! Packed, and made of another packed struct
+struct Sample {
+    Header header;
+    double value;
+
+    SERIAL_FIELDS(header, value)
+};
+
+//! Fixed size but padded, so it is written field by field
+struct Padded {
+    uint8_t flag;
+    uint64_t count;
+
+    SERIAL_FIELDS(flag, count)
+};
+
+//! Packed but listed out of order
+struct Reordered {
+    uint32_t first;
+    uint32_t second;
+
+    SERIAL_FIELDS(second, first)
+};
+
+//! The size of its fields, but bools can't be copied as a whole
+struct Flags {
+    bool enabled;
+    bool visible;
+    uint16_t mask;
+
+    SERIAL_FIELDS(enabled, visible, mask)
+};
+
+//! Not of a fixed size
+struct Record {
+    std::string key;
+    Header header;
+    long long total;
+    std::string path;
+
+    SERIAL_FIELDS(key, header, total, path)
+};
+
+/*!
+    \brief Returns the byte a bool is stored as
+*/
+unsigned char boolByte(bool b) {
+    unsigned char byte;
+    std::memcpy(&byte, &b, sizeof(byte));
+    return byte;
+}
+
+/*!
+    \brief Returns the bytes written by each field operator on its own
+*/
+ByteArray encodeHeader(const Header& header, ByteStream::ByteOrder order) {
+    ByteArray array;
+    ByteStream stream(&array, ByteStream::OpenMode::Append);
+    stream.setByteOrder(order);
+    stream << header.id;
+    stream << static_cast<uint16_t>(header.kind);
+    stream << header.delta;
+    return array;
+}
+}
+
+/*!
+    \brief Default constructor for the Serializable unit test class
+*/
+SerializableTestSuite::SerializableTestSuite() = default;
+
+/*!
+    \brief Tests the layout computed for each kind of struct
+*/
+void SerializableTestSuite::test_layout() {
+    CPPUNIT_ASSERT(IsSerializable<Header>::value);
+    CPPUNIT_ASSERT(!IsSerializable<uint32_t>::value);
+
+    CPPUNIT_ASSERT(SerialLayout<Header>::packed && SerialLayout<Header>::size == 8);
+    CPPUNIT_ASSERT(SerialLayout<Sample>::packed && SerialLayout<Sample>::size == 16);
+    CPPUNIT_ASSERT(SerialLayout<Padded>::fixed && !SerialLayout<Padded>::packed);
+    CPPUNIT_ASSERT(SerialLayout<Padded>::size == 9);
+    CPPUNIT_ASSERT(SerialLayout<Reordered>::packed);
+    CPPUNIT_ASSERT(!SerialLayout<Record>::fixed);
+
+    CPPUNIT_ASSERT(serialCopyable(Header{1, Kind::Line, 2}));
+    CPPUNIT_ASSERT(!serialCopyable(Reordered{1, 2}));
+}
+
+/*!
+    \brief Tests that packed structs encode the same in every byte order
+*/
+void SerializableTestSuite::test_packed() {
+    const Sample sample{{7, Kind::Line, -3}, 2.5};
+
+    for(auto order : {ByteStream::ByteOrder::BigEndian, ByteStream::ByteOrder::LittleEndian}) {
+        ByteArray array;
+        ByteStream writer(&array, ByteStream::OpenMode::Append);
+        writer.setByteOrder(order);
+        writer << sample;
+
+        ByteArray expected = encodeHeader(sample.header, order);
+        ByteStream expectedWriter(&expected, ByteStream::OpenMode::Append);
+        expectedWriter.setByteOrder(order);
+        expectedWriter << sample.value;
+        CPPUNIT_ASSERT(ByteView(array) == ByteView(expected));
+
+        Sample read{};
+        ByteStream reader{ByteView(array)};
+        reader.setByteOrder(order);
+        reader >> read;
+        CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok && reader.atEnd());
+        CPPUNIT_ASSERT(read.header.id == 7 && read.header.kind == Kind::Line);
+        CPPUNIT_ASSERT(read.header.delta == -3 && read.value == 2.5);
+    }
+}
+
+/*!
+    \brief Tests padded and reordered structs, and varint integers
+*/
+void SerializableTestSuite::test_fieldwise() {
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer.setByteOrder(ByteStream::hostByteOrder());
+    writer << Padded{1, 0x0102030405060708};
+    writer << Reordered{1, 2};
+    CPPUNIT_ASSERT(array.size() == 17);
+    // second is written first
+    CPPUNIT_ASSERT(array.at(9) == 2 || array.at(12) == 2);
+
+    writer.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    writer << Header{300, Kind::Point, -1};
+    CPPUNIT_ASSERT(array.size() == 17 + 2 + 1 + 1);
+
+    ByteStream reader{ByteView(array)};
+    reader.setByteOrder(ByteStream::hostByteOrder());
+    Padded padded{};
+    Reordered reordered{};
+    Header header{};
+    reader >> padded;
+    reader >> reordered;
+    reader.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    reader >> header;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok && reader.atEnd());
+    CPPUNIT_ASSERT(padded.flag == 1 && padded.count == 0x0102030405060708);
+    CPPUNIT_ASSERT(reordered.first == 1 && reordered.second == 2);
+    CPPUNIT_ASSERT(header.id == 300 && header.kind == Kind::Point && header.delta == -1);
+}
+
+/*!
+    \brief Tests structs with strings and nested structs
+*/
+void SerializableTestSuite::test_strings() {
+    const Record record{"key", {9, Kind::Point, 4}, -5, "a/b/c"};
+
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer << record;
+    CPPUNIT_ASSERT(array.size() == 4 + 8 + 8 + 6);
+
+    Record read;
+    ByteStream reader{ByteView(array)};
+    reader >> read;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok && reader.atEnd());
+    CPPUNIT_ASSERT(read.key == "key" && read.path == "a/b/c" && read.total == -5);
+    CPPUNIT_ASSERT(read.header.id == 9 && read.header.delta == 4);
+}
+
+/*!
+    \brief Tests that fixed size structs fail as a whole on truncated data
+*/
+void SerializableTestSuite::test_truncated() {
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer << Padded{1, 2};
+
+    for(auto order : {ByteStream::ByteOrder::BigEndian, ByteStream::ByteOrder::LittleEndian}) {
+        Padded padded{5, 6};
+        ByteStream reader{ByteView(array).slice(0, 8)};
+        reader.setByteOrder(order);
+        reader >> padded;
+        CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadWritePastEnd);
+        CPPUNIT_ASSERT(padded.flag == 5 && padded.count == 6);
+    }
+}
+
+/*!
+    \brief Tests measuring encodings, at compile time where possible
+*/
+void SerializableTestSuite::test_serializedSize() {
+    static_assert(serializedSize<Header>() == 8, "Header is 8 bytes");
+    static_assert(serializedSize<Sample>() == 16, "Sample is 16 bytes");
+    static_assert(serializedSize<Padded>() == 9, "Padded is 9 bytes");
+    static_assert(serializedSize<double>() == 8, "double is 8 bytes");
+
+    const Header header{300, Kind::Point, -1};
+    CPPUNIT_ASSERT(serializedSize(header) == 8);
+    CPPUNIT_ASSERT(serializedSize(header, ByteStream::IntegerEncoding::Varint) == 4);
+
+    const Record record{"key", header, -5, std::string(1000, 'p')};
+    const uint64_t size = serializedSize(record);
+    CPPUNIT_ASSERT(size == 4 + 8 + 8 + 2 + 1000);
+
+    ByteArray array;
+    array.reserve(static_cast<int>(size));
+    const char* storage = array.begin();
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer << record;
+    CPPUNIT_ASSERT(array.size() == static_cast<int>(size));
+    CPPUNIT_ASSERT(array.capacity() == static_cast<int>(size));
+    CPPUNIT_ASSERT(array.constData() == storage);
+
+    NullDevice device;
+    ByteStream counter(&device, ByteStream::OpenMode::WriteOnly);
+    counter << std::string("abc");
+    counter.flush();
+    CPPUNIT_ASSERT(device.size() == 4);
+    device.reset();
+    CPPUNIT_ASSERT(device.size() == 0);
+}
+
+/*!
+    \brief Tests that bool fields read any byte other than 0 as true
+*/
+void SerializableTestSuite::test_bools() {
+    CPPUNIT_ASSERT(SerialLayout<Flags>::fixed && !SerialLayout<Flags>::packed);
+    CPPUNIT_ASSERT(SerialLayout<Flags>::size == sizeof(Flags));
+
+    const char bytes[] = {2, 0, 1, 0};
+    for(auto order : {ByteStream::ByteOrder::BigEndian, ByteStream::ByteOrder::LittleEndian}) {
+        ByteStream reader{ByteView(bytes, sizeof(bytes))};
+        reader.setByteOrder(order);
+        Flags flags{};
+        reader >> flags;
+        CPPUNIT_ASSERT(reader.status() == ByteStream::Status::Ok);
+        CPPUNIT_ASSERT(flags.enabled && boolByte(flags.enabled) == 1);
+        CPPUNIT_ASSERT(!flags.visible);
+    }
+}
+
+MAINLESS_TEST(SerializableTestSuite)
@@ -0,0 +1,46 @@
+/*!
+    \file serializable_test_suite.hpp
+    \brief File to define the SerializableTestSuite class
+*/
+
+#ifndef SERIALIZABLE_TEST_SUITE_HPP
+#define SERIALIZABLE_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "serializable.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for structs declaring
+    SERIAL_FIELDS
+*/
+class SerializableTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(SerializableTestSuite);
+
+    CPPUNIT_TEST(test_layout);
+    CPPUNIT_TEST(test_packed);
+    CPPUNIT_TEST(test_fieldwise);
+    CPPUNIT_TEST(test_strings);
+    CPPUNIT_TEST(test_truncated);
+    CPPUNIT_TEST(test_serializedSize);
+    CPPUNIT_TEST(test_bools);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    SerializableTestSuite();
+    ~SerializableTestSuite() = default;
+
+private:
+    void test_layout();
+    void test_packed();
+    void test_fieldwise();
+    void test_strings();
+    void test_truncated();
+    void test_serializedSize();
+    void test_bools();
+};
+
+#endif
@@ -0,0 +1,185 @@
+/*!
+    \file table_test_suite.cpp
+    \brief File to define the implementation of the TableTestSuite
+*/
+
+#include "table_test_suite.hpp"
+#include "common.hpp"
+
+#include <cstring>
+
+namespace {
+enum class Color : uint8_t {
+    Red,
+    Green
+};
+}
+
+/*!
+    \brief Default constructor for the Table unit test class
+*/
+TableTestSuite::TableTestSuite() = default;
+
+/*!
+    \brief Tests reading any field of a table directly
+*/
+void TableTestSuite::test_fields() {
+    ByteArray array;
+    TableBuilder builder(&array);
+    for(uint16_t id = 0; id < 40; id++) {
+        builder.add(id, static_cast<uint32_t>(id * 1000));
+    }
+    builder.add(40, -2.5);
+    builder.add(41, Color::Green);
+    builder.addString(42, "a/path");
+    builder.add(43, true);
+    const ByteView built = builder.finish();
+    CPPUNIT_ASSERT(built.size() == static_cast<std::size_t>(array.size()));
+
+    TableView table{ByteView(array)};
+    CPPUNIT_ASSERT(table.isValid());
+    CPPUNIT_ASSERT(table.size() == static_cast<uint32_t>(array.size()));
+    CPPUNIT_ASSERT(table.fieldCount() == 44);
+    CPPUNIT_ASSERT(table.get<uint32_t>(37) == 37000);
+    CPPUNIT_ASSERT(table.get<uint32_t>(3) == 3000);
+    CPPUNIT_ASSERT(table.get<double>(40) == -2.5);
+    CPPUNIT_ASSERT(table.get<Color>(41) == Color::Green);
+    CPPUNIT_ASSERT(table.getBytes(42) == ByteView("a/path", 6));
+    CPPUNIT_ASSERT(table.getString(42) == "a/path");
+    CPPUNIT_ASSERT(table.get<bool>(43));
+
+    // Little endian whatever the host
+    CPPUNIT_ASSERT(array.at(TableView::HeaderSize + 4) == static_cast<char>(1000 & 0xFF));
+}
+
+/*!
+    \brief Tests missing, unknown and new fields, and the range of ids
+*/
+void TableTestSuite::test_schemaEvolution() {
+    ByteArray array;
+    TableBuilder builder(&array);
+    builder.add(5, static_cast<uint16_t>(7));
+    builder.add(1, static_cast<int64_t>(-1));
+    builder.finish();
+
+    TableView table{ByteView(array)};
+    CPPUNIT_ASSERT(table.fieldCount() == 6);
+    CPPUNIT_ASSERT(table.has(1) && table.has(5));
+    CPPUNIT_ASSERT(!table.has(0) && !table.has(3));
+    CPPUNIT_ASSERT(table.get<int64_t>(1) == -1);
+    CPPUNIT_ASSERT(table.get<uint16_t>(5) == 7);
+
+    // Fields which were never written, or added to the schema since
+    CPPUNIT_ASSERT(table.get<uint32_t>(2, 99) == 99);
+    CPPUNIT_ASSERT(table.get<uint32_t>(100, 42) == 42);
+    CPPUNIT_ASSERT(table.getBytes(100).empty());
+    CPPUNIT_ASSERT(!table.getTable(100).isValid());
+
+    // The largest id fills the field count, one more can't be stored
+    ByteArray largest;
+    TableBuilder largestBuilder(&largest);
+    largestBuilder.add(TableBuilder::MaxFieldId, static_cast<uint8_t>(3));
+    CPPUNIT_ASSERT(!largestBuilder.finish().empty());
+    TableView wide{ByteView(largest)};
+    CPPUNIT_ASSERT(wide.fieldCount() == 65535);
+    CPPUNIT_ASSERT(wide.get<uint8_t>(TableBuilder::MaxFieldId) == 3);
+
+    ByteArray tooLarge("kept");
+    TableBuilder tooLargeBuilder(&tooLarge);
+    tooLargeBuilder.add(1, static_cast<uint8_t>(1));
+    tooLargeBuilder.add(65535, static_cast<uint8_t>(2));
+    CPPUNIT_ASSERT(tooLargeBuilder.finish().empty());
+    CPPUNIT_ASSERT(ByteView(tooLarge) == ByteView("kept", 4));
+}
+
+/*!
+    \brief Tests tables inside tables, and tables one after the other
+*/
+void TableTestSuite::test_nested() {
+    ByteArray inner;
+    TableBuilder innerBuilder(&inner);
+    innerBuilder.addString(0, "inner");
+    innerBuilder.finish();
+
+    ByteArray array;
+    for(uint32_t record = 0; record < 3; record++) {
+        TableBuilder builder(&array);
+        builder.add(0, record);
+        builder.addTable(1, ByteView(inner));
+        builder.finish();
+    }
+
+    ByteView remaining(array);
+    for(uint32_t record = 0; record < 3; record++) {
+        TableView table(remaining);
+        CPPUNIT_ASSERT(table.isValid());
+        CPPUNIT_ASSERT(table.get<uint32_t>(0) == record);
+        CPPUNIT_ASSERT(table.getTable(1).getString(0) == "inner");
+        remaining = remaining.slice(table.size());
+    }
+    CPPUNIT_ASSERT(remaining.empty());
+
+    // A table earlier in the same array can be nested while the array grows
+    ByteArray shared;
+    TableBuilder firstBuilder(&shared);
+    firstBuilder.addString(0, std::string(200, 'n'));
+    const std::size_t firstSize = firstBuilder.finish().size();
+    for(int copy = 0; copy < 6; copy++) {
+        TableBuilder builder(&shared);
+        builder.addTable(0, ByteView(shared).slice(0, firstSize));
+        builder.addBytes(1, ByteView(shared).slice(0, firstSize));
+        CPPUNIT_ASSERT(!builder.finish().empty());
+    }
+
+    remaining = ByteView(shared);
+    const ByteView first = remaining.slice(0, firstSize);
+    remaining = remaining.slice(firstSize);
+    while(!remaining.empty()) {
+        TableView table(remaining);
+        CPPUNIT_ASSERT(table.getTable(0).getString(0) == std::string(200, 'n'));
+        CPPUNIT_ASSERT(table.getBytes(1) == first);
+        remaining = remaining.slice(table.size());
+    }
+}
+
+/*!
+    \brief Tests that corrupt tables read as missing fields, and corrupt bools
+    as true
+*/
+void TableTestSuite::test_corrupt() {
+    CPPUNIT_ASSERT(!TableView(ByteView("abc", 3)).isValid());
+
+    ByteArray array;
+    TableBuilder builder(&array);
+    builder.add(0, static_cast<uint32_t>(1));
+    builder.addString(1, "text");
+    builder.finish();
+
+    // Truncated
+    CPPUNIT_ASSERT(!TableView(ByteView(array).slice(0, array.size() - 1)).isValid());
+
+    // An offset pointing past the end
+    ByteArray badOffset(array);
+    badOffset[badOffset.size() - 8] = static_cast<char>(0xFF);
+    TableView table{ByteView(badOffset)};
+    CPPUNIT_ASSERT(table.isValid());
+    CPPUNIT_ASSERT(table.get<uint32_t>(0, 5) == 5);
+    CPPUNIT_ASSERT(table.getString(1) == "text");
+
+    // A length running past the end
+    ByteArray badLength(array);
+    badLength[TableView::HeaderSize + 4 + 3] = 0x7F;
+    CPPUNIT_ASSERT(TableView(ByteView(badLength)).getBytes(1).empty());
+
+    // A bool stored as a byte other than 0 or 1 reads as true
+    ByteArray bools;
+    TableBuilder boolBuilder(&bools);
+    boolBuilder.add(0, static_cast<uint8_t>(2));
+    boolBuilder.finish();
+    const bool flag = TableView(ByteView(bools)).get<bool>(0);
+    unsigned char flagByte;
+    std::memcpy(&flagByte, &flag, sizeof(flagByte));
+    CPPUNIT_ASSERT(flag && flagByte == 1);
+}
+
+MAINLESS_TEST(TableTestSuite)
@@ -0,0 +1,40 @@
+/*!
+    \file table_test_suite.hpp
+    \brief File to define the TableTestSuite class
+*/
+
+#ifndef TABLE_TEST_SUITE_HPP
+#define TABLE_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "table.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the TableBuilder and
+    TableView classes
+*/
+class TableTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(TableTestSuite);
+
+    CPPUNIT_TEST(test_fields);
+    CPPUNIT_TEST(test_schemaEvolution);
+    CPPUNIT_TEST(test_nested);
+    CPPUNIT_TEST(test_corrupt);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    TableTestSuite();
+    ~TableTestSuite() = default;
+
+private:
+    void test_fields();
+    void test_schemaEvolution();
+    void test_nested();
+    void test_corrupt();
+};
+
+#endif
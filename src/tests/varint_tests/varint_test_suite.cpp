@@ -0,0 +1,151 @@
+/*!
+    \file varint_test_suite.cpp
+    \brief File to define the implementation of the VarintTestSuite
+*/
+
+#include "varint_test_suite.hpp"
+#include "byte_stream.hpp"
+#include "common.hpp"
+
+#include <limits>
+#include <vector>
+
+/*!
+    \brief Default constructor for the Varint unit test class
+*/
+VarintTestSuite::VarintTestSuite() = default;
+
+/*!
+    \brief Tests the encoded bytes and lengths of varints
+*/
+void VarintTestSuite::test_encode() {
+    char buffer[MaxVarintLength];
+
+    CPPUNIT_ASSERT(encodeVarint(0, buffer) == 1 && buffer[0] == 0);
+    CPPUNIT_ASSERT(encodeVarint(127, buffer) == 1 && buffer[0] == 127);
+    CPPUNIT_ASSERT(encodeVarint(300, buffer) == 2);
+    CPPUNIT_ASSERT(static_cast<uint8_t>(buffer[0]) == 0xAC && buffer[1] == 0x02);
+    CPPUNIT_ASSERT(encodeVarint(std::numeric_limits<uint64_t>::max(), buffer) == MaxVarintLength);
+
+    CPPUNIT_ASSERT(varintLength(0) == 1);
+    CPPUNIT_ASSERT(varintLength(128) == 2);
+    CPPUNIT_ASSERT(varintLength(std::numeric_limits<uint64_t>::max()) == MaxVarintLength);
+}
+
+/*!
+    \brief Tests decoding single varints, including truncated and malformed ones
+*/
+void VarintTestSuite::test_decode() {
+    char buffer[MaxVarintLength];
+    uint64_t value = 0;
+
+    const int length = encodeVarint(std::numeric_limits<uint64_t>::max(), buffer);
+    CPPUNIT_ASSERT(decodeVarint(buffer, buffer + length, value) == length);
+    CPPUNIT_ASSERT(value == std::numeric_limits<uint64_t>::max());
+
+    CPPUNIT_ASSERT(decodeVarint(buffer, buffer + length - 1, value) == 0);
+
+    const char tooLong[11] = {'\x80', '\x80', '\x80', '\x80', '\x80',
+                              '\x80', '\x80', '\x80', '\x80', '\x80', 0};
+    CPPUNIT_ASSERT(decodeVarint(tooLong, tooLong + 11, value) == -1);
+
+    const char overflow[10] = {'\xFF', '\xFF', '\xFF', '\xFF', '\xFF',
+                               '\xFF', '\xFF', '\xFF', '\xFF', 2};
+    CPPUNIT_ASSERT(decodeVarint(overflow, overflow + 10, value) == -1);
+}
+
+/*!
+    \brief Tests the ZigZag mapping of signed values
+*/
+void VarintTestSuite::test_zigZag() {
+    CPPUNIT_ASSERT(zigZagEncode(0) == 0);
+    CPPUNIT_ASSERT(zigZagEncode(-1) == 1);
+    CPPUNIT_ASSERT(zigZagEncode(1) == 2);
+    CPPUNIT_ASSERT(zigZagEncode(-2) == 3);
+
+    const int64_t extremes[] = {std::numeric_limits<int64_t>::min(),
+                                std::numeric_limits<int64_t>::max(), -12345, 12345};
+    for(auto value : extremes) {
+        CPPUNIT_ASSERT(zigZagDecode(zigZagEncode(value)) == value);
+    }
+}
+
+/*!
+    \brief Tests that the bulk decoder agrees with decoding one at a time
+*/
+void VarintTestSuite::test_bulkDecode() {
+    std::vector<uint64_t> values;
+    for(int i = 0; i < 40; i++) {
+        values.push_back(static_cast<uint64_t>(i));
+    }
+    for(int shift = 0; shift < 64; shift++) {
+        values.push_back(1ull << shift);
+        values.push_back((1ull << shift) - 1);
+        values.push_back(static_cast<uint64_t>(shift % 3));
+    }
+    values.push_back(std::numeric_limits<uint64_t>::max());
+
+    std::vector<char> encoded;
+    for(auto value : values) {
+        char buffer[MaxVarintLength];
+        encoded.insert(encoded.end(), buffer, buffer + encodeVarint(value, buffer));
+    }
+
+    std::vector<uint64_t> decoded(values.size());
+    const char* cursor = encoded.data();
+    const char* end = encoded.data() + encoded.size();
+    CPPUNIT_ASSERT(decodeVarints(cursor, end, decoded.data(), decoded.size()) == values.size());
+    CPPUNIT_ASSERT(cursor == end);
+    CPPUNIT_ASSERT(decoded == values);
+
+    cursor = encoded.data();
+    CPPUNIT_ASSERT(decodeVarints(cursor, end - 1, decoded.data(), decoded.size()) ==
+                   values.size() - 1);
+}
+
+/*!
+    \brief Tests the varint functions and the Varint encoding of ByteStream
+*/
+void VarintTestSuite::test_stream() {
+    ByteArray array;
+    ByteStream writer(&array, ByteStream::OpenMode::Append);
+    writer.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    writer << static_cast<uint64_t>(5);
+    writer << static_cast<int32_t>(-3);
+    writer << static_cast<uint16_t>(1000);
+    writer << static_cast<uint64_t>(70000);
+    CPPUNIT_ASSERT(array.size() == 1 + 1 + 2 + 3);
+
+    ByteStream reader{ByteView(array)};
+    reader.setIntegerEncoding(ByteStream::IntegerEncoding::Varint);
+    uint64_t u64 = 0;
+    int32_t i32 = 0;
+    uint16_t u16 = 0;
+    reader >> u64;
+    reader >> i32;
+    reader >> u16;
+    CPPUNIT_ASSERT(u64 == 5 && i32 == -3 && u16 == 1000);
+
+    reader >> u16;
+    CPPUNIT_ASSERT(reader.status() == ByteStream::Status::ReadCorruptData);
+
+    std::vector<uint64_t> ids;
+    for(uint64_t i = 0; i < 100; i++) {
+        ids.push_back(i * i * i);
+    }
+    ByteArray idArray;
+    ByteStream idWriter(&idArray, ByteStream::OpenMode::Append);
+    idWriter.writeVarints(ids.data(), ids.size());
+
+    std::vector<uint64_t> readIds(ids.size());
+    ByteStream idReader{ByteView(idArray)};
+    idReader.readVarints(readIds.data(), readIds.size());
+    CPPUNIT_ASSERT(idReader.status() == ByteStream::Status::Ok);
+    CPPUNIT_ASSERT(idReader.atEnd());
+    CPPUNIT_ASSERT(readIds == ids);
+
+    idReader.readVarints(readIds.data(), 1);
+    CPPUNIT_ASSERT(idReader.status() == ByteStream::Status::ReadWritePastEnd);
+}
+
+MAINLESS_TEST(VarintTestSuite)
@@ -0,0 +1,41 @@
+/*!
+    \file varint_test_suite.hpp
+    \brief File to define the VarintTestSuite class
+*/
+
+#ifndef VARINT_TEST_SUITE_HPP
+#define VARINT_TEST_SUITE_HPP
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "varint.hpp"
+
+/*!
+    \brief Class to describe the behavior and execution of Unit Tests
+
+    This class handles the execution of Unit Tests for the varint encoding
+*/
+class VarintTestSuite : public CppUnit::TestFixture {
+    CPPUNIT_TEST_SUITE(VarintTestSuite);
+
+    CPPUNIT_TEST(test_encode);
+    CPPUNIT_TEST(test_decode);
+    CPPUNIT_TEST(test_zigZag);
+    CPPUNIT_TEST(test_bulkDecode);
+    CPPUNIT_TEST(test_stream);
+
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+    VarintTestSuite();
+    ~VarintTestSuite() = default;
+
+private:
+    void test_encode();
+    void test_decode();
+    void test_zigZag();
+    void test_bulkDecode();
+    void test_stream();
+};
+
+#endif